@@ -83,6 +83,17 @@
             2013.06.03 real-valued support made possible (SUPP==double)
             2013.10.18 optional pattern spectrum collection added
             2013.11.12 item selection file changed to option -R#
+            2026.10.19 transaction tree size in bytes reported
+            2026.10.19 option -B added (binary output, see isrbin.h)
+            2026.10.19 library interface (in-memory transactions) added
+            2026.10.19 function apriorix() added (external trans. tree)
+            2026.10.19 option -L# added (transaction ids of item sets)
+            2026.10.19 option -N# added (report only the best item sets)
+            2026.10.19 pattern spectrum only mode in library interface
+            2026.10.19 rules reported with ist_rules() (node by node)
+            2026.10.19 candidates pruned with optimistic eval. bounds
+            2026.10.19 pattern spectrum of surrogate data (aprsurr())
+            2026.10.19 transactions filtered with tbg_ifilter()
 ------------------------------------------------------------------------
   Reference for the Apriori algorithm:
     R. Agrawal and R. Srikant.
@@ -100,8 +111,8 @@
 #include <math.h>
 #include <time.h>
 #include <assert.h>
-#ifndef ISR_PATSPEC
-#define ISR_PATSPEC
+#ifdef TA_THREADS
+#include <pthread.h>
 #endif
 #ifdef  APR_MAIN
 #ifndef PSP_REPORT
@@ -145,6 +156,7 @@
 #define E_AGGMODE   (-14)       /* invalid aggregation mode */
 #define E_STAT      (-16)       /* invalid test statistic */
 #define E_SIGLVL    (-17)       /* invalid significance level */
+#define E_SURR      (-18)       /* invalid surrogate method */
 /* error codes -15 to -25 defined in tract.h */
 
 #ifndef QUIET                   /* if not quiet version, */
@@ -157,6 +169,8 @@
 
 #define SEC_SINCE(t)  ((double)(clock()-(t)) /(double)CLOCKS_PER_SEC)
 
+#define BLKSIZE     1024        /* block size for enlarging arrays */
+
 /*----------------------------------------------------------------------
   Type Definitions
 ----------------------------------------------------------------------*/
@@ -165,8 +179,31 @@ typedef struct {                /* --- apriori execution data --- */
   TATREE *tatree;               /* transaction tree */
   ISTREE *istree;               /* item set tree (for counting) */
   ITEM   *map;                  /* identifier map for filtering */
+  int    xtree;                 /* whether trans. tree is external */
 } APRIORI;                      /* (apriori execution data) */
 
+typedef struct {                /* --- surrogate data mining --- */
+  TABAG    *tabag;              /* original transaction bag */
+  int      target;              /* target type (e.g. ISR_MAXIMAL) */
+  int      mode;                /* search mode (e.g. APR_TATREE) */
+  SUPP     supp, smax;          /* minimum and maximum support */
+  double   conf;                /* minimum confidence */
+  int      eval;                /* additional evaluation measure */
+  int      agg;                 /* aggregation mode of measure values */
+  double   thresh;              /* threshold for evaluation measure */
+  ITEM     prune;               /* min. size for evaluation filtering */
+  ITEM     min, max;            /* minimum and maximum item set size */
+  int      surr;                /* surrogate generation method */
+  unsigned long seed;           /* seed for random number generator */
+  long     cnt;                 /* number of surrogate data sets */
+  long     next;                /* index of next surrogate data set */
+  PATSPEC  *psp;                /* pattern spectrum (sum over all) */
+  int      err;                 /* error status */
+  #ifdef TA_THREADS             /* if to use multiple threads */
+  pthread_mutex_t lock;         /* lock for job counter and spectrum */
+  #endif
+} APRSURR;                      /* (surrogate data mining) */
+
 /*----------------------------------------------------------------------
   Constants
 ----------------------------------------------------------------------*/
@@ -191,7 +228,8 @@ static const char *errmsgs[] = {
   /* E_NOITEMS -15 */  "no (frequent) items found",
   /* E_STAT    -16 */  "invalid test statistic '%c'",
   /* E_SIGLVL  -17 */  "invalid significance level/p-value %g",
-  /*           -18 */  "unknown error"
+  /* E_SURR    -18 */  "invalid surrogate generation method '%c'",
+  /*           -19 */  "unknown error"
 };
 #endif
 
@@ -218,46 +256,61 @@ static int cleanup (APRIORI *data)
   if (!(data->mode & APR_NOCLEAN)) {
     if (data->map)    free(data->map);
     if (data->istree) ist_delete(data->istree);
-    if (data->tatree) tat_delete(data->tatree, 0);
+    if (data->tatree && !data->xtree) tat_delete(data->tatree, 0);
   }                             /* free all allocated memory */
   return -1;                    /* return an error indicator */
 }  /* cleanup() */
 
 /*--------------------------------------------------------------------*/
 
-int apriori (TABAG *tabag, int target, int mode, SUPP supp, SUPP smax,
-             double conf, int eval, int agg, double thresh,
-             double minimp, ITEM prune, double filter, int dir,
-             ISREPORT *report)
+int apriorix (TABAG *tabag, TATREE *tatree, int target, int mode,
+              SUPP supp, SUPP smax, double conf, int eval, int agg,
+              double thresh, double minimp, ITEM prune, double filter,
+              int dir, ISREPORT *report)
 {                               /* --- apriori algorithm */
   int     r = 0;                /* error status */
   ITEM    i, k, n;              /* loop variables, buffers */
   ITEM    size, max;            /* current/maximal item set size */
-  SUPP    frq, body, head;      /* frequency of an item set */
+  SUPP    frq;                  /* frequency of an item set */
   clock_t t, tt, tc, x;         /* timers for measurements */
-  APRIORI a = { 0, NULL, NULL, NULL };  /* apriori execution data */
+  #ifdef BENCH                  /* if benchmark version */
+  clock_t tb;                   /* total tree (re)build time */
+  #endif
+  APRIORI a = { 0, NULL, NULL, NULL, 0 };  /* execution data */
 
   assert(tabag && report);      /* check the function arguments */
   a.mode = mode;                /* note the processing mode */
 
   /* --- create transaction tree --- */
   tt = 0;                       /* init. the tree construction time */
-  if (mode & APR_TATREE) {      /* if to use a transaction tree */
+  if (tatree) {                 /* if a transaction tree is given, */
+    a.tatree = tatree;          /* use it (e.g. for repeated calls), */
+    a.xtree  = 1;               /* but do not delete or filter it */
+    filter   = 0; }
+  else if (mode & APR_TATREE) { /* if to use a transaction tree */
     t = clock();                /* start the timer for construction */
     XMSG(stderr, "building transaction tree ... ");
     a.tatree = tat_create(tabag);  /* create a transaction tree */
     if (!a.tatree) return cleanup(&a);
-    XMSG(stderr, "[%"SIZE_FMT" node(s)]", tat_size(a.tatree));
+    XMSG(stderr, "[%"SIZE_FMT" node(s), %"SIZE_FMT" byte(s)]",
+                 tat_size(a.tatree), tat_bytes(a.tatree));
     XMSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
     tt = clock() -t;            /* note the time for the construction */
   }                             /* of the transaction tree */
+  #ifdef BENCH                  /* if benchmark version, */
+  tb = tt;                      /* init. the total tree build time */
+  #endif
 
   /* --- create item set tree --- */
   if ((target & (ISR_CLOSED|ISR_MAXIMAL|ISR_RULE))
   ||  (((k = eval & ~IST_INVBXS) > RE_NONE) && (k < IST_LDRATIO))
   ||  dir)                      /* if individual counters needed, */
     mode &= ~IST_PERFECT;       /* remove perfect extension pruning */
-  t = clock(); tc = 0;          /* start the timer for the search */
+  if      (target & ISR_RULE)   /* prune with evaluation bounds */
+    mode |= IST_RULEBND;        /* (not for closed/maximal item sets */
+  else if (!(target & (ISR_CLOSED|ISR_MAXIMAL|ISR_GENERA)))
+    mode |= IST_SETBND;         /* and generators, because these need */
+  t = clock(); tc = 0;          /* all frequent item sets) */
   a.istree = ist_create(tbg_base(tabag), mode, supp, smax, conf);
   if (!a.istree) return cleanup(&a);
   max = isr_max(report);        /* create an apriori item set tree */
@@ -293,11 +346,12 @@ int apriori (TABAG *tabag, int target, int mode, SUPP supp, SUPP smax,
         if (tat_filter(a.tatree, size+1, (int*)a.map, 0) != 0)
           return cleanup(&a); } /* filter the transaction tree */
       else {                    /* if there is only a transaction bag */
-        tbg_filter(tabag, size+1, (int*)a.map, 0);
-        tbg_sort  (tabag, 0,0); /* remove unnecessary items and */
-        tbg_reduce(tabag, 0);   /* transactions and reduce */
-      }                         /* transactions to unique ones */
+        tbg_ifilter(tabag, size+1, (int*)a.map, 0, 0);
+      }                         /* remove unnecessary items and trans. */
       tt = clock() -x;          /* note the filter/rebuild time */
+      #ifdef BENCH              /* if benchmark version, */
+      if (a.tatree) tb += tt;   /* sum the tree rebuild times */
+      #endif
     }
     ++size;                     /* increment the item set size */
     XMSG(stderr, " %"ITEM_FMT, size);          /* and print it */
@@ -308,7 +362,13 @@ int apriori (TABAG *tabag, int target, int mode, SUPP supp, SUPP smax,
     tc = clock() -x;            /* compute the new counting time */
   }
   free(a.map); a.map = NULL;    /* delete filter map and trans. tree */
-  if (!(mode & APR_NOCLEAN) && a.tatree) {
+  #ifdef BENCH                  /* if benchmark version, */
+  if (a.tatree)                 /* show the transaction tree stats */
+    fprintf(stderr, "\ntransaction tree: %.2fs (build), "
+            "%"SIZE_FMT" bytes\n", (double)tb/CLOCKS_PER_SEC,
+            tat_bytes(a.tatree));
+  #endif
+  if (!(mode & APR_NOCLEAN) && a.tatree && !a.xtree) {
     tat_delete(a.tatree, 0); a.tatree = NULL; }
   XMSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
 
@@ -333,16 +393,9 @@ int apriori (TABAG *tabag, int target, int mode, SUPP supp, SUPP smax,
   t = clock();                  /* start the output timer */
   XMSG(stderr, "writing %s ... ", isr_name(report));
   ist_init(a.istree);           /* initialize the extraction */
-  if (target == ISR_RULE) {     /* if to find association rules */
-    a.map = (ITEM*)malloc((size_t)(size+1) *sizeof(ITEM));
-    if (!a.map) return cleanup(&a);  /* create an item set buffer */
-    while (1) {                 /* extract assoc. rules from tree */
-      k = ist_rule(a.istree, a.map, &frq, &body, &head, &thresh);
-      if (k < 0) break;         /* get the next association rule */
-      r = isr_rule(report, a.map, k, frq, body, head, thresh);
-      if (r < 0) break;         /* report the extracted ass. rule */
-    }
-    free(a.map); a.map = NULL;} /* delete the item set buffer */
+  if (target == ISR_RULE) {     /* if to find association rules, */
+    if (ist_rules(a.istree, report) < 0)  /* report the rules */
+      r = -1; }                 /* of all nodes of the tree */
   else if (dir) {               /* if to find frequent item sets */
     a.map = (ITEM*)malloc((size_t)(size+1) *sizeof(ITEM));
     if (!a.map) return cleanup(&a);   /* create an item set buffer */
@@ -361,6 +414,8 @@ int apriori (TABAG *tabag, int target, int mode, SUPP supp, SUPP smax,
       isr_seteval(report, ist_evalx, a.istree, re_dir(eval), thresh);
     if (ist_report(a.istree, report) < 0)
       r = -1;                   /* recursively report item sets */
+    else if (isr_topout(report) < 0)
+      r = -1;                   /* report the best item sets */
   }  /* if (target == ISR_RULE) .. else if (dir) .. else .. */
   XMSG(stderr, "[%"SIZE_FMT" %s(s)]", isr_repcnt(report),
                (target == ISR_RULE) ? "rule" : "set");
@@ -371,8 +426,356 @@ int apriori (TABAG *tabag, int target, int mode, SUPP supp, SUPP smax,
   if (!(mode & APR_NOCLEAN)) {  /* delete the apriori item set tree */
     ist_delete(a.istree); a.istree = NULL; }
   return r;                     /* return the error status */
+}  /* apriorix() */
+
+/*--------------------------------------------------------------------*/
+
+int apriori (TABAG *tabag, int target, int mode, SUPP supp, SUPP smax,
+             double conf, int eval, int agg, double thresh,
+             double minimp, ITEM prune, double filter, int dir,
+             ISREPORT *report)
+{                               /* --- apriori algorithm */
+  return apriorix(tabag, NULL, target, mode, supp, smax, conf, eval,
+                  agg, thresh, minimp, prune, filter, dir, report);
 }  /* apriori() */
 
+/*----------------------------------------------------------------------
+  Pattern Spectrum of Surrogate Data
+----------------------------------------------------------------------*/
+
+static int surrogate (APRSURR *sur, long index)
+{                               /* --- mine one surrogate data set */
+  int           r;              /* result of apriori() */
+  unsigned long seed;           /* seed for this surrogate */
+  TABAG         *bag;           /* surrogate data set */
+  ISREPORT      *rep;           /* item set reporter */
+  PATSPEC       *psp;           /* pattern spectrum of surrogate */
+
+  assert(sur && (index >= 0)); /* check the function arguments */
+  seed = sur->seed +(unsigned long)(index+1) *2654435761UL;
+  bag  = tbg_surr(sur->tabag, sur->surr, &seed);
+  if (!bag) return -1;          /* generate a surrogate data set */
+  tbg_itsort(bag, +1, 0);       /* sort items in transactions and */
+  tbg_sort  (bag, +1, 0);       /* sort the trans. lexicographically */
+  tbg_reduce(bag, 0);           /* reduce transactions to unique ones */
+  rep = isr_create(tbg_base(bag), 0, -1, NULL, NULL, NULL);
+  if (!rep) { tbg_delete(bag, 0); return -1; }
+  isr_setsize(rep, sur->min, sur->max);
+  isr_setsupp(rep, (RSUPP)sur->supp, (RSUPP)sur->smax);
+  r = ((isr_addpsp(rep, NULL) < 0)   /* only collect a pattern */
+    || (isr_open(rep, NULL, NULL) != 0)) ? -1   /* spectrum */
+    : apriori(bag, sur->target, sur->mode, sur->supp, sur->smax,
+              sur->conf, sur->eval, sur->agg, sur->thresh, -INFINITY,
+              sur->prune, 0, 0, rep);
+  psp = isr_rempsp(rep, 0);     /* mine the surrogate data set */
+  isr_delete(rep, 0);           /* and get its pattern spectrum */
+  tbg_delete(bag, 0);           /* delete reporter and surrogate */
+  if (!psp) return -1;          /* check for a pattern spectrum */
+  if ((r >= 0) && psp_error(psp)) r = -1;
+  #ifdef TA_THREADS             /* if to use multiple threads, */
+  pthread_mutex_lock(&sur->lock);    /* lock the total spectrum */
+  #endif
+  if (r >= 0) {                 /* if the surrogate was mined, */
+    if      (!sur->psp) { sur->psp = psp; psp = NULL; }
+    else if (psp_addpsp(sur->psp, psp) < 0) r = -1;
+  }                             /* add the spectrum to the total */
+  #ifdef TA_THREADS             /* if to use multiple threads, */
+  pthread_mutex_unlock(&sur->lock);  /* unlock the total spectrum */
+  #endif
+  if (psp) psp_delete(psp);     /* delete the surrogate spectrum */
+  return r;                     /* return the error status */
+}  /* surrogate() */
+
+/*--------------------------------------------------------------------*/
+#ifdef TA_THREADS
+
+static void* surrogates (void *data)
+{                               /* --- mine surrogates (thread) */
+  APRSURR *sur = (APRSURR*)data;/* surrogate data mining data */
+  long    i;                    /* index of the surrogate */
+
+  while (1) {                   /* while there are surrogates left */
+    pthread_mutex_lock(&sur->lock);
+    i = (!sur->err && (sur->next < sur->cnt)) ? sur->next++ : -1;
+    pthread_mutex_unlock(&sur->lock);
+    if (i < 0) return NULL;     /* get the next surrogate (if any) */
+    if (surrogate(sur, i) < 0){ /* mine the surrogate data set */
+      pthread_mutex_lock(&sur->lock);
+      sur->err = -1;            /* on failure set the error flag */
+      pthread_mutex_unlock(&sur->lock);
+    }                           /* (aborts the other threads) */
+  }
+}  /* surrogates() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+PATSPEC* aprsurr (TABAG *tabag, int target, int mode, SUPP supp,
+                  SUPP smax, double conf, int eval, int agg,
+                  double thresh, ITEM prune, ITEM min, ITEM max,
+                  int surr, long cnt, unsigned long seed)
+{                               /* --- pattern spectrum of surrogates */
+  APRSURR   sur;                /* surrogate data mining data */
+  #ifdef TA_THREADS             /* if to use multiple threads */
+  pthread_t thds[TA_THREADS];   /* worker threads */
+  int       c;                  /* number of started threads */
+  #else                         /* if to use only one thread */
+  long      i;                  /* loop variable for surrogates */
+  #endif
+
+  assert(tabag && (cnt > 0));   /* check the function arguments */
+  sur.tabag  = tabag;  sur.target = target;
+  sur.mode   = mode & ~(APR_VERBOSE|APR_NOCLEAN);
+  sur.supp   = supp;   sur.smax   = smax;   sur.conf  = conf;
+  sur.eval   = eval;   sur.agg    = agg;    sur.thresh = thresh;
+  sur.prune  = prune;  sur.min    = min;    sur.max   = max;
+  sur.surr   = surr;   sur.seed   = seed;   sur.cnt   = cnt;
+  sur.next   = 0;      sur.psp    = NULL;   sur.err   = 0;
+  #ifdef TA_THREADS             /* if to use multiple threads */
+  pthread_mutex_init(&sur.lock, NULL);
+  for (c = 0; c < TA_THREADS-1; c++)
+    if (pthread_create(thds+c, NULL, surrogates, &sur) != 0) break;
+  surrogates(&sur);             /* start the worker threads and */
+  while (--c >= 0)              /* also mine in the calling thread */
+    pthread_join(thds[c], NULL);
+  pthread_mutex_destroy(&sur.lock);
+  #else                         /* if to use only one thread */
+  for (i = 0; (i < cnt) && !sur.err; i++)
+    sur.err = surrogate(&sur, i);
+  #endif                        /* mine the surrogates sequentially */
+  if (sur.err && sur.psp) {     /* on error delete the spectrum */
+    psp_delete(sur.psp); sur.psp = NULL; }
+  return sur.psp;               /* return the summed pattern spectrum */
+}  /* aprsurr() */
+
+/* aprsurr() generates 'cnt' surrogate data sets from the given    */
+/* (recoded, sorted and reduced) transaction bag with tbg_surr()   */
+/* (method TBG_SWAP or TBG_PERM), mines each of them with the given */
+/* parameters and returns the sum of their pattern spectra (number */
+/* of found item sets per size and support), or NULL on failure.   */
+/* Each surrogate is generated with its own seed (derived from the */
+/* given seed and its index), so that the result does not depend   */
+/* on the number of threads or on the order in which the threads   */
+/* process the surrogates (with TA_THREADS, TA_THREADS surrogates  */
+/* are generated and mined in parallel, each by one thread).       */
+
+/*----------------------------------------------------------------------
+  Library Functions
+----------------------------------------------------------------------*/
+#ifndef APR_MAIN
+/* The library functions work on transactions that are given as arrays */
+/* of integer item identifiers (no item names), which are stored in an */
+/* item base with object names (IB_OBJNAMES). All data is kept in the  */
+/* library handle, so that different handles may be used concurrently. */
+
+APRLIB* apr_create (void)
+{                               /* --- create a library handle */
+  APRLIB *lib;                  /* created library handle */
+
+  lib = (APRLIB*)calloc(1, sizeof(APRLIB));
+  if (!lib) return NULL;        /* create the library handle */
+  lib->base = ib_create(IB_OBJNAMES, 0, ST_DIFFN, (OBJFN*)0);
+  if (!lib->base) { free(lib); return NULL; }
+  lib->tabag = tbg_create(lib->base);
+  if (!lib->tabag) { ib_delete(lib->base); free(lib); return NULL; }
+  lib->prep = -1;               /* create item base and trans. bag */
+  return lib;                   /* return the created handle */
+}  /* apr_create() */
+
+/*--------------------------------------------------------------------*/
+
+void apr_delete (APRLIB *lib)
+{                               /* --- delete a library handle */
+  assert(lib);                  /* check the function argument */
+  if (lib->tatree) tat_delete(lib->tatree, 0);
+  if (lib->psp)    psp_delete(lib->psp);
+  tbg_delete(lib->tabag, 1);    /* delete trans. bag and item base */
+  if (lib->items) free(lib->items);
+  if (lib->supps) free(lib->supps);
+  if (lib->offs)  free(lib->offs);
+  if (lib->map)   free(lib->map);
+  free(lib);                    /* delete the result buffer */
+}  /* apr_delete() */          /* and the handle itself */
+
+/*--------------------------------------------------------------------*/
+
+int apr_addta (APRLIB *lib, const ITEM *items, ITEM n, SUPP wgt)
+{                               /* --- add a transaction */
+  ptrdiff_t k;                  /* item identifier as object name */
+
+  assert(lib && (items || (n <= 0)));  /* check function arguments */
+  if (lib->prep >= 0) return -2;/* transactions must not be recoded */
+  ib_clear(lib->base);          /* clear the internal transaction */
+  while (--n >= 0) {            /* traverse the given items */
+    k = (ptrdiff_t)*items++;    /* and add them to the transaction */
+    if (ib_add2ta(lib->base, &k) < 0) return -1;
+  }                             /* (item ids. are object names) */
+  ib_finta(lib->base, wgt);     /* finalize the transaction and */
+  return tbg_addib(lib->tabag); /* add it to the transaction bag */
+}  /* apr_addta() */
+
+/*--------------------------------------------------------------------*/
+
+int apr_prep (APRLIB *lib, double supp)
+{                               /* --- preprocess transactions */
+  ITEM i, m;                    /* loop variable, number of items */
+
+  assert(lib);                  /* check the function arguments */
+  supp = ceilsupp((supp >= 0) ? 0.01 *supp *(double)tbg_wgt(lib->tabag)
+                              : -supp);
+  if (lib->prep >= 0)           /* if already preprocessed, */
+    return ((SUPP)supp < lib->prep) ? -2 : 0;  /* check the support */
+  m = tbg_recode(lib->tabag, (SUPP)supp, -1, -1, 2);
+  if (m < 0) return -1;         /* recode items and transactions */
+  tbg_itsort(lib->tabag, +1, 0);/* sort items in transactions and */
+  tbg_sort  (lib->tabag, +1, 0);/* sort the trans. lexicographically */
+  tbg_reduce(lib->tabag, 0);    /* reduce transactions to unique ones */
+  lib->map = (ITEM*)malloc((size_t)(m+1) *sizeof(ITEM));
+  if (!lib->map) return -1;     /* create an item identifier map */
+  for (i = 0; i < m; i++)       /* map codes to original identifiers */
+    lib->map[i] = (ITEM)*(const ptrdiff_t*)ib_key(lib->base, i);
+  lib->prep = (SUPP)supp;       /* note the preprocessing support */
+  return 0;                     /* return 'ok' */
+}  /* apr_prep() */
+
+/*--------------------------------------------------------------------*/
+
+static void collect (ISREPORT *rep, void *data)
+{                               /* --- collect a found item set */
+  APRLIB *lib = (APRLIB*)data;  /* library handle */
+  ITEM   i, n;                  /* loop variable, number of items */
+  size_t k;                     /* new size of result arrays */
+  void   *p;                    /* reallocated result array */
+
+  if (lib->err) return;         /* check for an earlier error */
+  n = isr_cnt(rep);             /* get the size of the item set */
+  if (lib->cnt >= lib->size) {  /* if the set arrays are full */
+    k  = lib->size;             /* compute the new array size */
+    k += (k > BLKSIZE) ? k >> 1 : BLKSIZE;
+    p  = realloc(lib->supps, k *sizeof(SUPP));
+    if (!p) { lib->err = -1; return; }
+    lib->supps = (SUPP*)p;      /* enlarge the support array */
+    p  = realloc(lib->offs, (k+1) *sizeof(size_t));
+    if (!p) { lib->err = -1; return; }
+    lib->offs  = (size_t*)p;    /* enlarge the offset array */
+    lib->offs[lib->cnt] = lib->icnt;
+    lib->size  = k;             /* note the new array size */
+  }
+  if (lib->icnt +(size_t)n > lib->isize) {
+    k  = lib->isize;            /* if the item array is full */
+    k += (k > BLKSIZE) ? k >> 1 : BLKSIZE;
+    if (k < lib->icnt +(size_t)n) k = lib->icnt +(size_t)n;
+    p  = realloc(lib->items, k *sizeof(ITEM));
+    if (!p) { lib->err = -1; return; }
+    lib->items = (ITEM*)p;      /* enlarge the item array */
+    lib->isize = k;             /* and note its new size */
+  }
+  for (i = 0; i < n; i++)       /* store the original item ids. */
+    lib->items[lib->icnt++] = lib->map[isr_itemx(rep, i)];
+  lib->supps[lib->cnt]  = (SUPP)isr_supp(rep);
+  lib->offs[++lib->cnt] = lib->icnt;
+}  /* collect() */              /* store support and end offset */
+
+/*--------------------------------------------------------------------*/
+
+int apr_mine (APRLIB *lib, int target, double supp, ITEM min, ITEM max,
+              int eval, int aggm, double minval,
+              ISREPOFN *repofn, void *data)
+{                               /* --- find frequent item sets */
+  int      r;                   /* result of apriori() */
+  ISREPORT *rep;                /* item set reporter */
+
+  assert(lib);                  /* check the function arguments */
+  if (target & ISR_RULE) return -2;  /* only item sets are supported */
+  r = apr_prep(lib, supp);      /* preprocess the transactions */
+  if (r < 0) return r;          /* (if not done yet) */
+  supp = ceilsupp((supp >= 0) ? 0.01 *supp *(double)tbg_wgt(lib->tabag)
+                              : -supp);
+  lib->cnt = lib->icnt = 0;     /* clear the result buffer */
+  lib->err = 0;                 /* and the error status */
+  if (lib->offs) lib->offs[0] = 0;
+  if (lib->psp) { psp_delete(lib->psp); lib->psp = NULL; }
+  rep = isr_create(lib->base, ((eval & ~IST_INVBXS) == IST_LDRATIO)
+                             ? ISR_LOGS : 0, -1, NULL, NULL, NULL);
+  if (!rep) return -1;          /* create an item set reporter */
+  isr_setsize(rep, min, max);   /* and configure it */
+  isr_open(rep, NULL, NULL);    /* (no output file, only callback) */
+  if (lib->spec) {              /* if to collect a pattern spectrum */
+    isr_setsupp(rep, (RSUPP)supp, (RSUPP)tbg_wgt(lib->tabag));
+    if (isr_addpsp(rep, NULL) < 0) { isr_delete(rep, 0); return -1; }
+  }                             /* (known range: preallocated rows) */
+  if (lib->spec >= 0) {         /* if item sets are to be reported */
+    if (lib->top > 0) {         /* if to report only the best sets */
+      if (isr_settop(rep, lib->top) < 0) {
+        isr_delete(rep, 0); return -1; }
+      isr_seteval(rep, isr_suppfac, &lib->topfac, +1, -INFINITY);
+    }                           /* (score: support *fac^size) */
+    if (repofn) isr_setrepo(rep, repofn,  data);
+    else        isr_setrepo(rep, collect, lib);
+  }                             /* (otherwise the sets are only */
+  if (tbg_itemcnt(lib->tabag) <= 0) r = 0;   /* counted) */
+  else if (!lib->tatree           /* build the transaction tree once */
+  &&       !(lib->tatree = tat_create(lib->tabag))) r = -1;
+  else r = apriorix(lib->tabag, lib->tatree, target,
+                    APP_BOTH|IST_PERFECT, (SUPP)supp, SUPP_MAX, 1.0,
+                    eval, aggm, minval, -INFINITY, ITEM_MIN, 0, 0, rep);
+  if (lib->spec)                /* search for frequent item sets and */
+    lib->psp = isr_rempsp(rep, 0);   /* get the pattern spectrum */
+  isr_delete(rep, 0);           /* delete the item set reporter */
+  if (r < 0) return r;          /* check for an error */
+  return (repofn || (lib->spec < 0)) ? 0 : lib->err;
+}  /* apr_mine() */
+
+/*--------------------------------------------------------------------*/
+
+void apr_settop (APRLIB *lib, size_t n, double fac)
+{                               /* --- set number of best item sets */
+  assert(lib);                  /* check the function arguments */
+  lib->top    = n;              /* note the number of best item sets */
+  lib->topfac = fac;            /* and the size factor for the score */
+}  /* apr_settop() */
+
+/* If n > 0, apr_mine() reports only the n item sets with the highest */
+/* support times fac raised to the item set size (fac = 1: support), */
+/* best first, unless an additional evaluation measure is requested, */
+/* which then replaces this score (see isr_settop() in report.c).   */
+
+/*--------------------------------------------------------------------*/
+
+void apr_setspec (APRLIB *lib, int spec)
+{                               /* --- set pattern spectrum mode */
+  assert(lib);                  /* check the function argument */
+  lib->spec = spec;             /* note the pattern spectrum mode */
+}  /* apr_setspec() */
+
+/* If spec > 0, apr_mine() also collects the pattern spectrum of the */
+/* found item sets, which can be retrieved with apr_psp(). If spec < 0, */
+/* only the pattern spectrum is collected: the item sets are neither  */
+/* formatted nor passed to a callback or stored in the result buffer, */
+/* which is all that is needed for significance tests with surrogates. */
+
+/*--------------------------------------------------------------------*/
+
+ITEM apr_orig (APRLIB *lib, ITEM item)
+{ assert(lib && lib->map); return lib->map[item]; }
+
+size_t apr_cnt (APRLIB *lib)
+{ assert(lib); return lib->cnt; }
+
+ITEM apr_size (APRLIB *lib, size_t i)
+{ assert(lib && (i < lib->cnt));
+  return (ITEM)(lib->offs[i+1] -lib->offs[i]); }
+
+const ITEM* apr_items (APRLIB *lib, size_t i)
+{ assert(lib && (i < lib->cnt)); return lib->items +lib->offs[i]; }
+
+SUPP apr_supp (APRLIB *lib, size_t i)
+{ assert(lib && (i < lib->cnt)); return lib->supps[i]; }
+
+PATSPEC* apr_psp (APRLIB *lib)
+{ assert(lib); return lib->psp; }
+
+#endif
 /*----------------------------------------------------------------------
   Main Functions
 ----------------------------------------------------------------------*/
@@ -393,6 +796,10 @@ static void help (void)
   printf("  m      Fisher's exact test (mutual information)\n");
   printf("  s      Fisher's exact test (support)\n");
   printf("\n");
+  printf("surrogate data generation methods (option -Y#)\n");
+  printf("  s      swap randomization (default)\n");
+  printf("  p      item permutation\n");
+  printf("\n");
   printf("information output format characters (option -v#)\n");
   printf("  %%%%    a percent sign\n");
   printf("  %%i    number of items (item set size)\n");
@@ -498,6 +905,42 @@ GENERROR(error, exit)           /* generic error reporting function */
 /*--------------------------------------------------------------------*/
 #ifdef APRIACC
 
+static int border (ISREPORT *rep, PATSPEC *psp, long cnt, double lvl)
+{                               /* --- set border from surrogates */
+  ITEM   z;                     /* loop variable for sizes */
+  SUPP   s, b;                  /* loop variable for support, border */
+  double n, sum;                /* allowed number and sum of sets */
+  int    k = 0;                 /* number of restricted sizes */
+
+  assert(rep && psp && (cnt > 0)); /* check the function arguments */
+  n = lvl *(double)cnt;         /* allowed number of found item sets */
+  for (z = psp_min(psp); z <= psp_max(psp); z++) {
+    if (psp_max4sz(psp, z) < psp_min4sz(psp, z))
+      continue;                 /* skip sizes without item sets */
+    sum = 0; b = psp_max4sz(psp, z) +1;
+    for (s = psp_max4sz(psp, z); s >= psp_min4sz(psp, z); s--) {
+      sum += (double)psp_getfrq(psp, z, s);
+      if (sum >= n) break;      /* sum the frequencies from the */
+      b = s;                    /* highest support downwards while */
+    }                           /* they stay below the allowed number */
+    if (sum < n) continue;      /* skip sizes without restriction */
+    if (isr_setbdr(rep, z, (RSUPP)b) < 0) return -1;
+    k++;                        /* set the minimum support */
+  }                             /* for the item set size */
+  return k;                     /* return number of restricted sizes */
+}  /* border() */
+
+/* An item set signature (size z, support s) is considered to be    */
+/* significant if the item sets with size z and support at least s  */
+/* found in the surrogate data sets are, on average, fewer than the */
+/* significance level 'lvl' per data set. Hence the border for size */
+/* z is the smallest support for which the sum of the frequencies   */
+/* of this and all larger supports in the (summed) pattern spectrum */
+/* of the 'cnt' surrogates stays below lvl*cnt. For a level 1/cnt   */
+/* only signatures that did not occur in any surrogate qualify.     */
+
+/*--------------------------------------------------------------------*/
+
 int main (int argc, char *argv[])
 {                               /* --- main function */
   int     i, k = 0;             /* loop variables, counters */
@@ -527,6 +970,10 @@ int main (int argc, char *argv[])
   int     mtar     =  0;        /* mode for transaction weights */
   int     mrep     =  0;        /* mode for item set reporting */
   int     stats    =  0;        /* flag for item set statistics */
+  long    scnt     =  0;        /* number of surrogate data sets */
+  int     surr     = 's';       /* surrogate generation method */
+  double  psflvl   =  1;        /* level for pattern spectrum filter */
+  long    seed     = -1;        /* seed for random number generator */
   PATSPEC *psp;                 /* collected pattern spectrum */
   ITEM    m;                    /* number of items */
   TID     n;                    /* number of transactions */
@@ -573,10 +1020,22 @@ int main (int argc, char *argv[])
                     "transaction size sum)\n");
     printf("-R#      read an item selection from a file\n");
     printf("-P#      write a pattern spectrum to a file\n");
+    printf("-N#      number of surrogate data sets            "
+                    "(default: %ld)\n", scnt);
+    printf("         (> 0: pattern spectrum filtering "
+                    "with surrogate data)\n");
+    printf("-Y#      surrogate data generation method         "
+                    "(default: '%c')\n", surr);
+    printf("-a#      significance level for spectrum filter   "
+                    "(default: %g%%)\n", psflvl);
+    printf("-S#      seed for pseudo-random numbers           "
+                    "(default: time)\n");
     printf("-Z       print item set statistics "
                     "(number of item sets per size)\n");
     printf("-g       write output in scanable form "
                     "(quote certain characters)\n");
+    printf("-B       write output in binary form "
+                    "(item ids and support values)\n");
     printf("-h#      record header  for output                "
                     "(default: \"%s\")\n", hdr);
     printf("-k#      item separator for output                "
@@ -601,7 +1060,7 @@ int main (int argc, char *argv[])
     return 0;                   /* print a usage message */
   }                             /* and abort the program */
   #endif  /* #ifndef QUIET */
-  /* free option characters: acijloptuxy [A-Z]\[CPRZ] */
+  /* free option characters: cijlotuxy [A-Z]\[CNPRSYZ] */
 
   /* --- evaluate arguments --- */
   for (i = 1; i < argc; i++) {  /* traverse arguments */
@@ -622,7 +1081,12 @@ int main (int argc, char *argv[])
           case 'R': optarg = &fn_sel;                break;
           case 'P': optarg = &fn_psp;                break;
           case 'Z': stats  = 1;                      break;
-          case 'g': mrep   = ISR_SCAN;               break;
+          case 'N': scnt   =       strtol(s, &s, 0); break;
+          case 'Y': surr   = (*s) ? *s++ : 's';      break;
+          case 'a': psflvl =       strtod(s, &s);    break;
+          case 'S': seed   =       strtol(s, &s, 0); break;
+          case 'g': mrep  |= ISR_SCAN;               break;
+          case 'B': mrep  |= ISR_BINARY;             break;
           case 'h': optarg = &hdr;                   break;
           case 'k': optarg = &sep;                   break;
           case 'v': optarg = &format;                break;
@@ -649,6 +1113,7 @@ int main (int argc, char *argv[])
   if (max    < 0)   error(E_SIZE, max); /* and the minimum support */
   if (supp   > 100) error(E_SUPPORT, supp);
   if (siglvl > 100) error(E_SIGLVL, siglvl);
+  if ((psflvl <= 0) || (psflvl > 100)) error(E_SIGLVL, psflvl);
   if ((!fn_inp || !*fn_inp) && (fn_sel && !*fn_sel))
     error(E_STDIN);             /* stdin must not be used twice */
   switch (stat) {               /* check and translate evaluation */
@@ -666,6 +1131,12 @@ int main (int argc, char *argv[])
     case 's': stat = RE_FETSUPP;         break;
     default : error(E_STAT, (char)stat); break;
   }                             /* (get target type code) */
+  switch (surr) {               /* check and translate surr. method */
+    case 's': surr = TBG_SWAP;           break;
+    case 'p': surr = TBG_PERM;           break;
+    default : error(E_SURR, (char)surr); break;
+  }                             /* (get surrogate method code) */
+  if (seed < 0) seed = (long)time(NULL);
   if ((format == dflt) && (supp >= 0))
     format = "  (%3S,%4P)";     /* adapt the default info. format */
   MSG(stderr, "\n");            /* terminate the startup message */
@@ -710,7 +1181,8 @@ int main (int argc, char *argv[])
     error(E_NOITEMS);           /* and at least one transaction */
   MSG(stderr, "\n");            /* compute absolute support value */
   supp = ceilsupp((supp >= 0) ? 0.01 *supp *(double)w : -supp);
-  siglvl *= 0.01;               /* turn sig. level into fraction */
+  siglvl *= 0.01;               /* turn sig. levels into fractions */
+  psflvl *= 0.01;
 
   /* --- sort and recode items --- */
   t = clock();                  /* start timer, print log message */
@@ -731,12 +1203,28 @@ int main (int argc, char *argv[])
   if (w != (SUPP)n) MSG(stderr, "/%"SUPP_FMT, w);
   MSG(stderr, " transaction(s)] done [%.2fs].\n", SEC_SINCE(t));
 
-  /* --- find frequent item sets --- */
-  t = clock();                  /* start the timer */
+  /* --- mine surrogate data sets --- */
   report = isr_create(ibase, mrep, -1, hdr, sep, NULL);
   if (!report) error(E_NOMEM);  /* create an item set reporter */
   isr_setfmt (report, format);  /* and configure it: set flags, */
   isr_setsize(report, min, max);/* info. format and size range, */
+  isr_setsupp(report, (RSUPP)supp, (RSUPP)w);
+  if (scnt > 0) {               /* if pattern spectrum filtering */
+    t = clock();                /* start timer, print log message */
+    MSG(stderr, "mining %ld surrogate data set(s) ... ", scnt);
+    psp = aprsurr(tabag, ISR_MAXIMAL, mode, (SUPP)supp, (SUPP)w, 100.0,
+                  stat|invbxs, IST_MAX, siglvl, prune, min, max,
+                  surr, scnt, (unsigned long)seed);
+    if (!psp) error(E_NOMEM);   /* get the surrogate pattern spectrum */
+    k = border(report, psp, scnt, psflvl);
+    psp_delete(psp);            /* set the support border */
+    if (k < 0) error(E_NOMEM);  /* for the item sets to report */
+    MSG(stderr, "[%d size(s) restricted]", k);
+    MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+  }
+
+  /* --- find frequent item sets --- */
+  t = clock();                  /* start the timer */
   if (fn_psp && (isr_addpsp(report, NULL) < 0))
     error(E_NOMEM);             /* add a pattern spectrum if req. */
   if (isr_open(report, NULL, fn_out) != 0)
@@ -784,6 +1272,7 @@ int main (int argc, char *argv[])
   CCHAR   *fn_out  = NULL;      /* name of output file */
   CCHAR   *fn_app  = NULL;      /* name of item appearances file */
   CCHAR   *fn_psp  = NULL;      /* name of pattern spectrum file */
+  CCHAR   *fn_tid  = NULL;      /* name of transaction id file */
   CCHAR   *recseps = NULL;      /* record  separators */
   CCHAR   *fldseps = NULL;      /* field   separators */
   CCHAR   *blanks  = NULL;      /* blank   characters */
@@ -812,6 +1301,7 @@ int main (int argc, char *argv[])
   int     mtar     = 0;         /* mode for transaction reading */
   int     mrep     = 0;         /* mode for item set reporting */
   int     stats    = 0;         /* flag for item set statistics */
+  long    top      = 0;         /* number of best item sets to report */
   PATSPEC *psp;                 /* collected pattern spectrum */
   ITEM    m;                    /* number of items */
   TID     n;                    /* number of transactions */
@@ -879,10 +1369,18 @@ int main (int argc, char *argv[])
     printf("-T       do not organize transactions as a prefix tree\n");
     printf("-R#      read item selection/appearance indicators\n");
     printf("-P#      write pattern spectrum to a file\n");
+    printf("-L#      write transaction ids of item sets to a file\n");
+    printf("-N#      report only the # best item sets         "
+                    "(default: all)\n");
+    printf("         (best w.r.t. the evaluation measure (-e#),\n"
+           "         or w.r.t. support if no measure is given,\n"
+           "         no transaction ids are written with -L#)\n");
     printf("-Z       print item set statistics "
                     "(number of item sets per size)\n");
     printf("-g       write item names in scanable form "
                     "(quote certain characters)\n");
+    printf("-B       write output in binary form "
+                    "(item ids and support values)\n");
     printf("-h#      record header  for output                "
                     "(default: \"%s\")\n", hdr);
     printf("-k#      item separator for output                "
@@ -912,7 +1410,7 @@ int main (int argc, char *argv[])
     return 0;                   /* print a usage message */
   }                             /* and abort the program */
   #endif  /* #ifndef QUIET */
-  /* free option characters: j[A-Z]\[CIPST] */
+  /* free option characters: j[A-Z]\[CILNPST] */
 
   /* --- evaluate arguments --- */
   for (i = 1; i < argc; i++) {  /* traverse the arguments */
@@ -942,8 +1440,11 @@ int main (int argc, char *argv[])
           case 'T': mode  &= ~APR_TATREE;            break;
           case 'R': optarg = &fn_app;                break;
           case 'P': optarg = &fn_psp;                break;
+          case 'L': optarg = &fn_tid;                break;
+          case 'N': top    =       strtol(s, &s, 0); break;
           case 'Z': stats  = 1;                      break;
-          case 'g': mrep   = ISR_SCAN;               break;
+          case 'g': mrep  |= ISR_SCAN;               break;
+          case 'B': mrep  |= ISR_BINARY;             break;
           case 'h': optarg = &hdr;                   break;
           case 'k': optarg = &sep;                   break;
           case 'I': optarg = &imp;                   break;
@@ -1019,7 +1520,12 @@ int main (int argc, char *argv[])
   if (eval <= RE_NONE) prune = ITEM_MIN;
   if (target < ISR_RULE) {      /* remove rule specific settings */
     mode |= APP_BOTH; conf = 100; }
-  else fn_psp = NULL;           /* no pattern spectrum for rules */
+  else {                        /* no pattern spectrum, trans. ids */
+    fn_psp = fn_tid = NULL; top = 0; }  /* or best sets for rules */
+  if (dir) {                    /* no trans. ids or best sets */
+    fn_tid = NULL; top = 0; }   /* for sorted item sets */
+  if (top < 0) top = 0;         /* check the number of best sets */
+  if (top > 0) fn_tid = NULL;   /* no trans. ids for best sets */
   if ((filter <= -1) || (filter >= 1))
     filter = 0;                 /* check and adapt the filter option */
   if (format == dflt) {         /* if default info. format is used, */
@@ -1086,6 +1592,24 @@ int main (int argc, char *argv[])
   MSG(stderr, "[%"ITEM_FMT" item(s)]", m);
   MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
 
+  /* --- create item set reporter --- */
+  if (eval == IST_LDRATIO) mrep |= ISR_LOGS;
+  report = isr_create(ibase, mrep, -1, hdr, sep, imp);
+  if (!report) error(E_NOMEM);  /* create an item set reporter */
+  isr_setfmt (report, format);  /* and configure it: set mode, */
+  isr_setsize(report, min, max);/* info. format and size range */
+  isr_setsupp(report, (RSUPP)ceilsupp(supp),
+              (RSUPP)((smax < (double)w) ? smax : (double)w));
+  if (fn_psp && (isr_addpsp(report, NULL) < 0))
+    error(E_NOMEM);             /* add a pattern spectrum if req. */
+  if (fn_tid && (isr_tidlists(report, tabag) < 0))
+    error(E_NOMEM);             /* collect transaction ids if req. */
+  if ((top > 0) && (isr_settop(report, (size_t)top) < 0))
+    error(E_NOMEM);             /* collect the best item sets if req. */
+  /* The transaction id lists must be collected before the trans-  */
+  /* actions are sorted and reduced, because the position of a     */
+  /* transaction in the (unsorted) bag is its identifier.          */
+
   /* --- sort and reduce transactions --- */
   t = clock();                  /* start timer, print log message */
   MSG(stderr, "sorting and reducing transactions ... ");
@@ -1101,15 +1625,10 @@ int main (int argc, char *argv[])
   MSG(stderr, " transaction(s)] done [%.2fs].\n", SEC_SINCE(t));
 
   /* --- execute apriori algorithm --- */
-  if (eval == IST_LDRATIO) mrep |= ISR_LOGS;
-  report = isr_create(ibase, mrep, -1, hdr, sep, imp);
-  if (!report) error(E_NOMEM);  /* create an item set reporter */
-  isr_setfmt (report, format);  /* and configure it: set mode, */
-  isr_setsize(report, min, max);/* info. format and size range */
-  if (fn_psp && (isr_addpsp(report, NULL) < 0))
-    error(E_NOMEM);             /* add a pattern spectrum if req. */
   if (isr_open(report, NULL, fn_out) != 0)
     error(E_FOPEN, isr_name(report)); /* open the output file */
+  if (fn_tid && ((k = isr_tidopen(report, NULL, fn_tid)) != 0))
+    error((k == -1) ? E_NOMEM : E_FOPEN, isr_tidname(report));
   MSG(stderr, "writing %s ... ", isr_name(report));
   k = apriori(tabag, target, mode|APR_NOCLEAN,
               (SUPP)ceilsupp(supp), (SUPP)smax, conf, eval|invbxs,
@@ -1119,6 +1638,8 @@ int main (int argc, char *argv[])
     isr_prstats(report, stdout, 0);
   if (isr_close(report) != 0)   /* close the output file */
     error(E_FWRITE, isr_name(report));
+  if (isr_tidclose(report) != 0)/* close the trans. id file */
+    error(E_FWRITE, isr_tidname(report));
   MSG(stderr, "[%"SIZE_FMT" %s(s)]", isr_repcnt(report),
               (target == ISR_RULE) ? "rule" : "set");
   MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
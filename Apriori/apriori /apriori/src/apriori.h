@@ -5,9 +5,17 @@
   History : 2011.07.18 file created
             2011.10.18 several mode flags added
             2013.03.30 adapted to type changes in module tract
+            2026.10.19 library interface (in-memory transactions) added
+            2026.10.19 function apriorix() added (external trans. tree)
+            2026.10.19 function apr_settop() added (best item sets)
+            2026.10.19 functions apr_setspec() and apr_psp() added
+            2026.10.19 function aprsurr() added (surrogate data sets)
 ----------------------------------------------------------------------*/
 #ifndef __APRIORI__
 #define __APRIORI__
+#ifndef ISR_PATSPEC
+#define ISR_PATSPEC
+#endif
 #include "istree.h"
 
 /*----------------------------------------------------------------------
@@ -22,6 +30,29 @@
 #define APR_NOCLEAN   0         /* in function apriori() */
 #endif
 
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- apriori library handle --- */
+  ITEMBASE *base;               /* underlying item base */
+  TABAG    *tabag;              /* transaction bag/multiset */
+  SUPP     prep;                /* support used for preprocessing */
+  ITEM     *map;                /* map from recoded to original items */
+  TATREE   *tatree;             /* transaction tree (built on demand) */
+  size_t   top;                 /* number of best item sets (0: all) */
+  double   topfac;              /* size factor for best item sets */
+  int      spec;                /* pattern spectrum collection mode */
+  PATSPEC  *psp;                /* pattern spectrum of last search */
+  int      err;                 /* error status of result collection */
+  size_t   cnt;                 /* number of collected item sets */
+  size_t   size;                /* size of the item set arrays */
+  size_t   *offs;               /* offsets of item sets in items[] */
+  SUPP     *supps;              /* support values of item sets */
+  size_t   icnt;                /* number of collected items */
+  size_t   isize;               /* size of the item array */
+  ITEM     *items;              /* items of all collected item sets */
+} APRLIB;                       /* (apriori library handle) */
+
 /*----------------------------------------------------------------------
   Functions
 ----------------------------------------------------------------------*/
@@ -29,4 +60,29 @@ extern int apriori (TABAG *tabag, int target, int mode, SUPP supp,
                     SUPP smax, double conf, int eval, int aggm,
                     double minval, double minimp, ITEM prune,
                     double filter, int dir, ISREPORT *rep);
+extern int apriorix(TABAG *tabag, TATREE *tatree, int target, int mode,
+                    SUPP supp, SUPP smax, double conf, int eval,
+                    int aggm, double minval, double minimp, ITEM prune,
+                    double filter, int dir, ISREPORT *rep);
+extern PATSPEC* aprsurr (TABAG *tabag, int target, int mode, SUPP supp,
+                    SUPP smax, double conf, int eval, int aggm,
+                    double minval, ITEM prune, ITEM min, ITEM max,
+                    int surr, long cnt, unsigned long seed);
+
+extern APRLIB* apr_create (void);
+extern void    apr_delete (APRLIB *lib);
+extern int     apr_addta  (APRLIB *lib, const ITEM *items, ITEM n,
+                           SUPP wgt);
+extern int     apr_prep   (APRLIB *lib, double supp);
+extern void    apr_settop (APRLIB *lib, size_t n, double fac);
+extern void    apr_setspec(APRLIB *lib, int spec);
+extern int     apr_mine   (APRLIB *lib, int target, double supp,
+                           ITEM min, ITEM max, int eval, int aggm,
+                           double minval, ISREPOFN *repofn, void *data);
+extern ITEM    apr_orig   (APRLIB *lib, ITEM item);
+extern size_t  apr_cnt    (APRLIB *lib);
+extern ITEM    apr_size   (APRLIB *lib, size_t i);
+extern const ITEM* apr_items (APRLIB *lib, size_t i);
+extern SUPP    apr_supp   (APRLIB *lib, size_t i);
+extern PATSPEC* apr_psp   (APRLIB *lib);
 #endif
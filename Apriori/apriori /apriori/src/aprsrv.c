@@ -0,0 +1,596 @@
+/*----------------------------------------------------------------------
+  File    : aprsrv.c
+  Contents: apriori server (answer queries on a preprocessed data set)
+  Author  : agent
+  History : 2026.10.19 file created
+------------------------------------------------------------------------
+  The transaction database is read and preprocessed (filtered with a
+  minimum support, items recoded, transactions sorted and reduced, and
+  optionally organized as a prefix tree) only once. Afterwards queries
+  are read line by line from standard input or from the connections to
+  a Unix domain socket. Each query consists of apriori options, e.g.
+
+    -tc -s20 -m2 -n4 -v" (%a)"
+
+  and is answered with the found item sets/rules in the usual output
+  format, followed by a line "# ok <number of sets/rules>" or by a line
+  "# error: <message>". The lines "quit" and "stop" end a connection or
+  the server, respectively. Only the item set tree is rebuilt for each
+  query, the transaction bag and the transaction tree are reused.
+----------------------------------------------------------------------*/
+#if !defined _WIN32 && !defined APR_NOSOCK
+#define _POSIX_C_SOURCE 200112L     /* needed for fdopen() and sockets */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include <time.h>
+#include <assert.h>
+#if defined _WIN32 && !defined APR_NOSOCK
+#define APR_NOSOCK                  /* no Unix domain sockets */
+#endif
+#ifndef APR_NOSOCK
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+#ifndef TA_READ
+#define TA_READ
+#endif
+#include "apriori.h"
+#include "error.h"
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+#ifndef INFINITY
+#define INFINITY    (DBL_MAX+DBL_MAX)
+#endif                          /* MSC still does not support C99 */
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define PRGNAME     "aprsrv"
+#define DESCRIPTION "answer frequent item set queries " \
+                    "on a preprocessed data set"
+#define VERSION     "version 1.0 (2026.10.19)         " \
+                    "(c) 2026   agent"
+
+/* --- error codes --- */
+/* error codes   0 to  -4 defined in tract.h */
+#define E_STDIN      (-5)       /* double assignment of stdin */
+#define E_OPTION     (-6)       /* unknown option */
+#define E_OPTARG     (-7)       /* missing option argument */
+#define E_ARGCNT     (-8)       /* too few/many arguments */
+#define E_TARGET     (-9)       /* invalid target type */
+#define E_SIZE      (-10)       /* invalid set/rule size */
+#define E_SUPPORT   (-11)       /* invalid support */
+#define E_CONF      (-12)       /* invalid confidence */
+#define E_MEASURE   (-13)       /* invalid evaluation measure */
+#define E_AGGMODE   (-14)       /* invalid aggregation mode */
+#define E_PREP      (-16)       /* support below preprocessing */
+#define E_SOCKET    (-17)       /* cannot create socket */
+#define E_LINE      (-18)       /* query line too long */
+/* error codes -15 to -25 defined in tract.h */
+
+#define MAXARGS     64          /* maximum number of query arguments */
+#define LINESIZE    4096        /* size of the query line buffer */
+
+#ifndef QUIET                   /* if not quiet version, */
+#define MSG         fprintf     /* print messages */
+#else                           /* if quiet version, */
+#define MSG(...)                /* suppress messages */
+#endif
+
+#define SEC_SINCE(t)  ((double)(clock()-(t)) /(double)CLOCKS_PER_SEC)
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+/* --- error messages --- */
+static const char *errmsgs[] = {
+  /* E_NONE      0 */  "no error",
+  /* E_NOMEM    -1 */  "not enough memory",
+  /* E_FOPEN    -2 */  "cannot open file %s",
+  /* E_FREAD    -3 */  "read error on file %s",
+  /* E_FWRITE   -4 */  "write error on file %s",
+  /* E_STDIN    -5 */  "double assignment of standard input",
+  /* E_OPTION   -6 */  "unknown option -%c",
+  /* E_OPTARG   -7 */  "missing option argument",
+  /* E_ARGCNT   -8 */  "wrong number of arguments",
+  /* E_TARGET   -9 */  "invalid target type '%c'",
+  /* E_SIZE    -10 */  "invalid item set or rule size %"ITEM_FMT,
+  /* E_SUPPORT -11 */  "invalid minimum support %g",
+  /* E_CONF    -12 */  "invalid minimum confidence %g",
+  /* E_MEASURE -13 */  "invalid evaluation measure '%c'",
+  /* E_AGGMODE -14 */  "invalid aggregation mode '%c'",
+  /* E_NOITEMS -15 */  "no (frequent) items found",
+  /* E_PREP    -16 */  "support below preprocessing support %g",
+  /* E_SOCKET  -17 */  "cannot create socket %s",
+  /* E_LINE    -18 */  "query line too long",
+  /*           -19 */  "unknown error"
+};
+
+/*----------------------------------------------------------------------
+  Global Variables
+----------------------------------------------------------------------*/
+#ifndef QUIET
+static CCHAR    *prgname;       /* program name for error messages */
+#endif
+static TABREAD  *tread  = NULL; /* table/transaction reader */
+static ITEMBASE *ibase  = NULL; /* item base */
+static TABAG    *tabag  = NULL; /* transaction bag/multiset */
+static TATREE   *tatree = NULL; /* transaction tree */
+static SUPP     prep    = 0;    /* support used for preprocessing */
+#ifndef APR_NOSOCK
+static CCHAR    *fn_sock = NULL;/* name of the Unix domain socket */
+static int      sock     = -1;  /* listening socket */
+#endif
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+#ifndef APR_NOSOCK
+#define CLOSESOCK \
+  if (sock >= 0) { close(sock); unlink(fn_sock); }
+#else
+#define CLOSESOCK
+#endif
+
+#undef  CLEANUP                 /* clean up memory and close files */
+#define CLEANUP \
+  CLOSESOCK                          \
+  if (tatree) tat_delete(tatree, 0); \
+  if (tabag)  tbg_delete(tabag,  0); \
+  if (tread)  trd_delete(tread,  1); \
+  if (ibase)  ib_delete (ibase);
+
+GENERROR(error, exit)           /* generic error reporting function */
+
+/*--------------------------------------------------------------------*/
+
+static int reply (FILE *out, int code, ...)
+{                               /* --- report an error to the client */
+  va_list args;                 /* list of variable arguments */
+  int     k;                    /* maximal error code */
+
+  k = 1-(int)(sizeof(errmsgs)/sizeof(*errmsgs));
+  if (code < k) code = k;       /* check and adapt the error code */
+  va_start(args, code);         /* start variable arguments */
+  fputs("# error: ", out);      /* print the error message */
+  vfprintf(out, errmsgs[-code], args);
+  fputc('\n', out);             /* terminate the output line */
+  va_end(args);                 /* end variable arguments */
+  return code;                  /* return the error code */
+}  /* reply() */
+
+/*--------------------------------------------------------------------*/
+
+static int split (char *s, char *args[])
+{                               /* --- split a query into arguments */
+  int  n = 0;                   /* number of arguments */
+  char *d;                      /* destination for copying */
+
+  assert(s && args);            /* check the function arguments */
+  while (1) {                   /* traverse the arguments */
+    while ((*s == ' ') || (*s == '\t') || (*s == '\r') || (*s == '\n'))
+      s++;                      /* skip leading blanks */
+    if (!*s || (n >= MAXARGS)) break;
+    args[n++] = d = s;          /* note the start of the argument */
+    while (*s && (*s != ' ') && (*s != '\t')
+    &&           (*s != '\r') && (*s != '\n')) {
+      if (*s != '"') { *d++ = *s++; continue; }
+      for (s++; *s && (*s != '"'); ) *d++ = *s++;
+      if (*s) s++;              /* copy quoted parts (with blanks) */
+    }                           /* and remove the quotes */
+    if (*s) s++;                /* skip the terminating blank and */
+    *d = '\0';                  /* terminate the argument */
+  }
+  return n;                     /* return the number of arguments */
+}  /* split() */
+
+/*--------------------------------------------------------------------*/
+
+static int query (char *line, FILE *out)
+{                               /* --- answer a mining query */
+  int      i, n;                /* loop variable, number of args. */
+  char     *s;                  /* to traverse the options */
+  char     *args[MAXARGS];      /* query arguments */
+  CCHAR    **optarg = NULL;     /* option argument */
+  CCHAR    *hdr     = "";       /* record header  for output */
+  CCHAR    *sep     = " ";      /* item separator for output */
+  CCHAR    *imp     = " <- ";   /* implication sign for ass. rules */
+  CCHAR    *dflt    = " (%S)";  /* default format for check */
+  CCHAR    *format  = dflt;     /* format for information output */
+  int      target   = 's';      /* target type (sets/rules/h.edges) */
+  ITEM     min      = 1;        /* minimum rule/item set size */
+  ITEM     max      = ITEM_MAX; /* maximum rule/item set size */
+  double   supp     = 10;       /* minimum support    (in percent) */
+  double   smax     = 100;      /* maximum support    (in percent) */
+  double   conf     = 80;       /* minimum confidence (in percent) */
+  int      eval     = 'x';      /* additional evaluation measure */
+  int      agg      = 'x';      /* aggregation mode for eval. measure */
+  double   thresh   = 10;       /* minimum evaluation measure value */
+  double   minimp   = -INFINITY;/* minimum increase of measure value */
+  int      invbxs   = 0;        /* invalidate eval. below expectation */
+  ITEM     prune    = ITEM_MIN; /* (min. size for) evaluation pruning */
+  int      mode     = APP_BODY|IST_PERFECT;  /* search mode */
+  int      dir      = 0;        /* direction for size sorting */
+  int      mrep     = 0;        /* mode for item set reporting */
+  SUPP     w;                   /* total transaction weight */
+  double   r;                   /* support needed for recoding */
+  size_t   cnt;                 /* number of reported sets/rules */
+  FILE     *file;               /* output file for the reporter */
+  ISREPORT *report;             /* item set reporter */
+
+  assert(line && out);          /* check the function arguments */
+  n = split(line, args);        /* split the query into arguments */
+  for (i = 0; i < n; i++) {     /* traverse the arguments */
+    s = args[i];                /* get an option argument */
+    if (optarg) { *optarg = s; optarg = NULL; continue; }
+    if ((*s != '-') || !*++s)   /* only options are allowed */
+      return reply(out, E_ARGCNT);
+    while (*s) {                /* traverse the options */
+      switch (*s++) {           /* evaluate the options */
+        case 't': target = (*s) ? *s++ : 's';      break;
+        case 'm': min    = (ITEM)strtol(s, &s, 0); break;
+        case 'n': max    = (ITEM)strtol(s, &s, 0); break;
+        case 's': supp   =       strtod(s, &s);    break;
+        case 'S': smax   =       strtod(s, &s);    break;
+        case 'o': mode  |= APP_BOTH;               break;
+        case 'c': conf   =       strtod(s, &s);    break;
+        case 'e': eval   = (*s) ? *s++ : 0;        break;
+        case 'a': agg    = (*s) ? *s++ : 0;        break;
+        case 'd': thresh =       strtod(s, &s);    break;
+        case 'i': minimp =       strtod(s, &s);    break;
+        case 'z': invbxs = IST_INVBXS;             break;
+        case 'p': prune  = (ITEM)strtol(s, &s, 0); break;
+        case 'x': mode  &= ~IST_PERFECT;           break;
+        case 'y': mode  |=  APR_POST;              break;
+        case 'g': mrep  |= ISR_SCAN;               break;
+        case 'h': optarg = &hdr;                   break;
+        case 'k': optarg = &sep;                   break;
+        case 'I': optarg = &imp;                   break;
+        case 'v': optarg = &format;                break;
+        case 'l': dir    = (int) strtol(s, &s, 0); break;
+        default : return reply(out, E_OPTION, *--s);
+      }                         /* set the option variables */
+      if (optarg && *s) { *optarg = s; optarg = NULL; break; }
+    }                           /* get an option argument */
+  }
+  if (optarg)     return reply(out, E_OPTARG);
+  if (min  < 0)   return reply(out, E_SIZE, min);
+  if (max  < 0)   return reply(out, E_SIZE, max);
+  if (supp > 100) return reply(out, E_SUPPORT, supp);
+  if ((conf < 0) || (conf > 100))
+    return reply(out, E_CONF, conf);
+  switch (target) {             /* check and translate target type */
+    case 's': target = ISR_ALL;              break;
+    case 'c': target = ISR_CLOSED;           break;
+    case 'm': target = ISR_MAXIMAL;          break;
+    case 'g': target = ISR_GENERA;           break;
+    case 'r': target = ISR_RULE;             break;
+    default : return reply(out, E_TARGET, (char)target);
+  }
+  switch (eval) {               /* check and translate measure */
+    case 'x': eval = RE_NONE;                break;
+    case 'o': eval = RE_SUPP;                break;
+    case 'c': eval = RE_CONF;                break;
+    case 'd': eval = RE_CONFDIFF;            break;
+    case 'l': eval = RE_LIFT;                break;
+    case 'a': eval = RE_LIFTDIFF;            break;
+    case 'q': eval = RE_LIFTQUOT;            break;
+    case 'v': eval = RE_CVCT;                break;
+    case 'e': eval = RE_CVCTDIFF;            break;
+    case 'r': eval = RE_CVCTQUOT;            break;
+    case 'z': eval = RE_CERT;                break;
+    case 'n': eval = RE_CHI2;                break;
+    case 'p': eval = RE_CHI2PVAL;            break;
+    case 'y': eval = RE_YATES;               break;
+    case 't': eval = RE_YATESPVAL;           break;
+    case 'i': eval = RE_INFO;                break;
+    case 'g': eval = RE_INFOPVAL;            break;
+    case 'f': eval = RE_FETPROB;             break;
+    case 'h': eval = RE_FETCHI2;             break;
+    case 'm': eval = RE_FETINFO;             break;
+    case 's': eval = RE_FETSUPP;             break;
+    case 'b': eval = IST_LDRATIO;            break;
+    default : return reply(out, E_MEASURE, (char)eval);
+  }
+  switch (agg) {                /* check and translate agg. mode */
+    case 'x': agg = IST_NONE;                break;
+    case 'm': agg = IST_MIN;                 break;
+    case 'n': agg = IST_MAX;                 break;
+    case 'a': agg = IST_AVG;                 break;
+    case 's': agg = IST_EQS;                 break;
+    default : return reply(out, E_AGGMODE, (char)agg);
+  }
+  if (eval <= RE_NONE) prune = ITEM_MIN;
+  if (target < ISR_RULE) {      /* remove rule specific settings */
+    mode |= APP_BOTH; conf = 100; }
+  if (format == dflt) {         /* if default info. format is used, */
+    if (target != ISR_RULE)     /* set default according to target */
+         format = (supp < 0) ? " (%a)"     : " (%S)";
+    else format = (supp < 0) ? " (%b, %C)" : " (%X, %C)";
+  }                             /* select absolute/relative support */
+  w     = tbg_wgt(tabag);       /* get the total transaction weight */
+  supp  =       (supp >= 0) ? 0.01 *supp *(double)w : -supp;
+  smax  = floor((smax >= 0) ? 0.01 *smax *(double)w : -smax);
+  conf   *= 0.01;               /* transform support and confidence */
+  thresh *= 0.01;               /* and the eval. measure parameters */
+  if (minimp > -INFINITY) minimp *= 0.01;
+  r = ceilsupp((mode & APP_HEAD) ? supp : supp *conf);
+  if (r < (double)prep)         /* check the support against */
+    return reply(out, E_PREP, (double)prep);  /* the preprocessing */
+
+  /* --- execute apriori algorithm --- */
+  if (eval == IST_LDRATIO) mrep |= ISR_LOGS;
+  report = isr_create(ibase, mrep, -1, hdr, sep, imp);
+  if (!report) return reply(out, E_NOMEM);
+  isr_setfmt (report, format);  /* create an item set reporter */
+  isr_setsize(report, min, max);/* and configure it */
+  #ifndef APR_NOSOCK            /* write through a duplicated */
+  file = fdopen(dup(fileno(out)), "w");    /* file descriptor, */
+  #else                         /* because isr_close() closes */
+  file = out;                   /* the output file (if not stdout) */
+  #endif
+  if (!file) { isr_delete(report, 0); return reply(out, E_NOMEM); }
+  fflush(out);                  /* flush pending client output */
+  isr_open(report, file, "<client>");
+  i = apriorix(tabag, tatree, target, mode, (SUPP)ceilsupp(supp),
+               (SUPP)smax, conf, eval|invbxs, agg, thresh, minimp,
+               prune, 0, dir, report);
+  cnt = isr_repcnt(report);     /* get the number of sets/rules */
+  if (isr_close(report) != 0) i = E_FWRITE;
+  isr_delete(report, 0);        /* close the output and */
+  if (i < 0) return reply(out, (i == E_FWRITE) ? i : E_NOMEM, "<client>");
+  fprintf(out, "# ok %"SIZE_FMT"\n", cnt);
+  return 0;                     /* report the number of sets/rules */
+}  /* query() */
+
+/*--------------------------------------------------------------------*/
+
+static int serve (FILE *in, FILE *out)
+{                               /* --- answer the queries of a client */
+  char   line[LINESIZE];        /* buffer for a query line */
+  char   *s;                    /* to traverse the query line */
+  int    c;                     /* buffer for a character */
+  size_t n;                     /* length of the query line */
+
+  assert(in && out);            /* check the function arguments */
+  while (fgets(line, LINESIZE, in)) {
+    n = strlen(line);           /* read the next query line */
+    if ((n > 0) && (line[n-1] != '\n') && !feof(in)) {
+      while (((c = getc(in)) != EOF) && (c != '\n'));
+      reply(out, E_LINE);       /* skip the rest of a too long line */
+      fflush(out); continue;    /* and report an error */
+    }
+    for (s = line; (*s == ' ') || (*s == '\t'); s++);
+    while ((n > 0) && ((line[n-1] == '\n') || (line[n-1] == '\r')
+    ||                 (line[n-1] == ' ')  || (line[n-1] == '\t')))
+      line[--n] = '\0';         /* remove leading and trailing blanks */
+    if (!*s || (*s == '#')) continue;   /* skip empty/comment lines */
+    if (strcmp(s, "quit") == 0) return 0;
+    if (strcmp(s, "stop") == 0) return 1;
+    query(s, out);              /* answer the query */
+    if (fflush(out) != 0) return 0;
+  }                             /* abort if the client is gone */
+  return 0;                     /* return 'continue serving' */
+}  /* serve() */
+
+/*--------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{                               /* --- main function */
+  int     i, k = 0;             /* loop variables, counters */
+  char    *s;                   /* to traverse the options */
+  CCHAR   **optarg = NULL;      /* option argument */
+  CCHAR   *fn_inp  = NULL;      /* name of input  file */
+  CCHAR   *recseps = NULL;      /* record  separators */
+  CCHAR   *fldseps = NULL;      /* field   separators */
+  CCHAR   *blanks  = NULL;      /* blank   characters */
+  CCHAR   *comment = NULL;      /* comment characters */
+  double  supp     = 1;         /* minimum support    (in percent) */
+  int     sort     = 2;         /* flag for item sorting and recoding */
+  int     tree     = 1;         /* flag for a transaction tree */
+  int     mtar     = 0;         /* mode for transaction reading */
+  ITEM    m;                    /* number of items */
+  TID     n;                    /* number of transactions */
+  SUPP    w;                    /* total transaction weight */
+  clock_t t;                    /* timer for measurements */
+  #ifndef APR_NOSOCK            /* if to support sockets */
+  struct sockaddr_un addr;      /* address of the Unix domain socket */
+  FILE    *in, *out;            /* streams of a client connection */
+  int     c;                    /* client connection */
+  #endif
+
+  #ifndef QUIET                 /* if not quiet version */
+  prgname = argv[0];            /* get program name for error msgs. */
+
+  /* --- print usage message --- */
+  if (argc > 1) {               /* if arguments are given */
+    fprintf(stderr, "%s - %s\n", argv[0], DESCRIPTION);
+    fprintf(stderr, VERSION); } /* print a startup message */
+  else {                        /* if no arguments are given */
+    printf("usage: %s [options] infile [socket]\n", argv[0]);
+    printf("%s\n", DESCRIPTION);
+    printf("%s\n", VERSION);
+    printf("-s#      minimum support for preprocessing        "
+                    "(default: %g%%)\n", supp);
+    printf("         (positive: percentage, "
+                     "negative: absolute number)\n");
+    printf("         (queries must not use a smaller support)\n");
+    printf("-q#      sort items w.r.t. their frequency        "
+                    "(default: %d)\n", sort);
+    printf("         (1: ascending, -1: descending, 0: do not sort,\n"
+           "          2: ascending, -2: descending w.r.t. "
+                    "transaction size sum)\n");
+    printf("-T       do not organize transactions as a prefix tree\n");
+    printf("-w       integer transaction weight in last field "
+                    "(default: only items)\n");
+    printf("-r#      record/transaction separators            "
+                    "(default: \"\\n\")\n");
+    printf("-f#      field /item        separators            "
+                    "(default: \" \\t,\")\n");
+    printf("-b#      blank   characters                       "
+                    "(default: \" \\t\\r\")\n");
+    printf("-C#      comment characters                       "
+                    "(default: \"#\")\n");
+    printf("infile   file to read transactions from           "
+                    "[required]\n");
+    printf("socket   Unix domain socket to listen on          "
+                    "[optional]\n");
+    printf("         (default: answer queries from stdin)\n");
+    printf("queries: apriori options -t -m -n -s -S -o -c -e -a -d "
+                    "-i -z -p -x -y -g\n"
+           "         -h -k -I -v -l (see apriori), one query per line,\n"
+           "         answered with the found sets/rules and a final "
+                    "line\n"
+           "         \"# ok <count>\" or \"# error: <message>\"; "
+                    "\"quit\" ends a\n"
+           "         connection, \"stop\" ends the server\n");
+    return 0;                   /* print a usage message */
+  }                             /* and abort the program */
+  #endif  /* #ifndef QUIET */
+
+  /* --- evaluate arguments --- */
+  for (i = 1; i < argc; i++) {  /* traverse the arguments */
+    s = argv[i];                /* get an option argument */
+    if (optarg) { *optarg = s; optarg = NULL; continue; }
+    if ((*s == '-') && *++s) {  /* -- if argument is an option */
+      while (*s) {              /* traverse the options */
+        switch (*s++) {         /* evaluate the options */
+          case 's': supp   =       strtod(s, &s);    break;
+          case 'q': sort   = (int) strtol(s, &s, 0); break;
+          case 'T': tree   = 0;                      break;
+          case 'w': mtar  |= TA_WEIGHT;              break;
+          case 'r': optarg = &recseps;               break;
+          case 'f': optarg = &fldseps;               break;
+          case 'b': optarg = &blanks;                break;
+          case 'C': optarg = &comment;               break;
+          default : error(E_OPTION, *--s);           break;
+        }                       /* set the option variables */
+        if (optarg && *s) { *optarg = s; optarg = NULL; break; }
+      } }                       /* get an option argument */
+    else {                      /* -- if argument is no option */
+      switch (k++) {            /* evaluate non-options */
+        case  0: fn_inp  = s;     break;
+        #ifndef APR_NOSOCK
+        case  1: fn_sock = s;     break;
+        #endif
+        default: error(E_ARGCNT); break;
+      }                         /* note file and socket names */
+    }
+  }
+  if (optarg)     error(E_OPTARG);    /* check (option) arguments */
+  if (k    < 1)   error(E_ARGCNT);    /* and number of arguments */
+  if (supp > 100) error(E_SUPPORT, supp);
+  #ifndef APR_NOSOCK            /* queries are read from stdin */
+  if ((!fn_inp || !*fn_inp) && !fn_sock)
+  #else                         /* if no socket is given */
+  if  (!fn_inp || !*fn_inp)
+  #endif
+    error(E_STDIN);             /* stdin must not be used twice */
+  MSG(stderr, "\n");            /* terminate the startup message */
+
+  /* --- read transaction database --- */
+  ibase = ib_create(0, 0);      /* create an item base */
+  if (!ibase) error(E_NOMEM);   /* to manage the items */
+  tread = trd_create();         /* create a transaction reader */
+  if (!tread) error(E_NOMEM);   /* and configure the characters */
+  trd_allchs(tread, recseps, fldseps, blanks, "", comment);
+  tabag = tbg_create(ibase);    /* create a transaction bag */
+  if (!tabag) error(E_NOMEM);   /* to store the transactions */
+  t = clock();                  /* start timer, open input file */
+  if (trd_open(tread, NULL, fn_inp) != 0)
+    error(E_FOPEN, trd_name(tread));
+  MSG(stderr, "reading %s ... ", trd_name(tread));
+  k = tbg_read(tabag, tread, mtar);
+  if (k < 0)                    /* read the transaction database */
+    error(-k, tbg_errmsg(tabag, NULL, 0));
+  trd_delete(tread, 1);         /* close the input file and */
+  tread = NULL;                 /* delete the table reader */
+  m = ib_cnt(ibase);            /* get the number of items, */
+  n = tbg_cnt(tabag);           /* the number of transactions, */
+  w = tbg_wgt(tabag);           /* the total transaction weight */
+  MSG(stderr, "[%"ITEM_FMT" item(s), %"TID_FMT, m, n);
+  if (w != (SUPP)n) MSG(stderr, "/%"SUPP_FMT, w);
+  MSG(stderr, " transaction(s)] done [%.2fs].", SEC_SINCE(t));
+  if ((m <= 0) || (n <= 0))     /* check for at least one item */
+    error(E_NOITEMS);           /* and at least one transaction */
+  MSG(stderr, "\n");            /* compute absolute support value */
+  supp = ceilsupp((supp >= 0) ? 0.01 *supp *(double)w : -supp);
+  prep = (SUPP)supp;            /* note the preprocessing support */
+
+  /* --- sort and recode items --- */
+  t = clock();                  /* start timer, print log message */
+  MSG(stderr, "filtering, sorting and recoding items ... ");
+  m = tbg_recode(tabag, prep, -1, -1, sort);
+  if (m <  0) error(E_NOMEM);   /* recode items and transactions */
+  if (m <= 0) error(E_NOITEMS); /* and check the number of items */
+  MSG(stderr, "[%"ITEM_FMT" item(s)]", m);
+  MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+
+  /* --- sort and reduce transactions --- */
+  t = clock();                  /* start timer, print log message */
+  MSG(stderr, "sorting and reducing transactions ... ");
+  tbg_itsort(tabag, +1, 0);     /* sort items in transactions and */
+  tbg_sort  (tabag, +1, 0);     /* sort the trans. lexicographically */
+  n = tbg_reduce(tabag, 0);     /* reduce transactions to unique ones */
+  MSG(stderr, "[%"TID_FMT, n);  /* print number of transactions */
+  if (w != (SUPP)n) MSG(stderr, "/%"SUPP_FMT, w);
+  MSG(stderr, " transaction(s)] done [%.2fs].\n", SEC_SINCE(t));
+
+  /* --- create transaction tree --- */
+  if (tree) {                   /* if to use a transaction tree */
+    t = clock();                /* start timer, print log message */
+    MSG(stderr, "building transaction tree ... ");
+    tatree = tat_create(tabag); /* create a transaction tree */
+    if (!tatree) error(E_NOMEM);
+    MSG(stderr, "[%"SIZE_FMT" node(s), %"SIZE_FMT" byte(s)]",
+                tat_size(tatree), tat_bytes(tatree));
+    MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+  }                             /* (reused by all queries) */
+
+  /* --- answer queries --- */
+  #ifndef APR_NOSOCK            /* if to support sockets */
+  if (fn_sock) {                /* if a socket name is given */
+    signal(SIGPIPE, SIG_IGN);   /* clients may disconnect any time */
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;  /* build the socket address */
+    if (strlen(fn_sock) >= sizeof(addr.sun_path))
+      error(E_SOCKET, fn_sock); /* check the length of the name */
+    strcpy(addr.sun_path, fn_sock);
+    sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) error(E_SOCKET, fn_sock);
+    unlink(fn_sock);            /* remove an old socket file */
+    if ((bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+    ||  (listen(sock, 8) != 0)) {
+      close(sock); sock = -1; error(E_SOCKET, fn_sock); }
+    MSG(stderr, "listening on %s ...\n", fn_sock);
+    for (k = 0; !k; ) {         /* serve the clients one by one */
+      c = accept(sock, NULL, NULL);
+      if (c < 0) continue;      /* wait for the next client */
+      in  = fdopen(c, "r");     /* and create streams */
+      out = fdopen(dup(c), "w");/* for reading and writing */
+      if (in && out) k = serve(in, out);
+      if (out) fclose(out);     /* answer the queries */
+      if (in)  fclose(in);      /* of the client and */
+      else     close(c);        /* close the connection */
+    }
+    MSG(stderr, "server stopped.\n");
+  }
+  else                          /* if no socket name is given, */
+  #endif                        /* read queries from stdin */
+    serve(stdin, stdout);       /* and write answers to stdout */
+
+  /* --- clean up --- */
+  CLEANUP;                      /* clean up memory and close files */
+  SHOWMEM;                      /* show (final) memory usage */
+  return 0;                     /* return 'ok' */
+}  /* main() */
@@ -84,6 +84,16 @@
             2013.03.30 adapted to type changes in module tract
             2013.06.03 real-valued support made possible (SUPP==double)
             2013.10.15 checks of return code of isr_report() added
+            2026.10.19 compact (8/16/32 bit) support counters added
+            2026.10.19 parallel item set reporting added (TA_THREADS)
+            2026.10.19 log-factorial table set up for Fisher's exact test
+            2026.10.19 batch evaluation of all item sets in a node added
+            2026.10.19 function ist_rules() added (rules node by node)
+            2026.10.19 pruning with optimistic evaluation bounds added
+            2026.10.19 ist_filter() and ist_clomax() processed in parallel
+            2026.10.19 hash index for support queries added (ist_index())
+            2026.10.19 critical value of chi^2 based p-values precomputed
+            2026.10.19 generator filter: subset nodes found once per node
 ----------------------------------------------------------------------*/
 #include <stdio.h>
 #include <stdlib.h>
@@ -94,6 +104,9 @@
 #include "istree.h"
 #include "chi2.h"
 #include "gamma.h"
+#ifdef TA_THREADS
+#include <pthread.h>
+#endif
 #ifdef STORAGE
 #include "storage.h"
 #endif
@@ -109,12 +122,19 @@
 #ifndef INFINITY
 #define INFINITY    (DBL_MAX+DBL_MAX)
 #endif                          /* MSC still does not support C99 */
+#ifdef __GNUC__                 /* if GNU C compiler (or compatible) */
+#define PREFETCH(p) __builtin_prefetch(p)
+#else                           /* otherwise no prefetch instruction */
+#define PREFETCH(p)
+#endif
 
 /*----------------------------------------------------------------------
   Preprocessor Definitions
 ----------------------------------------------------------------------*/
 #define LN_2        0.69314718055994530942  /* ln(2) */
 #define BLKSIZE     32          /* block size for level array */
+#define SWPCNT      4096        /* min. number of counters per job */
+#define QRYBLK      16          /* number of queries per probe block */
 #define F_HDONLY    ITEM_MIN    /* flag for head only item in path */
 #define ITEMOF(n)   ((ITEM)((n)->item & ~F_HDONLY))
 #define HDONLY(n)   ((n)->item < 0)
@@ -143,13 +163,38 @@
 #define IS2SKIP(n)  ((n) < 0)
 #define COUNT(n)    ((n) &  ~F_SKIP)
 #define INC(n,w)    ((n) += (w))
+#ifndef IST_FULLCNT             /* if not to force full counters, */
+#define IST_CMPCNT              /* use compact counters if possible */
+#endif
 #endif
 #undef int                      /* remove preprocessor definitions */
 #undef long                     /* needed for the type checking */
 #undef double
+
+#ifdef IST_CMPCNT               /* if to use compact counters */
+#define CNTWDT(s)   cntwdt(s)
+#define CNTBYTES(n,w) ((((size_t)(n) *(size_t)(w)) +sizeof(SUPP)-1) \
+                      & ~(sizeof(SUPP)-1))
+#define GETCNT(n,i)      getcnt(n,i)
+#define SETCNT(n,i,s)    setcnt(n,i,s)
+#define INCCNT(n,i,w)    inccnt(n,i,w)
+#define SETSKIPAT(n,i)   skipcnt(n,i,1)
+#define CLRSKIPAT(n,i)   skipcnt(n,i,0)
+#else                           /* if to use only full counters */
+#define CNTWDT(s)   ((int)sizeof(SUPP))
+#define CNTBYTES(n,w) ((size_t)(n) *sizeof(SUPP))
+#define GETCNT(n,i)      ((n)->cnts[i])
+#define SETCNT(n,i,s)    ((n)->cnts[i] = (s))
+#define INCCNT(n,i,w)    INC((n)->cnts[i],w)
+#define SETSKIPAT(n,i)   SETSKIP((n)->cnts[i])
+#define CLRSKIPAT(n,i)   CLRSKIP((n)->cnts[i])
+#endif
+#define CNTSIZE(n)  CNTBYTES((n)->size, (n)->width)
+#define CNTEND(n)   ((void*)((char*)(n)->cnts +CNTSIZE(n)))
+#define ITEMMAP(n)  ((ITEM*)CNTEND(n))
 #define CHILDCNT(n) ((n)->chcnt & ~ITEM_MIN)
 #define ITEMAT(n,i) (((n)->offset >= 0) ? (n)->offset +(i) \
-                      : ((ITEM*)((n)->cnts +(n)->size))[i])
+                      : ITEMMAP(n)[i])
 
 #ifdef ALIGN8                   /* if aligned 64 bit architecture */
 #define PAD(p)      ((((size_t)(p) -1) & 7) ^ 7)
@@ -161,6 +206,157 @@
 /* Note that not all 64 bit architectures need pointers to be aligned */
 /* to addresses divisible by 8. Use ALIGN8 only if this is the case.  */
 
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef void NODEFN (ISTREE *ist, ISTNODE *node, int arg);
+
+#ifdef TA_THREADS
+typedef struct {                /* --- subtree reporting job --- */
+  ITEM     index;               /* index of the item in the root */
+                                /* (or number of nodes to process) */
+  SUPP     supp;                /* support of the item (with flag) */
+  ISTNODE  *node;               /* child node of the item (if any) */
+  ISREPORT *rep;                /* reporter (clone) that was used */
+  size_t   beg;                 /* start of the output section */
+  size_t   end;                 /* end   of the output section */
+} ISTJOB;                       /* (subtree reporting job) */
+
+struct istwork;                 /* --- parallel reporting data --- */
+
+typedef struct {                /* --- reporting thread data --- */
+  struct istwork *work;         /* parallel reporting data */
+  ISTREE   ist;                 /* copy of the tree (own path buffer) */
+  ISREPORT *rep;                /* clone of the item set reporter */
+  ISTNODE  **bnds;              /* body nodes for rule extraction */
+  int      err;                 /* error status */
+} ISTTHD;                       /* (reporting thread data) */
+
+typedef struct istwork {        /* --- parallel reporting data --- */
+  pthread_mutex_t lock;         /* lock for the job counter */
+  ISTJOB   *jobs;               /* subtree reporting jobs */
+  ITEM     cnt;                 /* number of jobs */
+  ITEM     next;                /* index of the next job to process */
+  NODEFN   *fn;                 /* function to process a node */
+  int      arg;                 /* argument of the node function */
+  ISTTHD   thds[TA_THREADS];    /* data of the reporting threads */
+} ISTWORK;                      /* (parallel reporting data) */
+#endif
+
+/*----------------------------------------------------------------------
+  Compact Counter Functions
+----------------------------------------------------------------------*/
+#ifdef IST_CMPCNT
+
+static int cntwdt (SUPP max)
+{                               /* --- get the width of counters */
+  if (max <= SCHAR_MAX) return (int)sizeof(signed char);
+  if (max <= SHRT_MAX)  return (int)sizeof(short);
+  if (max <= INT_MAX)   return (int)sizeof(int);
+  return (int)sizeof(SUPP);     /* return the smallest width */
+}  /* cntwdt() */               /* that can represent the maximum */
+
+/*--------------------------------------------------------------------*/
+
+static SUPP getcnt (const ISTNODE *node, ITEM i)
+{                               /* --- get a (compact) counter */
+  int c;                        /* buffer for a compact counter */
+
+  if (node->width >= (int)sizeof(SUPP))
+    return node->cnts[i];       /* return a full counter directly */
+  switch (node->width) {        /* evaluate the counter width */
+    case sizeof(signed char):
+      c = ((const signed char*)node->cnts)[i];
+      return (c < 0) ? (SUPP)(c & SCHAR_MAX) | F_SKIP : (SUPP)c;
+    case sizeof(short):
+      c = ((const short*)node->cnts)[i];
+      return (c < 0) ? (SUPP)(c & SHRT_MAX)  | F_SKIP : (SUPP)c;
+    default:
+      c = ((const int*)node->cnts)[i];
+      return (c < 0) ? (SUPP)(c & INT_MAX)   | F_SKIP : (SUPP)c;
+  }                             /* move the skip flag from the sign */
+}  /* getcnt() */               /* bit of the compact counter */
+
+/*--------------------------------------------------------------------*/
+
+static void setcnt (ISTNODE *node, ITEM i, SUPP s)
+{                               /* --- set a (compact) counter */
+  int c;                        /* buffer for a compact counter */
+
+  if (node->width >= (int)sizeof(SUPP)) {
+    node->cnts[i] = s; return; }/* store a full counter directly */
+  c = (int)COUNT(s);            /* get the counter value and */
+  switch (node->width) {        /* evaluate the counter width */
+    case sizeof(signed char):
+      ((signed char*)node->cnts)[i] =
+        (signed char)(IS2SKIP(s) ? c | SCHAR_MIN : c); break;
+    case sizeof(short):
+      ((short*)      node->cnts)[i] =
+        (short)      (IS2SKIP(s) ? c | SHRT_MIN  : c); break;
+    default:
+      ((int*)        node->cnts)[i] = IS2SKIP(s) ? c | INT_MIN : c;
+      break;                    /* store the counter value and */
+  }                             /* move the skip flag to the sign */
+}  /* setcnt() */               /* bit of the compact counter */
+
+/*--------------------------------------------------------------------*/
+
+static void inccnt (ISTNODE *node, ITEM i, SUPP w)
+{                               /* --- increment a (compact) counter */
+  signed char *b;               /* to access a  8 bit counter */
+  short       *h;               /* to access a 16 bit counter */
+
+  if (node->width >= (int)sizeof(SUPP)) {
+    node->cnts[i] += w; return; }   /* increment full counter */
+  switch (node->width) {        /* evaluate the counter width */
+    case sizeof(signed char):
+      b = (signed char*)node->cnts +i; *b = (signed char)(*b +w); break;
+    case sizeof(short):
+      h = (short*)      node->cnts +i; *h = (short)      (*h +w); break;
+    default:
+      ((int*)node->cnts)[i] += (int)w; break;
+  }                             /* the sign bit (skip flag) is kept, */
+}  /* inccnt() */               /* because the counters cannot overflow */
+
+/*--------------------------------------------------------------------*/
+
+static void skipcnt (ISTNODE *node, ITEM i, int set)
+{                               /* --- set/clear skip flag of counter */
+  signed char *b;               /* to access a  8 bit counter */
+  short       *h;               /* to access a 16 bit counter */
+  int         *c;               /* to access a 32 bit counter */
+
+  if (node->width >= (int)sizeof(SUPP)) {
+    if (set) SETSKIP(node->cnts[i]);
+    else     CLRSKIP(node->cnts[i]);
+    return;                     /* set or clear the skip flag */
+  }                             /* of a full counter directly */
+  switch (node->width) {        /* evaluate the counter width */
+    case sizeof(signed char):
+      b = (signed char*)node->cnts +i;
+      *b = (signed char)(set ? *b | SCHAR_MIN : *b & SCHAR_MAX); break;
+    case sizeof(short):
+      h = (short*)      node->cnts +i;
+      *h = (short)      (set ? *h | SHRT_MIN  : *h & SHRT_MAX);  break;
+    default:
+      c = (int*)        node->cnts +i;
+      *c =               set ? *c | INT_MIN   : *c & INT_MAX;    break;
+  }                             /* the skip flag is the sign bit */
+}  /* skipcnt() */              /* of a compact counter */
+
+/*----------------------------------------------------------------------
+  The counters of a node (except the root node) are stored with a width
+of 8, 16 or 32 bits (or the full width of the support type), which is
+chosen when the node is created. Since the counters of a node count
+supersets of the item set that is extended by the node, the support of
+this item set is an upper bound for all counter values and thus the
+counters can never overflow. The skip flag (F_SKIP) is represented by
+the sign bit of a compact counter and moved to the sign bit of the
+support type when a counter is read. As the counter arrays are padded
+to a multiple of the size of the support type, item identifier maps and
+child pointer arrays keep their alignment.
+----------------------------------------------------------------------*/
+#endif
 /*----------------------------------------------------------------------
   Auxiliary Functions
 ----------------------------------------------------------------------*/
@@ -214,12 +410,12 @@ static SUPP getsupp (ISTNODE *node, ITEM *items, ITEM n)
     k = CHILDCNT(node);         /* if there are no children, */
     if (k <= 0) return F_SKIP;  /* the support is less than minsupp */
     if (node->offset >= 0) {    /* if a pure array is used */
-      chn = (ISTNODE**)(node->cnts +node->size);
+      chn = (ISTNODE**)CNTEND(node);
       ALIGN(chn);               /* get the child array index */
       i = *items -ITEMOF(chn[0]);  /* compute the child array index */
       if (i >= k) return F_SKIP; } /* and check whether entry exists */
     else {                      /* if an identifier map is used */
-      chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
       ALIGN(chn);               /* get the child array index */
       i = search(*items, chn, k);
     }                           /* find the child array index */
@@ -232,11 +428,61 @@ static SUPP getsupp (ISTNODE *node, ITEM *items, ITEM n)
     i = *items -node->offset;   /* compute the counter index and */
     if (i >= k) return F_SKIP;} /* check whether counter exists */
   else                          /* if an identifier map is used */
-    i = ia_bsearch(*items, (ITEM*)(node->cnts +k), (size_t)k);
+    i = ia_bsearch(*items, ITEMMAP(node), (size_t)k);
   if (i < 0) return F_SKIP;     /* if no counter exists, abort */
-  return node->cnts[i];         /* return the item set support */
+  return GETCNT(node, i);       /* return the item set support */
 }  /* getsupp() */
 
+/*--------------------------------------------------------------------*/
+
+static ISTNODE* getnode (ISTNODE *node, const ITEM *items, ITEM n)
+{                               /* --- get the node of an item set */
+  ITEM    i, k;                 /* array indices, number of children */
+  ISTNODE **chn;                /* child node array */
+
+  assert(node                   /* check the function arguments */
+  &&    (n >= 0) && (items || (n <= 0)));
+  for ( ; --n >= 0; items++) {  /* follow the set/path from the node */
+    k = CHILDCNT(node);         /* if there are no children, */
+    if (k <= 0) return NULL;    /* the node does not exist */
+    if (node->offset >= 0) {    /* if a pure array is used */
+      chn = (ISTNODE**)CNTEND(node);
+      ALIGN(chn);               /* get the child array index */
+      i = *items -ITEMOF(chn[0]);  /* compute the child array index */
+      if (i >= k) return NULL; }   /* and check whether entry exists */
+    else {                      /* if an identifier map is used */
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
+      ALIGN(chn);               /* get the child array index */
+      i = search(*items, chn, k);
+    }                           /* find the child array index */
+    if (i < 0) return NULL;     /* if child does not exist, abort */
+    node = chn[i];              /* go to the corresponding child */
+    if (!node) return NULL;     /* if child does not exist, abort */
+  }
+  return node;                  /* return the item set node */
+}  /* getnode() */
+
+/* getnode(node, items, n) returns the node that getsupp() arrives */
+/* at with n+1 items, so that the supports of several item sets    */
+/* that differ only in the last item can be retrieved with getcnt- */
+/* item() without following the path again for each of them.      */
+
+/*--------------------------------------------------------------------*/
+
+static SUPP getcntitem (ISTNODE *node, ITEM item)
+{                               /* --- get the counter of an item */
+  ITEM i;                       /* counter index */
+
+  assert(node);                 /* check the function argument */
+  if (node->offset >= 0) {      /* if a pure array is used, */
+    i = item -node->offset;     /* compute the counter index and */
+    if (i >= node->size) return F_SKIP; }  /* check whether it exists */
+  else                          /* if an identifier map is used */
+    i = ia_bsearch(item, ITEMMAP(node), (size_t)node->size);
+  if (i < 0) return F_SKIP;     /* if no counter exists, abort */
+  return GETCNT(node, i);       /* return the item set support */
+}  /* getcntitem() */
+
 /*----------------------------------------------------------------------
   Counting Functions
 ----------------------------------------------------------------------*/
@@ -258,10 +504,10 @@ static void count (ISTNODE *node,
       while (--n >= 0) {        /* traverse the transaction's items */
         i = *items++ -o;        /* compute the counter array index */
         if (i >= node->size) return;
-        INC(node->cnts[i],wgt); /* if the corresp. counter exists, */
+        INCCNT(node, i, wgt);   /* if the corresp. counter exists, */
       } }                       /* add the transaction weight to it */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISTNODE**)(node->cnts +node->size);
+      chn = (ISTNODE**)CNTEND(node);
       ALIGN(chn);               /* get the child node array and */
       o   = ITEMOF(chn[0]);     /* the item of the first child */
       while ((n >= min) && (*items < o)) {
@@ -274,7 +520,7 @@ static void count (ISTNODE *node,
     } }                         /* count the transaction recursively */
   else {                        /* if an identifer map is used */
     if (node->chcnt == 0) {     /* if this is a new node (leaf) */
-      map = (ITEM*)(node->cnts +(k = node->size));
+      map = ITEMMAP(node); k = node->size;
       o   = map[0];             /* get the identifier map */
       while ((n > 0) && (*items < o)) {
         n--; items++; }         /* skip items before first counter */
@@ -283,14 +529,14 @@ static void count (ISTNODE *node,
         if (*items > o) return; /* if beyond last item, abort */
         #ifdef IST_BSEARCH      /* if to use a binary search */
         i = ia_bsearch(*items, map, (size_t)k);
-        if (i >= 0)           INC(node->cnts[i], wgt);
+        if (i >= 0)           INCCNT(node, i, wgt);
         #else                   /* if to use a linear search */
         while (map[i] < *items) i++;
-        if (map[i] == *items) INC(node->cnts[i], wgt);
+        if (map[i] == *items) INCCNT(node, i, wgt);
         #endif                  /* if the corresp. counter exists, */
       } }                       /* add the transaction weight to it */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
       ALIGN(chn);               /* get the child node array and */
       o   = ITEMOF(chn[0]);     /* the index of the first child */
       while ((n >= min) && (*items < o)) {
@@ -338,10 +584,10 @@ static void countx (ISTNODE *node, const TANODE *tan, ITEM min)
       for (cld = tan_children(tan); cld; cld = tan_sibling(cld)) {
         i = tan_item(cld) -o;   /* traverse the child items */
         if (i < 0) return;      /* if before first item, abort */
-        if (i < node->size) INC(node->cnts[i], tan_wgt(cld));
+        if (i < node->size) INCCNT(node, i, tan_wgt(cld));
       } }                       /* otherwise add the trans. weight */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISTNODE**)(node->cnts +node->size);
+      chn = (ISTNODE**)CNTEND(node);
       ALIGN(chn);               /* get the child node array and */
       o   = ITEMOF(chn[0]);     /* the item of the first child */
       --min;                    /* traverse the child nodes */
@@ -353,22 +599,22 @@ static void countx (ISTNODE *node, const TANODE *tan, ITEM min)
     } }                         /* count the trans. tree recursively */
   else {                        /* if an identifer map is used */
     if (node->chcnt == 0) {     /* if this is a new node (leaf) */
-      map = (ITEM*)(node->cnts +(k = node->size));
+      map = ITEMMAP(node); k = node->size;
       o   = map[0];             /* get the item identifier map */
       for (cld = tan_children(tan); cld; cld = tan_sibling(cld)) {
         item = tan_item(cld);   /* traverse the child items */
         if (item < o) return;   /* if before the first item, return */
         #ifdef IST_BSEARCH      /* if to use a binary search */
         i = ia_bsearch(item, map, (size_t)k);
-        if (i >= 0) { k = i; INC(node->cnts[k], tan_wgt(cld)); }
+        if (i >= 0) { k = i; INCCNT(node, k, tan_wgt(cld)); }
         #else                   /* if to use a linear search */
         while (map[--k] > item);
-        if (map[k] == item)  INC(node->cnts[k], tan_wgt(cld));
+        if (map[k] == item)  INCCNT(node, k, tan_wgt(cld));
         else k++;               /* if the corresp. counter exists, */
         #endif                  /* add the transaction weight to it, */
       } }                       /* otherwise adapt the map index */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
       ALIGN(chn);               /* get the child node array, */
       k   = node->chcnt;        /* the number of children, and */
       o   = ITEMOF(chn[0]);     /* the last item with a child */
@@ -416,10 +662,10 @@ static void countx (ISTNODE *node, const TANODE *tan, ITEM min)
         i = tan_item(tan, n)-o; /* traverse the node's items */
         if (i < 0) return;      /* if before the first item, abort */
         if (i < node->size)     /* if the corresp. counter exists */
-          INC(node->cnts[i], tan_wgt(tan_child(tan, n)));
+          INCCNT(node, i, tan_wgt(tan_child(tan, n)));
       } }                       /* add the transaction weight to it */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISTNODE**)(node->cnts +node->size);
+      chn = (ISTNODE**)CNTEND(node);
       ALIGN(chn);               /* get the child node array and */
       o   = ITEMOF(chn[0]);     /* the item of the first child */
       for (--min, n = tan_size(tan); --n >= 0; ) {
@@ -431,22 +677,22 @@ static void countx (ISTNODE *node, const TANODE *tan, ITEM min)
     } }                         /* count the trans. tree recursively */
   else {                        /* if an identifer map is used */
     if (node->chcnt == 0) {     /* if this is a new node (leaf) */
-      map = (ITEM*)(node->cnts +(k = node->size));
+      map = ITEMMAP(node); k = node->size;
       o   = map[0];             /* get the item identifier map */
       for (n = tan_size(tan); --n >= 0; ) {
         item = tan_item(tan,n); /* traverse the node's items */
         if (item < o) return;   /* if before the first item, abort */
         #ifdef IST_BSEARCH      /* if to use a binary search */
         i = ia_bsearch(item, map, (size_t)k);
-        if (i >= 0) {k = i; INC(node->cnts[k],tan_wgt(tan_child(tan,n)));}
+        if (i >= 0) {k = i; INCCNT(node, k, tan_wgt(tan_child(tan,n)));}
         #else                   /* if to use a linear search */
         while (map[--k] > item);
-        if (map[k] == item) INC(node->cnts[k],tan_wgt(tan_child(tan,n)));
+        if (map[k] == item) INCCNT(node, k, tan_wgt(tan_child(tan,n)));
         else k++;               /* if the corresp. counter exists, */
         #endif                  /* add the transaction weight to it, */
       } }                       /* otherwise adapt the map index */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
       ALIGN(chn);               /* get the child node array, */
       k   = node->chcnt;        /* the number of children, and */
       o   = ITEMOF(chn[0]);     /* the last item with a child */
@@ -487,14 +733,13 @@ static double ld_ratio (ISTREE *ist, ISTNODE *node, ITEM index)
   for (sum = 0, curr = node; curr->parent; curr = curr->parent)
     sum += logn -log((double)COUNT(cnts[ITEMOF(curr)]));
   val = sum                     /* compute log. of probability ratio */
-      + log((double)COUNT(node->cnts[index]))
+      + log((double)COUNT(GETCNT(node, index)))
       - log((double)COUNT(cnts[ITEMAT(node, index)]));
   if (ist->minimp > -INFINITY){ /* if minimum improvement required */
     curr = node->parent; i = ITEMOF(node);
     i = (curr->offset >= 0) ? i -curr->offset
-      : ia_bsearch(i, (ITEM*)(curr->cnts +curr->size),
-                      (size_t)curr->size);
-    sum += log((double)COUNT(curr->cnts[i])) -logn;
+      : ia_bsearch(i, ITEMMAP(curr), (size_t)curr->size);
+    sum += log((double)COUNT(GETCNT(curr, i))) -logn;
     if ((val-sum) /LN_2 < ist->minimp) return -INFINITY;
   }                             /* compute and compare subset eval. */
   return val /LN_2;             /* return the computed evaluation */
@@ -502,6 +747,20 @@ static double ld_ratio (ISTREE *ist, ISTNODE *node, ITEM index)
 
 /*--------------------------------------------------------------------*/
 
+static double ruleval (ISTREE *ist, RULEVALFN *refn,
+                       SUPP supp, SUPP body, SUPP head, SUPP base)
+{                               /* --- evaluate a single rule */
+  if (ist->invbxs               /* if to invalidate below expectation */
+  && ((double)supp *(double)base <= (double)head *(double)body))
+    return (ist->dir < 0) ? 1 : 0;
+  return (ist->crit > 0)        /* if a critical value is known, */
+       ? re_pcut(ist->eval, supp, body, head, base, ist->crit, ist->fetc)
+       : (ist->fetc) ? re_eval(ist->eval, supp, body, head, base, ist->fetc)
+       : refn(supp, body, head, base);
+}  /* ruleval() */              /* compute p-value only if needed */
+
+/*--------------------------------------------------------------------*/
+
 static double evaluate (ISTREE *ist, ISTNODE *node, ITEM index)
 {                               /* --- average rule confidence */
   ITEM      i, n;               /* loop variable, buffer */
@@ -530,10 +789,9 @@ static double evaluate (ISTREE *ist, ISTNODE *node, ITEM index)
   else {                        /* if an item identifier is given, */
     item  = index & ~ITEM_MIN;  /* remove the item identifier flag */
     index = (node->offset >= 0) ? item -node->offset
-      : ia_bsearch(item, (ITEM*)(node->cnts +node->size),
-                         (size_t)node->size);
+      : ia_bsearch(item, ITEMMAP(node), (size_t)node->size);
   }                             /* determine the item index */
-  supp = COUNT(node->cnts[index]);
+  supp = COUNT(GETCNT(node, index));
   base = COUNT(ist->wgt);       /* get item set and base support */
   refn = re_function(ist->eval);/* get the evaluation function */
   if (ist->agg == IST_EQS) {    /* if to split into equal size sets */
@@ -547,24 +805,19 @@ static double evaluate (ISTREE *ist, ISTNODE *node, ITEM index)
     }                           /* no more than half of the items */
     curr = node->parent;        /* get the index in the parent node */
     i = (curr->offset >= 0) ? ITEMOF(node) -curr->offset
-      : ia_bsearch(ITEMOF(node), (ITEM*)(curr->cnts +curr->size),
-                                 (size_t)curr->size);
-    body = COUNT(curr->cnts[i]);/* get body and head support of split */
+      : ia_bsearch(ITEMOF(node), ITEMMAP(curr), (size_t)curr->size);
+    body = COUNT(GETCNT(curr,i)); /* get body and head support of split */
     head = COUNT(getsupp(ist->lvls[0], path, n));
-    return (!ist->invbxs        /* compute and return evaluation */
-    || ((double)supp *(double)base > (double)head *(double)body))
-    ? refn(supp, body, head, base) : (ist->dir < 0) ? 1 : 0;
+    return ruleval(ist, refn, supp, body, head, base);
   }
   head = COUNT(ist->lvls[0]->cnts[item]);
   if (curr->offset >= 0)        /* if a pure array is used */
-    body = COUNT(curr->cnts[ITEMOF(node) -curr->offset]);
+    body = COUNT(GETCNT(curr, ITEMOF(node) -curr->offset));
   else {                        /* if an identifier map is used */
-    path = (ITEM*)(curr->cnts +(n = curr->size));
-    body = COUNT(curr->cnts[ia_bsearch(ITEMOF(node), path, (size_t)n)]);
+    path = ITEMMAP(curr); n = curr->size;
+    body = COUNT(GETCNT(curr, ia_bsearch(ITEMOF(node), path, (size_t)n)));
   }                             /* find index and get body support */
-  sum = (!ist->invbxs           /* compute the first measure value */
-     || ((double)supp *(double)base > (double)head *(double)body))
-      ? refn(supp, body, head, base) : (ist->dir < 0) ? 1 : 0;
+  sum = ruleval(ist, refn, supp, body, head, base);
   if (ist->agg <= IST_FIRST) {  /* if to return the first value */
     if ((ist->minimp <= -INFINITY) || rec)
       return sum;               /* check whether to return it */
@@ -577,9 +830,7 @@ static double evaluate (ISTREE *ist, ISTNODE *node, ITEM index)
   for (i = 0; curr; curr = curr->parent) {
     head = COUNT(ist->lvls[0]->cnts[item]);
     body = COUNT(getsupp(curr, path, n));
-    val  = (!ist->invbxs        /* compute next measure value */
-        || ((double)supp *(double)base > (double)head *(double)body))
-         ? refn(supp, body, head, base) : (ist->dir < 0) ? 1 : 0;
+    val  = ruleval(ist, refn, supp, body, head, base);
     if      (ist->agg == IST_MIN) {
       if       (val <  sum)                { sum = val; i = n; }
       else if ((val == sum) && (body > b)) { b = body;  i = n; } }
@@ -600,11 +851,11 @@ static double evaluate (ISTREE *ist, ISTNODE *node, ITEM index)
     while (--i > 0) curr = curr->parent;
     while (--n > 0) {           /* follow the set/path from the node */
       if (curr->offset >= 0) {  /* if a pure counter array is used */
-        chn = (ISTNODE**)(curr->cnts +curr->size);
+        chn = (ISTNODE**)CNTEND(curr);
         ALIGN(chn);             /* get the child node array */
         i   = *path++ -ITEMOF(chn[0]); }   /* compute the index */
       else {                    /* if an identifier map is used */
-        chn = (ISTNODE**)((ITEM*)(curr->cnts +curr->size) +curr->size);
+        chn = (ISTNODE**)(ITEMMAP(curr) +curr->size);
         ALIGN(chn);             /* get the child node array */
         i   = search(*path++, chn, CHILDCNT(curr));
       }                         /* search for the proper index */
@@ -616,6 +867,48 @@ static double evaluate (ISTREE *ist, ISTNODE *node, ITEM index)
   return sum;                   /* return the measure aggregate */
 }  /* evaluate() */
 
+/*--------------------------------------------------------------------*/
+
+static double* evalnode (ISTREE *ist, ISTNODE *node)
+{                               /* --- evaluate all sets in a node */
+  ITEM    i, k;                 /* loop variable, index in parent */
+  SUPP    body, base;           /* body and base support */
+  SUPP    *supp, *head, *bdy;   /* support arrays for the batch */
+  ISTNODE *curr;                /* parent of the given node */
+
+  assert(ist && node);          /* check the function arguments */
+  if (!ist->vals                /* check for a batch buffer and */
+  ||  (ist->eval <= IST_NONE) || (ist->eval >= IST_LDRATIO)
+  ||  (ist->agg  >  IST_FIRST)  /* for a simple evaluation (no agg., */
+  ||  (ist->minimp > -INFINITY) /* no minimal improvement) */
+  ||  !(curr = node->parent))   /* of a node other than the root */
+    return NULL;                /* (otherwise use evaluate()) */
+  k = ITEMOF(node);             /* get the index in the parent */
+  k = (curr->offset >= 0) ? k -curr->offset
+    : ia_bsearch(k, ITEMMAP(curr), (size_t)curr->size);
+  body = COUNT(GETCNT(curr, k));/* get the body support */
+  base = COUNT(ist->wgt);       /* and the base support */
+  supp = ist->sups; head = supp +node->size; bdy = head +node->size;
+  for (i = 0; i < node->size; i++) {
+    supp[i] = COUNT(GETCNT(node, i));
+    head[i] = COUNT(ist->lvls[0]->cnts[ITEMAT(node, i)]);
+    bdy [i] = body;             /* gather the support triples */
+  }                             /* of all item sets in the node */
+  if (ist->crit > 0)            /* if a critical value is known, */
+    for (i = 0; i < node->size; i++)  /* compare the statistics */
+      ist->vals[i] = re_pcut(ist->eval, supp[i], body, head[i], base,
+                             ist->crit, ist->fetc);
+  else                          /* otherwise evaluate the whole node */
+    re_eval_batch(ist->eval, supp, bdy, head, base,
+                  ist->vals, (size_t)node->size, ist->fetc);
+  if (ist->invbxs) {            /* if to invalidate below expectation */
+    for (i = 0; i < node->size; i++)
+      if ((double)supp[i] *(double)base <= (double)head[i] *(double)body)
+        ist->vals[i] = (ist->dir < 0) ? 1 : 0;
+  }                             /* replace the measure values */
+  return ist->vals;             /* return the measure values */
+}  /* evalnode() */
+
 /*----------------------------------------------------------------------
   Main Functions
 ----------------------------------------------------------------------*/
@@ -646,6 +939,11 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
                         +(size_t)(cnt-1) *sizeof(SUPP));
   if (!root)      { free(ist->map);  free(ist->buf);
                     free(ist->lvls); free(ist); return NULL; }
+  ist->vals = NULL; ist->sups = NULL; /* (created in ist_seteval()) */
+  ist->fetc = NULL;             /* (created in ist_seteval()) */
+  ist->hash = NULL; ist->hmsk = 0;    /* (created in ist_index()) */
+  ist->crit = 0;                /* (computed in ist_seteval()) */
+  ist->bound = 0;               /* no pruning with eval. bounds yet */
 
   /* --- initialize structures --- */
   ist->base   = base;           /* copy parameters to the structure */
@@ -668,6 +966,7 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
   ist->ndcnt  = 1;   ist->ndprn = ist->mapsz = 0;
   ist->sccnt  = ist->scnec = cnt; ist->scprn = 0;
   ist->cpcnt  = ist->cpnec =      ist->cpprn = 0;
+  ist->cbcnt  = ist->cbfull = (size_t)cnt *sizeof(SUPP);
   #endif                        /* initialize the benchmark variables */
   ist_setsize(ist, 1, 1, 1);    /* init. the extraction variables */
   ist_seteval(ist, IST_NONE, IST_NONE, 1, -INFINITY, ITEM_MAX);
@@ -675,6 +974,7 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
   root->parent = root->succ  = NULL;
   root->offset = root->chcnt = root->item = 0;
   root->size   = cnt;           /* initialize the root node */
+  root->width  = (int)sizeof(SUPP);  /* with full counters */
   while (--cnt >= 0)            /* copy the item frequencies */
     root->cnts[cnt] = ib_getfrq(base, cnt);
   return ist;                   /* return created item set tree */
@@ -694,6 +994,9 @@ void ist_delete (ISTREE *ist)
   }                             /* delete all nodes, */
   free(ist->lvls);              /* the level array, */
   free(ist->map);               /* the identifier map, */
+  if (ist->vals) free(ist->vals);  /* the batch buffer, */
+  if (ist->fetc) re_fetdelete(ist->fetc); /* the log-factorials, */
+  if (ist->hash) free(ist->hash);  /* the hash index, */
   free(ist->buf);               /* the path buffer, */
   free(ist);                    /* and the tree body */
 }  /* ist_delete() */
@@ -753,15 +1056,19 @@ void ist_commit (ISTREE *ist)
 {                               /* --- commit transaction counting */
   ITEM    i;                    /* loop variable, counter index */
   ISTNODE *node;                /* to traverse the nodes */
+  double  *vals;                /* measure values of a node */
 
   assert(ist);                  /* check the function argument */
   if ((ist->eval   >  IST_NONE) /* if to prune with evaluation */
   &&  (ist->height >= ist->prune)) {
-    for (node = ist->lvls[ist->height-1]; node; node = node->succ)
+    for (node = ist->lvls[ist->height-1]; node; node = node->succ) {
+      vals = evalnode(ist, node);
       for (i = node->size; --i >= 0; )
-        if ((node->cnts[i] < ist->supp)
-        ||  (ist->dir *evaluate(ist, node, i) < ist->thresh))
-          SETSKIP(node->cnts[i]);
+        if ((GETCNT(node, i) < ist->supp)
+        ||  (ist->dir *((vals) ? vals[i] : evaluate(ist, node, i))
+                                < ist->thresh))
+          SETSKIPAT(node, i);
+    }                           /* evaluate the sets of each node */
   }                             /* mark sets that do not qualify */
 }  /* ist_commit() */
 
@@ -779,24 +1086,24 @@ static int used (ISTNODE *node, int *marks, SUPP supp)
     if (node->chcnt == 0) {     /* if this is a new node (leaf) */
       k = node->offset;         /* get the index offset */
       for (i = node->size; --i >= 0; ) {
-        if (node->cnts[i] >= supp)
+        if (GETCNT(node, i) >= supp)
           marks[k+i] = r = 1;   /* mark items in set that satisfy */
       } }                       /* the minimum support criterion */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISTNODE**)(node->cnts +node->size);
+      chn = (ISTNODE**)CNTEND(node);
       ALIGN(chn);               /* get the child node array */
       for (i = node->chcnt; --i >= 0; )
         if (chn[i]) r |= used(chn[i], marks, supp);
     } }                         /* recursively process all children */
   else {                        /* if an identifer map is used */
     if (node->chcnt == 0) {     /* if this is a new node */
-      map = (ITEM*)(node->cnts +node->size);
+      map = ITEMMAP(node);
       for (i = node->size; --i >= 0; ) {
-        if (node->cnts[i] >= supp)
+        if (GETCNT(node, i) >= supp)
           marks[map[i]] = r = 1;/* mark items in set that satisfies */
       } }                       /* the minimum support criterion */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
       ALIGN(chn);               /* get the child node array */
       for (i = node->chcnt; --i >= 0; )
         r |= used(chn[i], marks, supp);
@@ -827,23 +1134,29 @@ ITEM ist_check (ISTREE *ist, int *marks)
 void ist_prune (ISTREE *ist)
 {                               /* --- prune counters and pointers */
   ITEM    i, k, n;              /* loop variables */
-  SUPP    *c;                   /* counter array */
+  size_t  w;                    /* width of the counters */
   ITEM    *map;                 /* item identifier map */
   ISTNODE **np, *node;          /* to traverse the nodes */
   ISTNODE **chn;                /* child node array */
 
   assert(ist);                  /* check the function argument */
+  if (ist->hash) {              /* if there is a hash index, */
+    free(ist->hash); ist->hash = NULL; }  /* delete it */
   if (ist->height <= 1)         /* if there is only the root node, */
     return;                     /* there is nothing to prune */
 
   /* -- prune counters for infrequent items -- */
   for (node = ist->lvls[ist->height-1]; node; node = node->succ) {
-    c = node->cnts;             /* traverse the deepest level */
+    w = (size_t)node->width;    /* traverse the deepest level */
+    #ifdef BENCH                /* if benchmark version, */
+    ist->cbcnt  -= CNTSIZE(node);     /* remove counter memory */
+    ist->cbfull -= (size_t)node->size *sizeof(SUPP);
+    #endif
     if (node->offset >= 0) {    /* if a pure array is used */
-      for (n = node->size; --n >= 0; ) /* find the last */
-        if (c[n] >= ist->supp) break;  /* frequent item */
-      for (i = 0; i < n; i++)          /* find the first */
-        if (c[i] >= ist->supp) break;  /* frequent item  */
+      for (n = node->size; --n >= 0; )   /* find the last */
+        if (GETCNT(node,n) >= ist->supp) break;   /* frequent item */
+      for (i = 0; i < n; i++)            /* find the first */
+        if (GETCNT(node,i) >= ist->supp) break;   /* frequent item */
       node->size = ++n-i;       /* set the new node size */
       #ifdef BENCH              /* if benchmark version */
       k = node->size -(n-i);    /* get the number of pruned counters */
@@ -852,32 +1165,38 @@ void ist_prune (ISTREE *ist)
       #endif                    /* update the memory usage */
       if (i > 0) {              /* if there are leading infreq. items */
         node->offset += i;      /* set the new item offset */
-        memmove(c, c+i, (size_t)n *sizeof(SUPP));
+        memmove(node->cnts, (char*)node->cnts +(size_t)i *w,
+                (size_t)node->size *w);
       } }                       /* trim infrequent item from front */
     else {                      /* if an identifier map is used */
-      map = (ITEM*)(c +node->size); /* get the item identifier map */
+      map = ITEMMAP(node);      /* get the item identifier map */
       for (i = n = 0; i < node->size; i++) {
-        if (c[i] >= ist->supp) {
-          c[n] = c[i]; map[n++] = map[i]; }
+        if (GETCNT(node, i) >= ist->supp) {
+          SETCNT(node, n, GETCNT(node, i)); map[n++] = map[i]; }
       }                         /* remove infrequent items */
       k = node->size -n;        /* get the number of pruned counters */
-      if (k <= 0) continue;     /* if no items were pruned, continue */
-      #ifdef BENCH              /* if benchmark version, */
-      ist->sccnt -= k;          /* update the number of counters */
-      ist->scprn += k;          /* and of pruned counters */
-      ist->mapsz -= k;          /* update the total item map size */
-      #endif
-      node->size = n;           /* set the new node size */
-      memmove(c+n, map, (size_t)n *sizeof(ITEM));
-    }                           /* move the item identifier map */
-  }                             /* after the support counters */
+      if (k > 0) {              /* if some items were pruned */
+        #ifdef BENCH            /* if benchmark version, */
+        ist->sccnt -= k;        /* update the number of counters */
+        ist->scprn += k;        /* and of pruned counters */
+        ist->mapsz -= k;        /* update the total item map size */
+        #endif
+        node->size = n;         /* set the new node size */
+        memmove(ITEMMAP(node), map, (size_t)n *sizeof(ITEM));
+      }                         /* move the item identifier map */
+    }                           /* after the support counters */
+    #ifdef BENCH                /* if benchmark version, */
+    ist->cbcnt  += CNTSIZE(node);     /* add new counter memory */
+    ist->cbfull += (size_t)node->size *sizeof(SUPP);
+    #endif
+  }
 
   /* -- prune pointers to empty children -- */
   for (node = ist->lvls[ist->height-2]; node; node = node->succ) {
     n = CHILDCNT(node);         /* traverse the parent nodes */
     if (n <= 0) continue;       /* skip childless nodes */
     if (node->offset >= 0) {    /* if a pure array is used */
-      chn = (ISTNODE**)(node->cnts +node->size);
+      chn = (ISTNODE**)CNTEND(node);
       ALIGN(chn);               /* get the child node array */
       while (--n >= 0)          /* find the last  non-empty child */
         if (chn[n] && (chn[n]->size > 0)) break;
@@ -892,7 +1211,7 @@ void ist_prune (ISTREE *ist)
       for (k = 0; i < n; i++)   /* remove all empty children */
         chn[k++] = (chn[i] && (chn[i]->size > 0)) ? chn[i] : NULL; }
     else {                      /* if an item identifier map is used */
-      chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
       ALIGN(chn);               /* get the child node array */
       for (i = k = 0; i < n; i++)
         if (chn[i]->size > 0)   /* collect the child nodes */
@@ -930,13 +1249,16 @@ static ISTNODE* child (ISTREE *ist, ISTNODE *node, ITEM index, SUPP pex)
   int     body;                 /* enough support for a rule body */
   int     hdonly;               /* whether head only item on path */
   int     app;                  /* appearance flags of an item */
+  int     w;                    /* width of the counters */
   SUPP    supp;                 /* support of an item set */
+  SUPP    sset, cap;            /* support of set to extend, bound */
 
   assert(ist && node            /* check the function arguments */
   &&    (index >= 0) && (index < node->size));
 
   /* --- initialize --- */
-  supp = node->cnts[index];     /* get support of item set to extend */
+  supp = GETCNT(node, index);   /* get support of item set to extend */
+  sset = COUNT(supp);           /* (as an upper bound for extensions) */
   if ((supp <  ist->supp)       /* if the support is insufficient */
   ||  (supp >= pex))            /* or item is a perfect extension, */
     return NULL;                /* abort (do not create a child) */
@@ -956,13 +1278,14 @@ static ISTNODE* child (ISTREE *ist, ISTNODE *node, ITEM index, SUPP pex)
     app = ib_getapp(ist->base, k);
     if ((app == APP_NONE) || (hdonly && (app == APP_HEAD)))
       continue;                 /* skip sets with two head only items */
-    supp = node->cnts[i];       /* traverse the candidate items */
+    supp = GETCNT(node, i);     /* traverse the candidate items */
     if ((supp <  ist->supp)     /* if set support is insufficient */
     ||  (supp >= pex))          /* or item is a perfect extension, */
       continue;                 /* ignore the corresponding candidate */
     body &= 1;                  /* restrict body flags to set support */
     if (supp >= ist->rule)      /* if set support is sufficient for */
       body |= 2;                /* a rule body, set the body flag */
+    cap = (COUNT(supp) < sset) ? COUNT(supp) : sset;
     set    = ist->buf +ist->maxht -(n = 2);
     set[1] = k;                 /* add the candidate item to the set */
     for (curr = node; curr->parent; curr = curr->parent) {
@@ -971,12 +1294,20 @@ static ISTNODE* child (ISTREE *ist, ISTNODE *node, ITEM index, SUPP pex)
         break;                  /* if it is too low, abort loop */
       if (supp >= ist->rule)    /* if some subset has enough support */
         body |= 4;              /* for a rule body, set the body flag */
+      if (COUNT(supp) < cap) cap = COUNT(supp);
       *--set = ITEMOF(curr);    /* add id of current node to the set */
       ++n;                      /* and adapt the number of items */
-    }
-    if (!curr->parent && body)  /* if subset support is high enough */
-      ist->map[m++] = k;        /* for a full rule and a rule body, */
-  }                             /* note the item identifier */
+    }                           /* (cap: bound for the new support) */
+    if (curr->parent || !body)  /* if some subset support is too low */
+      continue;                 /* for a full rule or a rule body, */
+    if (ist->bound              /* or if no superset of the new set */
+    &&  (ist->dir *re_bound(ist->eval, cap,  /* can reach the eval. */
+                            ist->sups[(ist->bound > 1) ? index : i],
+                            COUNT(ist->wgt), ist->invbxs, ist->fetc)
+                  < ist->thresh))
+      continue;                 /* threshold, skip the candidate, */
+    ist->map[m++] = k;          /* otherwise note the item identifier */
+  }
   if (m <= 0) return NULL;      /* if no child is needed, abort */
   #ifdef BENCH                  /* if benchmark version, */
   ist->scnec += m;              /* sum the necessary counters */
@@ -992,21 +1323,27 @@ static ISTNODE* child (ISTREE *ist, ISTNODE *node, ITEM index, SUPP pex)
   #endif
 
   /* --- create child --- */
-  curr = (ISTNODE*)malloc(sizeof(ISTNODE) +(size_t)(n-1) *sizeof(SUPP)
-                                          +(size_t) k    *sizeof(ITEM));
+  w    = CNTWDT(COUNT(GETCNT(node, index)));
+  #ifdef BENCH                  /* get the width of the counters */
+  ist->cbcnt  += CNTBYTES(n, w);/* sum the counter memory */
+  ist->cbfull += (size_t)n *sizeof(SUPP);
+  #endif                        /* (compact and with full counters) */
+  curr = (ISTNODE*)malloc(sizeof(ISTNODE) -sizeof(SUPP)
+                         +CNTBYTES(n, w) +(size_t)k *sizeof(ITEM));
   if (!curr) return (ISTNODE*)-1;      /* create a child node */
   if (hdonly) item |= F_HDONLY; /* set the head only flag and */
   curr->item  = item;           /* initialize the item identifier */
   curr->chcnt = 0;              /* there are no children yet */
   curr->size  = n;              /* set size of counter array */
+  curr->width = w;              /* and the width of the counters */
   if (k <= 0) {                 /* if to use a pure array, note */
     curr->offset = k = ist->map[0];  /* first item as an offset */
-    for (i = 0; i < n; i++) curr->cnts[i] = F_SKIP;
-    for (i = 0; i < m; i++) curr->cnts[ist->map[i]-k] = 0; }
+    for (i = 0; i < n; i++) SETCNT(curr, i, F_SKIP);
+    for (i = 0; i < m; i++) SETCNT(curr, ist->map[i]-k, 0); }
   else {                        /* if to use an identifier map, */
     curr->offset = -1;          /* use negative offset as indicator */
-    memset(curr->cnts,    0,        (size_t)n *sizeof(SUPP));
-    memcpy(curr->cnts +n, ist->map, (size_t)n *sizeof(ITEM));
+    memset(curr->cnts,    0,        CNTSIZE(curr));
+    memcpy(ITEMMAP(curr), ist->map, (size_t)n *sizeof(ITEM));
   }                             /* clear counters, copy item id. map */
   return curr;                  /* return pointer to created child */
 }  /* child() */
@@ -1049,6 +1386,13 @@ contained in a set, neither can a rule be formed from its items nor
 can it be the antecedent of a rule. Whether a set contains two head
 only items is determined from the nodes 'hdonly' flag and the
 appearance flags of the items.
+  Finally, if an evaluation measure is used to filter the item sets
+or rules (ist->bound), a candidate is skipped if no item set that
+contains the extended set can reach the evaluation threshold. The
+support of such an item set is at most the minimum of the supports of
+the subsets checked above (cap) and the heads of its rules are among
+the items with the minimal supports collected by heads(), so that
+re_bound() yields the best value any of these rules can have.
 ----------------------------------------------------------------------*/
 
 static int needed (ISTNODE *node)
@@ -1061,7 +1405,7 @@ static int needed (ISTNODE *node)
   if (node->chcnt <= 0)         /* skip already marked subtrees, */
     return (node->chcnt == 0) ? -1 : 0;    /* but not new leaves */
   i   = (node->offset < 0) ? node->size : 0;
-  chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +i);
+  chn = (ISTNODE**)(ITEMMAP(node) +i);
   ALIGN(chn);                   /* get the child node array */
   for (r = 0, i = node->chcnt; --i >= 0; )
     if (chn[i]) r |= needed(chn[i]);
@@ -1086,6 +1430,38 @@ static void cleanup (ISTREE *ist)
 
 /*--------------------------------------------------------------------*/
 
+static void heads (ISTREE *ist, ISTNODE *node)
+{                               /* --- get minimal head supports */
+  ITEM    i, item;              /* loop variable, item identifier */
+  SUPP    s, min = SUPP_MAX;    /* (minimal) item support */
+  SUPP    *cnts;                /* array of item frequencies */
+  ISTNODE *curr;                /* to traverse the path to the root */
+
+  assert(ist && node && ist->sups);  /* check the function args. */
+  cnts = ist->lvls[0]->cnts;    /* get the item support values */
+  if (ist->bound > 1) {         /* if any item of a set can be a head */
+    for (curr = node; curr->parent; curr = curr->parent) {
+      item = ITEMOF(curr);      /* traverse the items on the path */
+      if (!(ib_getapp(ist->base, item) & APP_HEAD)) continue;
+      s = COUNT(cnts[item]); if (s < min) min = s;
+    }                           /* find the minimal support */
+  }                             /* of the head items on the path */
+  for (i = node->size; --i >= 0; ) {
+    item = ITEMAT(node, i);     /* traverse the items of the node */
+    if (ib_getapp(ist->base, item) & APP_HEAD) {
+      s = COUNT(cnts[item]); if (s < min) min = s; }
+    ist->sups[i] = min;         /* store the minimal support of the */
+  }                             /* head items from this item onward */
+}  /* heads() */
+
+/* heads() sets up the minimal head supports for the bounds used in */
+/* child(): all items of an extension of the item set at index i of */
+/* the node are on the path to the node or in the node at an index  */
+/* not less than i, and the last item is at an index greater than i */
+/* (and not less than the index of the candidate item).             */
+
+/*--------------------------------------------------------------------*/
+
 int ist_addlvl (ISTREE *ist)
 {                               /* --- add a level to item set tree */
   ITEM    i, n;                 /* loop variable, node counter */
@@ -1102,6 +1478,8 @@ int ist_addlvl (ISTREE *ist)
   void    *t;                   /* temporary buffer for reallocation */
 
   assert(ist);                  /* check the function arguments */
+  if (ist->hash) {              /* if there is a hash index, */
+    free(ist->hash); ist->hash = NULL; }  /* delete it */
 
   /* --- enlarge level array --- */
   if (ist->height >= ist->maxht) {
@@ -1125,6 +1503,7 @@ int ist_addlvl (ISTREE *ist)
     else if (!node->parent)         pex = ist->wgt;
     else pex = getsupp(node->parent, &node->item, 1);
     pex = COUNT(pex);           /* get support for perfect extension */
+    if (ist->bound) heads(ist, node);  /* get min. head supports */
     for (i = n = 0; i < node->size; i++) {
       cur = child(ist,node,i,pex); /* traverse the counter array */
       if (!cur) continue;       /* create a child node if necessary */
@@ -1141,23 +1520,21 @@ int ist_addlvl (ISTREE *ist)
     chn = np; par = node->parent;
     if (par) {                  /* if there is a parent node */
       if (par->offset >= 0) {   /* if a pure array is used */
-        chn = (ISTNODE**)(par->cnts +par->size);
+        chn = (ISTNODE**)CNTEND(par);
         ALIGN(chn);             /* get the child node array */
         chn += ITEMOF(node) -ITEMOF(chn[0]); }
       else {                    /* if an identifier map is used */
-        chn = (ISTNODE**)((ITEM*)(par->cnts +par->size) +par->size);
+        chn = (ISTNODE**)(ITEMMAP(par) +par->size);
         ALIGN(chn);             /* get the child node array */
         chn += search(ITEMOF(node), chn, CHILDCNT(par));
       }                         /* find the child node pointer */
     }                           /* in the parent node */
-    if (node->offset >= 0) {    /* if a pure counter array is used */
-      z = (size_t)(node->size-1) *sizeof(SUPP);
-      n = ITEMOF(last) -ITEMOF(*frst) +1; } /* pure child array */
-    else {                      /* if an identifier map is used */
-      z = (size_t)(node->size-1) *sizeof(SUPP)
-        + (size_t) node->size    *sizeof(ITEM);
-    }                           /* add a compact child array */
-    z += sizeof(ISTNODE);       /* add the node size */
+    z = CNTSIZE(node) -sizeof(SUPP);  /* get the counter size */
+    if (node->offset >= 0)      /* if a pure counter array is used */
+      n = ITEMOF(last) -ITEMOF(*frst) +1;  /* pure child array */
+    else                        /* if an identifier map is used */
+      z += (size_t)node->size *sizeof(ITEM);
+    z += sizeof(ISTNODE);       /* add a compact child array */
     node = (ISTNODE*)realloc(node, z+PAD(z)+(size_t)n*sizeof(ISTNODE*));
     if (!node) { cleanup(ist); return -1; }
     node->chcnt = n;            /* add a child array to the node */
@@ -1166,7 +1543,7 @@ int ist_addlvl (ISTREE *ist)
     #endif
     *chn = *np = node;          /* set the new (reallocated) node */
     if (node->offset >= 0) {    /* if a pure array is used */
-      chn = (ISTNODE**)(node->cnts +node->size);
+      chn = (ISTNODE**)CNTEND(node);
       ALIGN(chn);               /* get the child node array */
       while (--n >= 0) chn[n] = NULL;
       i = ITEMOF(*frst);        /* get the child node array */
@@ -1175,7 +1552,7 @@ int ist_addlvl (ISTREE *ist)
         cur->parent = node;     /* set the child node pointer */
       } }                       /* and the parent pointer */
     else {                      /* if an identifier map is used */
-      chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
       ALIGN(chn);               /* get the child node array */
       for (i = 0, cur = *frst; cur; cur = cur->succ) {
         chn[i++]    = cur;      /* set the child node pointer */
@@ -1214,12 +1591,12 @@ int ist_down (ISTREE *ist, ITEM item)
   cnt  = CHILDCNT(node);        /* if there are no child nodes, */
   if (cnt <= 0) return -1;      /* abort the function */
   if (node->offset >= 0) {      /* if a pure array is used */
-    chn = (ISTNODE**)(node->cnts +node->size);
+    chn = (ISTNODE**)CNTEND(node);
     ALIGN(chn);                 /* get the child node array */
     i   = item -ITEMOF(chn[0]); /* compute index in child node array */
     if ((i >= cnt) || !chn[i]) return -1; }
   else {                        /* if an identifier map is used */
-    chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+    chn = (ISTNODE**)(ITEMMAP(node) +node->size);
     ALIGN(chn);                 /* get the child node array */
     i   = search(item, chn, cnt);
     if (i < 0) return -1;       /* search for the proper index */
@@ -1244,7 +1621,7 @@ ITEM ist_next (ISTREE *ist, ITEM item)
     if (i >= node->size) return -1;
     return item +1; }           /* return the next item identifier */
   else {                        /* if an identifier map is used */
-    map = (ITEM*)(node->cnts +(n = node->size));
+    map = ITEMMAP(node); n = node->size;
     i = ia_bsearch(item, map, (size_t)n);
     if (i >= 0) i++;            /* try to find the item in the map */
     return (i < n) ? map[i] : -1;
@@ -1265,26 +1642,180 @@ SUPP ist_supp (ISTREE *ist, ITEM item)
     i = item -node->offset;     /* get index in counter array */
     if (i >= node->size) return 0; }
   else {                        /* if an identifier map is used */
-    map = (ITEM*)(node->cnts +node->size);
+    map = ITEMMAP(node);
     i = ia_bsearch(item, map, (size_t)node->size);
     if (i < 0) return 0;        /* abort if item not found */
   }                             /* or index is out of range */
-  return COUNT(node->cnts[i]);  /* return the item set support */
+  return COUNT(GETCNT(node,i)); /* return the item set support */
 }  /* ist_supp() */
 
 /*--------------------------------------------------------------------*/
 
+static size_t ifp (ITEM item)
+{                               /* --- get fingerprint of an item */
+  size_t h = (size_t)item *0x9e3779b1u +0x7f4a7c15u;
+  h ^= h >> 15; h *= 0x2c1b3c6du;
+  return h ^ (h >> 12);         /* mix the bits of the item code */
+}  /* ifp() */
+
+/*--------------------------------------------------------------------*/
+
+static size_t setfp (const ITEM *items, ITEM n)
+{                               /* --- get fingerprint of an item set */
+  size_t h = 0;                 /* fingerprint of the item set */
+  while (--n >= 0) h += ifp(items[n]);
+  return h;                     /* sum the item fingerprints */
+}  /* setfp() */
+
+/* ifp() mixes the bits of an item code, so that the fingerprints of */
+/* different items differ in many bits. The fingerprint of an item   */
+/* set is the sum of the fingerprints of its items. Hence ist_index() */
+/* computes the fingerprint of the path to a node only once and gets */
+/* the fingerprints of all item sets in the node by adding the       */
+/* fingerprint of the item of each counter.                          */
+
+/*--------------------------------------------------------------------*/
+
+static int match (const ISTSLOT *s, const ITEM *items, ITEM n)
+{                               /* --- check a hash index slot */
+  ISTNODE *node = s->node;      /* node containing the counter */
+
+  if (ITEMAT(node, s->index) != items[--n])
+    return 0;                   /* check the last item */
+  for ( ; node->parent; node = node->parent)
+    if ((--n < 0) || (ITEMOF(node) != items[n]))
+      return 0;                 /* check the items on the path */
+  return (n == 0);              /* check the item set size */
+}  /* match() */
+
+/*--------------------------------------------------------------------*/
+
+static ISTSLOT* lookup (ISTREE *ist, const ITEM *items, ITEM n,
+                        size_t h)
+{                               /* --- find an item set in the index */
+  size_t  i;                    /* index of a hash index slot */
+  ISTSLOT *s;                   /* to traverse the hash index slots */
+
+  assert(ist && ist->hash && items && (n > 1));
+  for (i = h & ist->hmsk; ; i = (i+1) & ist->hmsk) {
+    s = ist->hash +i;           /* traverse the probe sequence */
+    if (!s->node) return NULL;  /* if the set is not indexed, abort */
+    if ((s->fp == (ITEM)(h & (size_t)ITEM_MAX)) && match(s, items, n))
+      return s;                 /* if the item set is found, */
+  }                             /* return the hash index slot */
+}  /* lookup() */
+
+/*--------------------------------------------------------------------*/
+
 SUPP ist_suppx (ISTREE *ist, ITEM *items, ITEM n)
 {                               /* --- get support of an item set */
+  ISTSLOT *s;                   /* hash index slot of the item set */
+
   assert(ist                    /* check the function arguments */
   &&    (n >= 0) && (items || (n <= 0)));
   if (n <= 0)                   /* if the item set is empty, */
     return COUNT(ist->wgt);     /* return the total trans. weight */
+  if (ist->hash && (n > 1)      /* if the set is in the hash index, */
+  && (s = lookup(ist, items, n, setfp(items, n))))
+    return COUNT(GETCNT(s->node, s->index));    /* get the counter */
   return COUNT(getsupp(ist->lvls[0], items, n));
 }  /* ist_suppx() */            /* return the item set support */
 
 /*--------------------------------------------------------------------*/
 
+int ist_index (ISTREE *ist)
+{                               /* --- build a hash index */
+  ITEM    i, h;                 /* loop variables */
+  size_t  k, n;                 /* index of a slot, number of sets */
+  size_t  fp, x;                /* fingerprints of path and set */
+  ISTNODE *node, *curr;         /* to traverse the nodes */
+  ISTSLOT *s;                   /* to access the hash index slots */
+
+  assert(ist);                  /* check the function argument */
+  if (ist->hash) return 1;      /* if the index exists, abort */
+  for (n = 0, h = 1; h < ist->height; h++)
+    for (node = ist->lvls[h]; node; node = node->succ)
+      for (i = 0; i < node->size; i++)
+        if (COUNT(GETCNT(node, i)) >= ist->supp)
+          n++;                  /* count the frequent item sets */
+  for (k = 255; k < n+n; k = k+k+1);  /* compute the index size */
+  ist->hash = (ISTSLOT*)calloc(k+1, sizeof(ISTSLOT));
+  if (!ist->hash) return -1;    /* allocate the hash index */
+  ist->hmsk = k;                /* and note its size (bit mask) */
+  for (h = 1; h < ist->height; h++) {
+    for (node = ist->lvls[h]; node; node = node->succ) {
+      for (fp = 0, curr = node; curr->parent; curr = curr->parent)
+        fp += ifp(ITEMOF(curr));/* compute the path fingerprint */
+      for (i = 0; i < node->size; i++) {
+        if (COUNT(GETCNT(node, i)) < ist->supp)
+          continue;             /* skip infrequent item sets */
+        x = fp +ifp(ITEMAT(node, i));
+        for (k = x & ist->hmsk; ist->hash[k].node; )
+          k = (k+1) & ist->hmsk;/* find an empty slot */
+        s = ist->hash +k; s->node = node; s->index = i;
+        s->fp = (ITEM)(x & (size_t)ITEM_MAX);
+      }                         /* store node, counter index */
+    }                           /* and fingerprint of the set */
+  }                             /* for all item sets in the tree */
+  return 0;                     /* return 'ok' */
+}  /* ist_index() */
+
+/* The hash index is an open addressing hash table with linear probing */
+/* that is at most half full. It contains only the frequent item sets */
+/* with at least two items: the counters of infrequent item sets may  */
+/* be much more numerous (candidates), and single items are accessed  */
+/* directly in the root node. Queries for item sets that are not in   */
+/* the index fall back to the search in the tree, so that the result  */
+/* is always the same as without an index. Each slot refers to a     */
+/* counter (node and index), so that the supports are not copied and  */
+/* the index stays valid while the tree is filtered (the skip flags   */
+/* are removed when reading a support). It is deleted if the tree     */
+/* structure changes (ist_addlvl(), ist_prune()). A found slot is     */
+/* checked by comparing the items with the path to the node, which is */
+/* short and whose nodes (upper levels) are usually in the cache.     */
+
+/*--------------------------------------------------------------------*/
+
+int ist_suppxs (ISTREE *ist, const ITEM *items, const size_t *offs,
+                size_t cnt, SUPP *supps)
+{                               /* --- get supports of item sets */
+  size_t  i, k, m;              /* loop variables, block size */
+  ITEM    n;                    /* number of items in a set */
+  size_t  h[QRYBLK];            /* fingerprints of a query block */
+  ISTSLOT *s;                   /* hash index slot of an item set */
+
+  assert(ist && items && offs && supps); /* check the arguments */
+  if (!ist->hash && (ist_index(ist) < 0))
+    return -1;                  /* build the index if necessary */
+  for (i = 0; i < cnt; i += m){ /* traverse the blocks of queries */
+    m = (cnt-i < QRYBLK) ? cnt-i : QRYBLK;
+    for (k = 0; k < m; k++) {   /* traverse the queries of a block */
+      n    = (ITEM)(offs[i+k+1] -offs[i+k]);
+      h[k] = setfp(items +offs[i+k], n);
+      PREFETCH(ist->hash +(h[k] & ist->hmsk));
+    }                           /* compute the fingerprints and */
+    for (k = 0; k < m; k++) {   /* prefetch the hash index slots */
+      n = (ITEM)(offs[i+k+1] -offs[i+k]);
+      if (n <= 1)               /* get the support of a single item */
+        supps[i+k] = ist_suppx(ist, (ITEM*)items +offs[i+k], n);
+      else if ((s = lookup(ist, items +offs[i+k], n, h[k])))
+        supps[i+k] = COUNT(GETCNT(s->node, s->index));
+      else                      /* look up the support in the index */
+        supps[i+k] = COUNT(getsupp(ist->lvls[0],
+                                   (ITEM*)items +offs[i+k], n));
+    }                           /* (or search it in the tree) */
+  }                             /* of the item sets of the block */
+  return 0;                     /* return 'ok' */
+}  /* ist_suppxs() */
+
+/* The item sets are stored as for tbg_suppxs(), that is, item set i */
+/* occupies the elements offs[i] to offs[i+1]-1 of the array items,   */
+/* with the items in the same order as for ist_suppx(). The queries  */
+/* are processed in blocks, so that the slots of a whole block are    */
+/* requested from memory before the first of them is examined.        */
+
+/*--------------------------------------------------------------------*/
+
 void ist_clear (ISTREE *ist)
 {                               /* --- clear all node markers */
   ITEM    i, h;                 /* loop variables, buffers */
@@ -1295,87 +1826,227 @@ void ist_clear (ISTREE *ist)
   for (h = ist->height; --h >= 0; ) /* traverse the tree levels */
     for (node = ist->lvls[h]; node; node = node->succ)
       for (i = node->size; --i >= 0; )
-        CLRSKIP(node->cnts[i]);
+        CLRSKIPAT(node, i);
 }  /* ist_clear() */
 
 /*--------------------------------------------------------------------*/
 
+#ifdef TA_THREADS
+
+static void runthds (ISTWORK *work, void* (*fn)(void*))
+{                               /* --- process jobs with threads */
+  int       c;                  /* loop variable */
+  pthread_t thds[TA_THREADS];   /* worker threads */
+
+  assert(work && fn);           /* check the function arguments */
+  work->next = 0;               /* start with the first job */
+  pthread_mutex_init(&work->lock, NULL);
+  for (c = 1; c < TA_THREADS; c++)
+    if (pthread_create(thds+c, NULL, fn, work->thds+c) != 0)
+      break;                    /* start the worker threads and */
+  fn(work->thds);               /* also process in calling thread */
+  while (--c > 0)               /* wait for the worker threads */
+    pthread_join(thds[c], NULL);
+  pthread_mutex_destroy(&work->lock);
+}  /* runthds() */
+
+/*--------------------------------------------------------------------*/
+
+static void* sweeper (void *data)
+{                               /* --- process nodes of a level */
+  ISTTHD  *thd  = (ISTTHD*)data;   /* data of this thread */
+  ISTWORK *work = thd->work;    /* parallel processing data */
+  ISTJOB  *job;                 /* current node range job */
+  ISTNODE *node;                /* to traverse the nodes of the job */
+  ITEM    n;                    /* number of nodes to process */
+
+  while (1) {                   /* while there are jobs left */
+    pthread_mutex_lock(&work->lock);
+    job = (work->next < work->cnt) ? work->jobs +work->next++ : NULL;
+    pthread_mutex_unlock(&work->lock);
+    if (!job) return NULL;      /* get the next job (if any) */
+    for (node = job->node, n = job->index; --n >= 0; node = node->succ)
+      work->fn(&thd->ist, node, work->arg);
+  }                             /* process the nodes of the job */
+}  /* sweeper() */
+
+/*--------------------------------------------------------------------*/
+
+static int psweep (ISTREE *ist, ITEM h, NODEFN *fn, int arg)
+{                               /* --- process a level with threads */
+  int     c;                    /* loop variable */
+  ITEM    n;                    /* number of nodes on the level */
+  size_t  k, z;                 /* number of counters, buffer size */
+  ISTNODE *node;                /* to traverse the nodes of the level */
+  ISTTHD  *thd;                 /* to traverse the thread data */
+  ISTWORK work;                 /* parallel processing data */
+  ISTJOB  *job = NULL;          /* current node range job */
+
+  assert(ist && fn);            /* check the function arguments */
+  for (n = 0, k = 0, node = ist->lvls[h]; node; node = node->succ) {
+    n++; k += (size_t)node->size; }
+  if (k < 2*SWPCNT) return 1;   /* check for enough counters */
+  work.jobs = (ISTJOB*)malloc((size_t)n *sizeof(ISTJOB));
+  if (!work.jobs) return 1;     /* create the job array */
+  z = (size_t)ib_cnt(ist->base);/* get size of the batch buffers */
+  z = (ist->vals) ? z *sizeof(double) +3*z *sizeof(SUPP) : 0;
+  for (c = 0; c < TA_THREADS; c++) {
+    thd = work.thds +c;         /* traverse the thread data */
+    thd->work = &work; thd->rep = NULL; thd->err = 0;
+    thd->ist  = *ist;           /* copy the tree for the buffers */
+    thd->bnds = (ISTNODE**)malloc((size_t)ist->maxht *sizeof(ITEM) +z);
+    if (!thd->bnds) break;      /* allocate path and batch buffers */
+    thd->ist.buf = (ITEM*)thd->bnds;
+    if (!z) continue;           /* set the path buffer */
+    thd->ist.vals = (double*)(thd->ist.buf +ist->maxht);
+    thd->ist.sups = (SUPP*)(thd->ist.vals +ib_cnt(ist->base));
+  }                             /* set the batch evaluation buffers */
+  if (c < TA_THREADS) {         /* if buffers could not be created, */
+    while (--c >= 0) free(work.thds[c].bnds);
+    free(work.jobs); return 1;  /* delete the buffers and jobs */
+  }                             /* and process the level plainly */
+  work.fn = fn; work.arg = arg; /* note the node function */
+  for (work.cnt = 0, k = SWPCNT, node = ist->lvls[h]; node;
+       node = node->succ) {     /* traverse the nodes of the level */
+    if (k >= SWPCNT) {          /* if the current job is full, */
+      job = work.jobs +work.cnt++; /* start a new job */
+      job->node = node; job->index = 0; k = 0; }
+    job->index++; k += (size_t)node->size;
+  }                             /* collect ranges of nodes as jobs */
+  runthds(&work, sweeper);      /* process the nodes of the level */
+  for (c = 0; c < TA_THREADS; c++)
+    free(work.thds[c].bnds);    /* delete the buffers */
+  free(work.jobs);              /* and the job array */
+  return 0;                     /* return 'level processed' */
+}  /* psweep() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+static void sweep (ISTREE *ist, ITEM h, NODEFN *fn, int arg)
+{                               /* --- process the nodes of a level */
+  ISTNODE *node;                /* to traverse the nodes */
+
+  assert(ist && fn);            /* check the function arguments */
+  #ifdef TA_THREADS             /* if to use multiple threads, */
+  if (psweep(ist, h, fn, arg) <= 0) return;
+  #endif                        /* process the nodes in parallel */
+  for (node = ist->lvls[h]; node; node = node->succ)
+    fn(ist, node, arg);         /* process the nodes sequentially */
+}  /* sweep() */
+
+/*--------------------------------------------------------------------*/
+
+static void filter (ISTREE *ist, ISTNODE *node, int arg)
+{                               /* --- filter sets of a node by eval. */
+  ITEM   i;                     /* loop variable */
+  double *vals;                 /* measure values of a node */
+
+  assert(ist && node);          /* check the function arguments */
+  vals = evalnode(ist, node);   /* evaluate the node as a batch */
+  for (i = node->size; --i >= 0; ) {
+    if ((GETCNT(node, i) < ist->supp)
+    ||  (ist->dir *((vals) ? vals[i] : evaluate(ist, node, i))
+                            < ist->thresh))
+      SETSKIPAT(node, i);       /* traverse the counters of the node */
+  }                             /* and mark sets that do not qualify */
+}  /* filter() */
+
+/*--------------------------------------------------------------------*/
+
+static void weak (ISTREE *ist, ISTNODE *node, int arg)
+{                               /* --- weak filtering of a node */
+  ITEM    i, k, n;              /* loop variables, buffers */
+  ITEM    *path;                /* path to follow for subset support */
+  ISTNODE *curr;                /* to traverse the nodes on the path */
+
+  assert(ist && node);          /* check the function arguments */
+  curr = node->parent;          /* check the direkt parent */
+  k = ITEMOF(node);             /* of the given node */
+  k = (curr->offset >= 0) ? k -curr->offset
+    : ia_bsearch(k, ITEMMAP(curr), (size_t)curr->size);
+  if (GETCNT(curr, k) >= ist->supp)
+    return;                     /* abort search if parent qualifies */
+  for (i = node->size; --i >= 0; ) {
+    path = ist->buf +ist->maxht;
+    *--path = ITEMAT(node, i);
+    *--path = ITEMOF(node);     /* initialize the path */
+    n = 1;                      /* with the last two items */
+    for (curr = node->parent; curr; curr = curr->parent) {
+      if (getsupp(curr, path+1, n) >= ist->supp) break;
+      *--path = ITEMOF(curr); ++n;
+    }                           /* try to find a qualifying subset */
+    if (!curr) SETSKIPAT(node, i);
+  }                             /* if the whole path to the root */
+}  /* weak() */                 /* was traversed, but no qualifying */
+                                /* subset was found, mark item set */
+/*--------------------------------------------------------------------*/
+
+static void strong (ISTREE *ist, ISTNODE *node, int arg)
+{                               /* --- strong filtering of a node */
+  ITEM    i, k, n;              /* loop variables, buffers */
+  ITEM    *path;                /* path to follow for subset support */
+  ISTNODE *curr;                /* to traverse the nodes on the path */
+
+  assert(ist && node);          /* check the function arguments */
+  curr = node->parent;          /* check the direkt parent */
+  k = ITEMOF(node);             /* of the given node */
+  k = (curr->offset >= 0) ? k -curr->offset
+    : ia_bsearch(k, ITEMMAP(curr), (size_t)curr->size);
+  if (GETCNT(curr, k) < ist->supp) {
+    for (i = node->size; --i >= 0; )
+      SETSKIPAT(node, i);       /* if the direct parent is invalid, */
+    return;                     /* all sets in the node can be marked */
+  }
+  for (i = node->size; --i >= 0; ) {
+    path = ist->buf +ist->maxht;
+    *--path = ITEMAT(node, i);
+    *--path = ITEMOF(node);     /* initialize the path */
+    n = 1;                      /* with the last two items */
+    for (curr = node->parent; curr; curr = curr->parent) {
+      if (getsupp(curr, path+1, n) < ist->supp) break;
+      *--path = ITEMOF(curr); ++n;
+    }                           /* try to find a qualifying subset */
+    if (curr) SETSKIPAT(node, i);
+  }                             /* if on the way to the root */
+}  /* strong() */               /* a subset was found that does */
+                                /* not qualify, mark the item set */
+/*--------------------------------------------------------------------*/
+
 void ist_filter (ISTREE *ist, ITEM size)
 {                               /* --- filter frequent item sets */
-  ITEM    i, k, n, h;           /* loop variables, buffers */
-  ITEM    *path;                /* path to follow for subset support */
-  ISTNODE *node, *curr;         /* to traverse the nodes */
+  ITEM    i, h;                 /* loop variables */
+  ISTNODE *node;                /* to traverse the nodes */
 
   assert(ist);                  /* check the function argument */
-  for (h = ist->height; --h > 0; ) {
-    for (node = ist->lvls[h]; node; node = node->succ) {
-      for (i = node->size; --i >= 0; ) {
-        if ((node->cnts[i] < ist->supp)
-        ||  (ist->dir *evaluate(ist, node, i) < ist->thresh))
-          SETSKIP(node->cnts[i]);
-      }                         /* traverse all nodes of the tree */
-    }                           /* and all counters in each node and */
-  }                             /* mark sets that do not qualify */
+  for (h = ist->height; --h > 0; )
+    sweep(ist, h, filter, 0);   /* mark sets that do not qualify */
   if      (size < 0) {          /* -- weak filtering with evaluation */
     if (size > -2) size = -2;   /* traverse the tree levels */
-    for (h = -size; h < ist->height; h++) {
-      for (node = ist->lvls[h]; node; node = node->succ) {
-        curr = node->parent;    /* traverse the nodes on each level */
-        k = ITEMOF(node);       /* and check the direkt parent */
-        k = (curr->offset >= 0) ? k -curr->offset
-          : ia_bsearch(k, (ITEM*)(curr->cnts +curr->size),
-                          (size_t)curr->size);
-        if (curr->cnts[k] >= ist->supp)
-          continue;             /* abort search if parent qualifies */
-        for (i = node->size; --i >= 0; ) {
-          path = ist->buf +ist->maxht;
-          *--path = ITEMAT(node, i);
-          *--path = ITEMOF(node);   /* initialize the path */
-          n = 1;                /* with the last two items */
-          for (curr = node->parent; curr; curr = curr->parent) {
-            if (getsupp(curr, path+1, n) >= ist->supp) break;
-            *--path = ITEMOF(curr); ++n;
-          }                     /* try to find a qualifying subset */
-          if (!curr) SETSKIP(node->cnts[i]);
-        }                       /* if the whole path to the root */
-      }                         /* was traversed, but no qualifying */
-    } }                         /* subset was found, mark item set */
+    for (h = -size; h < ist->height; h++)
+      sweep(ist, h, weak, 0); } /* mark sets without a qualif. subset */
   else if (size > 0) {          /* -- strong filtering with evaluation*/
     if (size < 2) size = 2;     /* traverse the tree levels */
-    for (h = size; h < ist->height; h++) {
-      for (node = ist->lvls[h]; node; node = node->succ) {
-        curr = node->parent;    /* traverse the nodes on each level */
-        k = ITEMOF(node);       /* and check the direkt parent */
-        k = (curr->offset >= 0) ? k -curr->offset
-          : ia_bsearch(k, (ITEM*)(curr->cnts +curr->size),
-                          (size_t)curr->size);
-        if (curr->cnts[k] < ist->supp) {
-          for (i = node->size; --i >= 0; )
-            SETSKIP(node->cnts[i]);
-          continue;             /* if the direct parent is invalid, */
-        }                       /* all sets in the node can be marked */
-        for (i = node->size; --i >= 0; ) {
-          path = ist->buf +ist->maxht;
-          *--path = ITEMAT(node, i);
-          *--path = ITEMOF(node);   /* initialize the path */
-          n = 1;                /* with the last two items */
-          for (curr = node->parent; curr; curr = curr->parent) {
-            if (getsupp(curr, path+1, n) < ist->supp) break;
-            *--path = ITEMOF(curr); ++n;
-          }                     /* try to find a qualifying subset */
-          if (curr) SETSKIP(node->cnts[i]);
-        }                       /* if on the way to the root */
-      }                         /* a subset was found that does */
-    }                           /* not qualify, mark the item set */
-  }
+    for (h = size; h < ist->height; h++)
+      sweep(ist, h, strong, 0); /* mark sets with a subset */
+  }                             /* that does not qualify */
   if (((ist->dir < 0) ? -1 : 0) < ist->thresh) {
     SETSKIP(ist->wgt);          /* if the empty set and singletons */
     node = ist->lvls[0];        /* do not reah the eval. threshold */
-    for (i = node->size; --i >= 0; ) SETSKIP(node->cnts[i]);
+    for (i = node->size; --i >= 0; ) SETSKIPAT(node, i);
   }                             /* mark them all with a skip flag */
 }  /* ist_filter() */
 
-/*--------------------------------------------------------------------*/
+/*----------------------------------------------------------------------
+  The passes of ist_filter() process the levels of the tree one after
+the other and the nodes of each level with sweep(), that is, in
+parallel if TA_THREADS is defined. This is possible, because the
+processing of a node only sets skip flags of its own counters and
+reads only counters of lower levels: the evaluation of an item set
+needs only the supports of its subsets, while the weak and the strong
+filtering check (the skip flags of) subsets, which have been processed
+completely before the level is started.
+----------------------------------------------------------------------*/
 
 static void clear (ISTNODE *node, ITEM *items, ITEM n, SUPP supp)
 {                               /* --- clear an item set flag */
@@ -1387,11 +2058,11 @@ static void clear (ISTNODE *node, ITEM *items, ITEM n, SUPP supp)
   &&    (n >= 0) && (items || (n <= 0)));
   while (--n > 0) {             /* follow the set/path from the node */
     if (node->offset >= 0) {    /* if a pure array is used */
-      chn = (ISTNODE**)(node->cnts +node->size);
+      chn = (ISTNODE**)CNTEND(node);
       ALIGN(chn);               /* get the child node array */
       i   = *items++ -ITEMOF(chn[0]); }
     else {                      /* if an identifier map is used */
-      chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +node->size);
+      chn = (ISTNODE**)(ITEMMAP(node) +node->size);
       ALIGN(chn);               /* get the child node array */
       i   = search(*items++, chn, CHILDCNT(node));
     }                           /* get the proper child array index */
@@ -1400,50 +2071,191 @@ static void clear (ISTNODE *node, ITEM *items, ITEM n, SUPP supp)
   if (node->offset >= 0)        /* if a pure array is used, */
     i   = *items -node->offset; /* compute the counter index */
   else {                        /* if an identifier map is used */
-    map = (ITEM*)(node->cnts +(k = node->size));
+    map = ITEMMAP(node); k = node->size;
     i   = ia_bsearch(*items, map, (size_t)k);
   }                             /* search for the proper index */
-  if (node->cnts[i] <= supp)    /* if the support is low enough, */
-    CLRSKIP(node->cnts[i]);     /* clear skip flag of the item set */
+  if (GETCNT(node, i) <= supp)  /* if the support is low enough, */
+    CLRSKIPAT(node, i);         /* clear skip flag of the item set */
 }  /* clear() */
 
 /*--------------------------------------------------------------------*/
 
-void ist_clomax (ISTREE *ist, int target)
-{                               /* --- filter for closed/maximal sets */
-  ITEM    i, k, n, h;           /* loop variables, buffers */
+static void safe (ISTREE *ist, ISTNODE *node, int target)
+{                               /* --- restore closedness of a node */
+  ITEM    i, n;                 /* loop variables */
+  SUPP    supp;                 /* minimum support for a superset */
+  ITEM    *path;                /* path to access subset support */
+  ISTNODE *curr;                /* to traverse the nodes on the path */
+
+  assert(ist && node);          /* check the function arguments */
+  supp = SUPP_MAX;              /* set default support filter (max.) */
+  for (i = node->size; --i >= 0; ) {   /* traverse all sets */
+    if (GETCNT(node,i) < ist->supp) {   /* of the node */
+      SETSKIPAT(node, i); continue; }
+    if (!(target & IST_MAXIMAL)) supp = GETCNT(node, i);
+    curr = node->parent;        /* get parent of the current node */
+    path = ist->buf +ist->maxht;
+    *--path = ITEMAT(node, i);  /* mark item corresp. to index */
+    clear(curr, path, 1, supp);
+    *--path = ITEMOF(node);     /* mark item corresp. to node */
+    clear(curr, path, 1, supp);
+    for (n = 1; curr->parent; curr = curr->parent) {
+      clear(curr->parent, path, ++n, supp);
+      *--path = ITEMOF(curr);
+    }                           /* climb up the tree and clear */
+  }                             /* skip flags for all n-1 subsets */
+}  /* safe() */                 /* if their support does not */
+                                /* exceed the value of supp */
+/*--------------------------------------------------------------------*/
+
+static void genera (ISTREE *ist, ISTNODE *node, int arg)
+{                               /* --- filter a node for generators */
+  ITEM    i, k, n;              /* loop variables, buffers */
+  ITEM    a, b;                 /* buffers for items (hold-out) */
+  ITEM    m;                    /* number of unmarked item sets */
+  SUPP    supp;                 /* support of the current item set */
+  ITEM    *set;                 /* path to the node (item set prefix) */
+  ISTNODE *curr;                /* to traverse the nodes on the path */
+  ISTNODE *anc;                 /* node of the prefix before hold-out */
+
+  assert(ist && node);          /* check the function arguments */
+  curr = node->parent;          /* get the subset without the */
+  k = ITEMOF(node);             /* last item in the parent node */
+  k = (curr->offset >= 0) ? k -curr->offset
+    : ia_bsearch(k, ITEMMAP(curr), (size_t)curr->size);
+  for (m = 0, i = node->size; --i >= 0; ) {
+    supp = GETCNT(node,i);      /* traverse the sets of the node */
+    if ((supp < ist->supp)      /* check for minimum support and */
+    ||  (GETCNT(curr, k) <= supp))   /* for equal support */
+      SETSKIPAT(node, i);       /* of the direct parent */
+    else m++;                   /* count the sets that may still */
+  }                             /* be generators */
+  for (n = 0; curr; curr = curr->parent)
+    n++;                        /* get the length of the path */
+  set = ist->buf;               /* store the path to the node */
+  for (k = n, curr = node; --k >= 0; curr = curr->parent)
+    set[k] = ITEMOF(curr);      /* (the common item set prefix) */
+  a = set[--n];                 /* hold out the item of the node, */
+  curr = anc = node->parent;    /* the subsets are in the parent */
+  for (k = n; m > 0; ) {        /* traverse the hold-out items */
+    for (i = node->size; --i >= 0; ) {
+      supp = GETCNT(node, i);   /* traverse the unmarked sets */
+      if (IS2SKIP(supp)) continue;
+      if (!curr || (getcntitem(curr, ITEMAT(node, i)) <= supp)) {
+        SETSKIPAT(node, i); m--; }
+    }                           /* mark sets with a subset that */
+    if (--k < 0) break;         /* has the same support */
+    b = set[k]; set[k] = a; a = b;   /* get the next hold-out item */
+    anc  = anc->parent;         /* and the node of the prefix before */
+    curr = getnode(anc, set+k, n-k);  /* it, from which the node */
+  }                             /* of the subsets is reached */
+}  /* genera() */
+
+/* All item sets in a node share the path to the node as a prefix, so */
+/* the subsets that lack the same item of this prefix lie in the same */
+/* node. This node is found only once for each hold-out item (from  */
+/* the ancestor for the items before the hold-out item), and the     */
+/* supports of the subsets are then single counter accesses. Holding  */
+/* out the items from the end keeps the order of the remaining items. */
+/* A subset that is not in the tree (and thus infrequent) or that is  */
+/* marked (not a generator) has the support F_SKIP or a set skip flag */
+/* and causes the set to be marked, as with getsupp() before.         */
+
+/*--------------------------------------------------------------------*/
+
+static void clomax (ISTREE *ist, ISTNODE *node, int target)
+{                               /* --- filter a node for clo./max. */
+  ITEM    i, k, n;              /* loop variables, buffers */
   ITEM    item;                 /* buffer for an item */
   SUPP    supp;                 /* minimum support for a superset */
   ITEM    *map;                 /* item identifier map */
   ITEM    *path;                /* path to access superset support */
-  ISTNODE *node, *curr;         /* to traverse the nodes */
+  ISTNODE *curr;                /* to traverse the nodes on the path */
   ISTNODE **chn;                /* child node array */
 
+  assert(ist && node);          /* check the function arguments */
+  for (i = node->size; --i >= 0; ) {    /* traverse the sets */
+    if (GETCNT(node,i) < ist->supp) {   /* check for min. support */
+      SETSKIPAT(node, i); continue; }
+    item = ITEMAT(node, i);     /* get item and min. superset support */
+    supp = (target & IST_MAXIMAL) ? ist->supp : GETCNT(node, i);
+
+    /* -- check supersets in child -- */
+    n = CHILDCNT(node);         /* get the number of children */
+    if (n > 0) {                /* if there are child nodes */
+      if (node->offset >= 0) {  /* if pure array is used */
+        chn  = (ISTNODE**)CNTEND(node);
+        ALIGN(chn);             /* get the child node array */
+        k    = item -ITEMOF(chn[0]);
+        curr = ((k < 0) || (k >= n)) ? NULL : chn[k]; }
+      else {                    /* if an identifier map is used */
+        chn  = (ISTNODE**)(ITEMMAP(node) +node->size);
+        ALIGN(chn);             /* get the child node array */
+        k    = search(item, chn, n);
+        curr = (k < 0)               ? NULL : chn[k];
+      }                         /* get child node for current item */
+      if (curr) {               /* if the child node exists */
+        for (k = curr->size; --k >= 0; )
+          if (GETCNT(curr, k) >= supp) break;
+        if (k >= 0) { SETSKIPAT(node, i); continue; }
+      }                         /* if a superset in the tail has */
+    }                           /* sufficient support, mark set */
+
+    /* -- check other supersets -- */
+    path = ist->buf +ist->maxht;
+    *--path = item;             /* init. the path for lookups and */
+    n = 1;                      /* traverse the path to the root */
+    for (curr = node; curr; curr = curr->parent) {
+      if (curr->offset >= 0) {  /* if a pure array is used */
+        k = *path -curr->offset;/* get index of current item */
+        if (k > curr->size) k = curr->size;
+        while (--k >= 0) {      /* traverse the preceding items */
+          path[-1] = curr->offset +k;
+          if (getsupp(curr, path-1, n+1) >= supp) break;
+        } }                     /* if a superset qualifies, abort */
+      else {                    /* if an identifier map is used */
+        map = ITEMMAP(curr); k = curr->size;
+        k   = ia_bisect(*path, map, (size_t)k);
+        while (--k >= 0) {      /* traverse the preceding items */
+          path[-1] = map[k];
+          if (getsupp(curr, path-1, n+1) >= supp) break;
+        }                       /* if a superset qualifies, abort */
+      }
+      if (k >= 0) break;        /* if a superset found, abort search */
+      if (path <= ist->buf) { curr = NULL; break; }
+      *--path = ITEMOF(curr); n++;
+    }                           /* extend the item set suffix/path */
+    if (curr) SETSKIPAT(node, i);
+  }                             /* if frequent/equal support superset */
+}  /* clomax() */               /* was found, the current item set */
+                                /* is not closed/maximal, resp. */
+/*--------------------------------------------------------------------*/
+
+static void infreq (ISTREE *ist, ISTNODE *node, int arg)
+{                               /* --- mark infrequent sets of a node */
+  ITEM i;                       /* loop variable */
+
+  assert(ist && node);          /* check the function arguments */
+  for (i = node->size; --i >= 0; )
+    if (GETCNT(node, i) < ist->supp)
+      SETSKIPAT(node, i);       /* mark infrequent item sets only */
+}  /* infreq() */
+
+/*--------------------------------------------------------------------*/
+
+void ist_clomax (ISTREE *ist, int target)
+{                               /* --- filter for closed/maximal sets */
+  ITEM    i, h;                 /* loop variables */
+  SUPP    supp;                 /* minimum support for a superset */
+  ISTNODE *node;                /* to traverse the nodes */
+
   assert(ist);                  /* check the function argument */
 
   /* --- safe filtering --- */
   if (target & IST_SAFE) {      /* if to filter in a safe way */
-    supp = SUPP_MAX;            /* set default support filter (max.) */
-    for (k = ist->height; --k > 0; ) { /* traverse the tree top down */
-      for (node = ist->lvls[k]; node; node = node->succ) {
-        for (i = node->size; --i >= 0; ) {  /* traverse all sets */
-          if (node->cnts[i] < ist->supp) {  /* of all nodes */
-            SETSKIP(node->cnts[i]); continue; }
-          if (!(target & IST_MAXIMAL)) supp = node->cnts[i];
-          curr = node->parent;  /* get parent of the current node */
-          path = ist->buf +ist->maxht;
-          *--path = ITEMAT(node, i); /* mark item corresp. to index */
-          clear(curr, path, 1, supp);
-          *--path = ITEMOF(node);    /* mark item corresp. to node */
-          clear(curr, path, 1, supp);
-          for (n = 1; curr->parent; curr = curr->parent) {
-            clear(curr->parent, path, ++n, supp);
-            *--path = ITEMOF(curr);
-          }                     /* climb up the tree and clear */
-        }                       /* skip flags for all n-1 subsets */
-      }                         /* if their support does not */
-    }                           /* exceed the value of supp */
-  }                             /* (remove all possible holes) */
+    for (h = ist->height; --h > 0; )
+      sweep(ist, h, safe, target);
+  }                             /* traverse the tree top down */
   /* If the evaluation of an item set was used to filter the found */
   /* frequent item sets, the set of found item sets may no longer  */
   /* be closed. The above procedure restores it to a closed set.   */
@@ -1452,114 +2264,42 @@ void ist_clomax (ISTREE *ist, int target)
   if (target & ISR_GENERA) {    /* if to filter for generators */
     node = ist->lvls[0];        /* traverse the root node elements */
     for (i = node->size; --i >= 0; ) {
-      if ((node->cnts[i] <  ist->supp)
-      ||  (node->cnts[i] >= ist->wgt))
-        SETSKIP(node->cnts[i]); /* mark all infrequent items */
+      if ((GETCNT(node, i) <  ist->supp)
+      ||  (GETCNT(node, i) >= ist->wgt))
+        SETSKIPAT(node, i);     /* mark all infrequent items */
     }                           /* and single item generators */
-    for (h = 0; ++h < ist->height; ) {  /* traverse the tree levels */
-      for (node = ist->lvls[h]; node; node = node->succ) {
-        for (i = node->size; --i >= 0; ) {    /* traverse the nodes */
-          supp = node->cnts[i]; /* traverse the nodes on each level */
-          if (supp < ist->supp){/* check for minimum support */
-            SETSKIP(node->cnts[i]); continue; }
-          curr = node->parent;  /* check the direkt parent */
-          k = ITEMOF(node);     /* for equal support */
-          k = (curr->offset >= 0) ? k -curr->offset
-            : ia_bsearch(k, (ITEM*)(curr->cnts +curr->size),
-                            (size_t)curr->size);
-          if (curr->cnts[k] <= supp) {
-            SETSKIP(node->cnts[i]); continue; }
-          path = ist->buf +ist->maxht;
-          *--path = ITEMAT(node, i);
-          *--path = ITEMOF(node);   /* initialize the path */
-          n = 1;                /* with the last two items */
-          for (curr = node->parent; curr; curr = curr->parent) {
-            if (getsupp(curr, path+1, n) <= supp) break;
-            *--path = ITEMOF(curr); ++n;
-          }                     /* try to find a qualifying subset */
-          if (curr) SETSKIP(node->cnts[i]);
-        }                       /* if on the path to the root */
-      }                         /* a subset could be found */
-    }                           /* that has the same support, */
-    return;                     /* the set is not a generator */
-  }                             /* abort when filtering finishes */
+    for (h = 0; ++h < ist->height; )
+      sweep(ist, h, genera, 0); /* filter the other tree levels */
+    return;                     /* abort when filtering finishes */
+  }
 
   /* --- check empty set --- */
   supp = (target & IST_MAXIMAL) ? ist->supp : ist->wgt;
   node = ist->lvls[0];          /* traverse the root node elements */
   for (i = node->size; --i >= 0; )  /* mark empty set if necessary */
-    if (node->cnts[i] >= supp) { SETSKIP(ist->wgt); break; }
+    if (GETCNT(node, i) >= supp) { SETSKIP(ist->wgt); break; }
 
   /* --- process intermediate levels --- */
-  supp = SUPP_MAX;              /* set default support filter (max.) */
-  for (h = 0; h < ist->height-1; h++) {   /* traverse the tree levels */
-    for (node = ist->lvls[h]; node; node = node->succ) {
-      for (i = node->size; --i >= 0; ) {  /* traverse the nodes */
-        if (node->cnts[i] < ist->supp) {  /* check for min. support */
-          SETSKIP(node->cnts[i]); continue; }
-        item = ITEMAT(node, i); /* get item and min. superset support */
-        supp = (target & IST_MAXIMAL) ? ist->supp : node->cnts[i];
-
-        /* -- check supersets in child -- */
-        n = CHILDCNT(node);     /* get the number of children */
-        if (n > 0) {            /* if there are child nodes */
-          if (node->offset >= 0) { /* if pure array is used */
-            chn  = (ISTNODE**)(node->cnts +node->size);
-            ALIGN(chn);         /* get the child node array */
-            k    = item -ITEMOF(chn[0]);
-            curr = ((k < 0) || (k >= n)) ? NULL : chn[k]; }
-          else {                /* if an identifier map is used */
-            chn  = (ISTNODE**)((ITEM*)(node->cnts +node->size)
-                                                  +node->size);
-            ALIGN(chn);         /* get the child node array */
-            k    = search(item, chn, n);
-            curr = (k < 0)               ? NULL : chn[k];
-          }                     /* get child node for current item */
-          if (curr) {           /* if the child node exists */
-            for (k = curr->size; --k >= 0; )
-              if (curr->cnts[k] >= supp) break;
-            if (k >= 0) { SETSKIP(node->cnts[i]); continue; }
-          }                     /* if a superset in the tail has */
-        }                       /* sufficient support, mark set */
-
-        /* -- check other supersets -- */
-        path = ist->buf +ist->maxht;
-        *--path = item;         /* init. the path for lookups and */
-        n = 1;                  /* traverse the path to the root */
-        for (curr = node; curr; curr = curr->parent) {
-          if (curr->offset >= 0) {   /* if a pure array is used */
-            k = *path -curr->offset; /* get index of current item */
-            if (k > curr->size) k = curr->size;
-            while (--k >= 0) {  /* traverse the preceding items */
-              path[-1] = curr->offset +k;
-              if (getsupp(curr, path-1, n+1) >= supp) break;
-            } }                 /* if a superset qualifies, abort */
-          else {                /* if an identifier map is used */
-            map = (ITEM*)(curr->cnts +(k = curr->size));
-            k   = ia_bisect(*path, map, (size_t)k);
-            while (--k >= 0) {  /* traverse the preceding items */
-              path[-1] = ((ITEM*)(curr->cnts +curr->size))[k];
-              if (getsupp(curr, path-1, n+1) >= supp) break;
-            }                   /* if a superset qualifies, abort */
-          }
-          if (k >= 0) break;    /* if a superset found, abort search */
-          if (path <= ist->buf) { curr = NULL; break; }
-          *--path = ITEMOF(curr); n++;
-        }                       /* extend the item set suffix/path */
-        if (curr) SETSKIP(node->cnts[i]);
-      }                         /* if frequent/equal support superset */
-    }                           /* was found, the current item set */
-  }                             /* is not closed/maximal, resp. */
+  for (h = 0; h < ist->height-1; h++)
+    sweep(ist, h, clomax, target);
 
   /* --- process deepest level --- */
-  for (node = ist->lvls[h]; node; node = node->succ)
-    for (i = node->size; --i >= 0; )
-      if (node->cnts[i] < ist->supp)
-        SETSKIP(node->cnts[i]); /* mark infrequent item sets only */
+  sweep(ist, h, infreq, 0);     /* mark infrequent item sets only */
   /* All frequent item sets on the deepest level tree must be closed */
   /* and maximal, because they do not have supersets (in the tree).  */
 }  /* ist_clomax() */
 
+/*----------------------------------------------------------------------
+  Like ist_filter(), ist_clomax() processes the nodes of each level
+with sweep(). The safe filtering (top down) clears skip flags of subsets
+on lower levels, possibly of the same set from several threads, but all
+these threads only clear the flag (idempotent), while the flags of the
+level itself are set only by the thread processing the node. The filter
+for generators (bottom up) checks subsets, the filter for closed and
+maximal item sets (bottom up) checks supersets on the next level, which
+is processed only after the current level has been completed.
+----------------------------------------------------------------------*/
+
 /*--------------------------------------------------------------------*/
 
 void ist_setsize (ISTREE *ist, ITEM min, ITEM max, int order)
@@ -1575,6 +2315,8 @@ void ist_setsize (ISTREE *ist, ITEM min, ITEM max, int order)
 void ist_seteval (ISTREE *ist, int eval, int agg,
                   double thresh, double minimp, ITEM prune)
 {                               /* --- set additional evaluation */
+  size_t n;                     /* number of items */
+
   assert(ist);                  /* check the function arguments */
   ist->invbxs = eval & IST_INVBXS; eval &= ~IST_INVBXS;
   ist->eval   = ((eval > IST_NONE) && (eval <= IST_LDRATIO))
@@ -1582,10 +2324,31 @@ void ist_seteval (ISTREE *ist, int eval, int agg,
   ist->agg    = ((agg  > IST_NONE) && (agg  <= IST_EQS))
               ? agg  : IST_NONE;/* check and note the agg. mode */
   ist->dir    = (ist->eval == IST_LDRATIO) ? +1 : re_dir(ist->eval);
-  ist->thresh = ist->dir *thresh;
+  if ((ist->eval >= RE_FETPROB) && (ist->eval <= RE_FETSUPP)
+  &&  !ist->fetc)               /* if Fisher's exact test is used, */
+    ist->fetc = re_fetcache(COUNT(ist->wgt)); /* get log-factorials */
+  if ((ist->eval > IST_NONE) && (ist->eval < IST_LDRATIO) && !ist->vals){
+    n = (size_t)ib_cnt(ist->base);  /* if to evaluate with a measure, */
+    ist->vals = (double*)malloc(n *sizeof(double) +3*n *sizeof(SUPP));
+    if (ist->vals) ist->sups = (SUPP*)(ist->vals +n);
+  }                             /* create buffers for batch evaluation */
+  ist->thresh = ist->dir *thresh; /* (on failure evaluate each set) */
   ist->minimp = minimp;         /* note the evaluation parameters */
+  ist->crit   = ((ist->agg != IST_AVG) && (minimp <= -INFINITY))
+              ? re_pcrit(ist->eval, thresh) : 0;
+  /* p-values above the threshold may be replaced by 1 (re_pcut()), */
+  /* unless they are averaged or differences of them are needed */
   ist->prune  = (prune <= 0) ? ITEM_MAX : (prune > 1) ? prune : 2;
-}  /* ist_seteval() */
+  ist->bound  = 0;              /* default: no evaluation bounds */
+  if (!ist->sups || (ist->eval <= IST_NONE) || (ist->eval >= IST_LDRATIO))
+    return;                     /* check for a bounded measure */
+  if      (ist->mode & IST_RULEBND)  /* rules may have any head */
+    ist->bound = 2;             /* and so may item sets if the */
+  else if ((ist->mode & IST_SETBND) && (ist->agg != IST_EQS))
+    ist->bound = ((ist->agg == IST_AVG)  /* best rule is aggregated */
+               || (ist->agg == ((ist->dir > 0) ? IST_MAX : IST_MIN)))
+               ? 2 : 1;         /* otherwise the head of the rule */
+}  /* ist_seteval() */          /* is the last item of the set */
 
 /*--------------------------------------------------------------------*/
 
@@ -1654,7 +2417,7 @@ ITEM ist_set (ISTREE *ist, ITEM *set, SUPP *supp, double *eval)
     item = ITEMAT(node, ist->index);     /* get the current item */
     if (ib_getapp(ist->base, item) == APP_NONE)
       continue;                 /* skip items to ignore */
-    curr = node->cnts[ist->index];
+    curr = GETCNT(node, ist->index);
     if ((curr < ist->supp)      /* if the support is not sufficient */
     ||  (curr > ist->smax))     /* or larger than the maximum, */
       continue;                 /* go to the next item set */
@@ -1744,7 +2507,7 @@ ITEM ist_rule (ISTREE *ist, ITEM *rule,
     if (!(app &  APP_HEAD)      /* get head item appearance indicator */
     ||  ((app != APP_HEAD) && ist->hdonly))
       continue;                 /* if rule is not allowed, skip it */
-    s_set = COUNT(node->cnts[ist->index]);
+    s_set = COUNT(GETCNT(node, ist->index));
     if ((s_set < ist->supp)     /* if the support is not sufficient */
     ||  (s_set > ist->smax)) {  /* or larger than the maximum, */
       ist->item = -1; continue; }   /* go to the next item set */
@@ -1755,11 +2518,11 @@ ITEM ist_rule (ISTREE *ist, ITEM *rule,
     else if (!parent)           /* if there is no parent (root node), */
       s_body = COUNT(ist->wgt); /* get the total trans. weight */
     else if (parent->offset >= 0)  /* if a pure array is used */
-      s_body = COUNT(parent->cnts[ITEMOF(node) -parent->offset]);
+      s_body = COUNT(GETCNT(parent, ITEMOF(node) -parent->offset));
     else {                      /* if an identifier map is used */
-      map = (ITEM*)(parent->cnts +(n = parent->size));
+      map = ITEMMAP(parent); n = parent->size;
       i   = ia_bsearch(ITEMOF(node), map, (size_t)n);
-      s_body = COUNT(parent->cnts[i]);
+      s_body = COUNT(GETCNT(parent, i));
     }                           /* find array index and get support */
     if ((s_body < ist->rule)    /* if the body support is too low or */
     ||  ((double)s_set < (double)s_body *ist->conf))   /* the conf., */
@@ -1767,9 +2530,7 @@ ITEM ist_rule (ISTREE *ist, ITEM *rule,
     s_head = COUNT(ist->lvls[0]->cnts[ist->item]);
     if (!refn) {                /* if no add. eval. measure given, */
       val = 0; break; }         /* abort the loop (select the rule) */
-    val = (!ist->invbxs         /* compute add. evaluation measure */
-       || ((double)s_set*(double)s_base >(double)s_head*(double)s_body))
-        ? refn(s_set, s_body, s_head, s_base) : (ist->dir < 0) ? 1 : 0;
+    val = ruleval(ist, refn, s_set, s_body, s_head, s_base);
     if (ist->dir *val >= ist->thresh)
       break;                    /* if the evaluation is high enough, */
   }  /* while (1) */            /* abort the loop (select the rule) */
@@ -1808,7 +2569,7 @@ static int report (ISTREE *ist, ISREPORT *rep, ISTNODE *node, SUPP supp)
   else {                        /* if perfect extensions pruning */
     pex = supp;                 /* note the parent set support */
     for (k = 0; k < node->size; k++) {
-      if (COUNT(node->cnts[k]) >= pex)
+      if (COUNT(GETCNT(node, k)) >= pex)
         isr_addpex(rep, ITEMAT(node, k));
     }                           /* collect the perfect extensions */
   }                             /* (note that they may be redisc.) */
@@ -1816,12 +2577,12 @@ static int report (ISTREE *ist, ISREPORT *rep, ISTNODE *node, SUPP supp)
   &&  (supp <= ist->smax)) {    /* and does not exceed max. support, */
     if (isr_report(rep) < 0) return -1; } /* report current item set */
   if (node->offset >= 0) {      /* if a pure array is used */
-    chn = (ISTNODE**)(node->cnts +node->size);
+    chn = (ISTNODE**)CNTEND(node);
     ALIGN(chn);                 /* get the child node array */
     c   = CHILDCNT(node);       /* and the number of children */
     off = (c > 0) ? ITEMOF(chn[0]) : 0;
     for (i = 0; i < node->size; i++) {
-      supp = COUNT(node->cnts[i]);
+      supp = COUNT(GETCNT(node, i));
       if ((supp <  ist->supp)   /* traverse the node's items and */
       ||  (supp >= pex))        /* check against minimum support */
         continue;               /* and the parent set support */
@@ -1829,7 +2590,7 @@ static int report (ISTREE *ist, ISREPORT *rep, ISTNODE *node, SUPP supp)
       ist->index = i;           /* in the node for evaluation */
       k = node->offset +i;      /* compute the item identifier */
       isr_add(rep, k, supp);    /* add the item to the reporter */
-      supp = node->cnts[i];     /* get the item support (with flag) */
+      supp = GETCNT(node, i);   /* get the item support (with flag) */
       k -= off;                 /* compute the child node index */
       if ((k >= 0)              /* if the corresp. child node exists, */
       &&  (k <  c) && chn[k])   /* recursively report the subtree */
@@ -1840,12 +2601,12 @@ static int report (ISTREE *ist, ISREPORT *rep, ISTNODE *node, SUPP supp)
       isr_remove(rep, 1);       /* remove the last item */
     } }                         /* from the current item set */
   else {                        /* if an identifier map is used */
-    map = (ITEM*)(node->cnts +(k = node->size));
+    map = ITEMMAP(node); k = node->size;
     chn = (ISTNODE**)(map +k);  /* get the item id map */
     c   = CHILDCNT(node);       /* and the child node array  */
     c   = (c > 0) ? ITEMOF(chn[c-1]) : -1;
     for (i = 0; i < node->size; i++) {
-      supp = COUNT(node->cnts[i]);
+      supp = COUNT(GETCNT(node, i));
       if ((supp <  ist->supp)   /* traverse the node's items and */
       ||  (supp >= pex))        /* check against minimum support */
         continue;               /* and the parent set support */
@@ -1853,7 +2614,7 @@ static int report (ISTREE *ist, ISREPORT *rep, ISTNODE *node, SUPP supp)
       ist->index = i;           /* in the node for evaluation */
       k = map[i];               /* retrieve the item identifier */
       isr_add(rep, k, supp);    /* add the item to the reporter */
-      supp = node->cnts[i];     /* get the item support (with flag) */
+      supp = GETCNT(node, i);   /* get the item support (with flag) */
       if (k <= c)               /* if there may be a child node, */
         while (k > ITEMOF(*chn)) chn++;  /* skip preceding items */
       if ((k <= c)              /* if the corresp. child node exists, */
@@ -1870,12 +2631,334 @@ static int report (ISTREE *ist, ISREPORT *rep, ISTNODE *node, SUPP supp)
 
 /*--------------------------------------------------------------------*/
 
+static int rules (ISTREE *ist, ISREPORT *rep, ISTNODE *node,
+                  ISTNODE **bnds)
+{                               /* --- report rules of a node */
+  ITEM      i, j, k, m, n;      /* loop variables, set size */
+  ITEM      item, head;         /* last item and head item */
+  ITEM      *set, *rule;        /* item set prefix and rule buffer */
+  ISTNODE   *curr;              /* to traverse the ancestors */
+  SUPP      s_set;              /* support of set  (body & head) */
+  SUPP      s_body;             /* support of body (antecedent) */
+  SUPP      s_head;             /* support of head (consequent) */
+  SUPP      s_base;             /* base support (number of trans.) */
+  SUPP      s_last;             /* body support if last item is head */
+  double    val;                /* value of evaluation measure */
+  int       app, hdonly;        /* appearance flags of items */
+  RULEVALFN *refn;              /* rule evaluation function */
+
+  assert(ist && rep && node && bnds); /* check the function args. */
+  set  = (ITEM*)(bnds +ist->maxht); /* get the item set prefix */
+  rule = set +ist->maxht;       /* and the rule buffer */
+  for (k = 1, curr = node; curr->parent; curr = curr->parent)
+    k++;                        /* determine the item set size */
+  for (j = k-1, curr = node; --j >= 0; curr = curr->parent)
+    set[j] = ITEMOF(curr);      /* collect the items on the path */
+  for (curr = node, j = k-1; --j >= 0; ) {
+    curr    = curr->parent;     /* traverse the ancestors and get */
+    bnds[j] = getnode(curr, set+j+1, k-2-j);
+  }                             /* the nodes holding the body supps. */
+  s_last = (node->parent) ? COUNT(getcntitem(node->parent, ITEMOF(node)))
+                          : COUNT(ist->wgt);
+  s_base = COUNT(ist->wgt);     /* get the base support and */
+  refn   = ((ist->eval > IST_NONE) && (ist->eval < IST_LDRATIO))
+         ? re_function(ist->eval) : (RULEVALFN*)0;
+  for (i = 0; i < node->size; i++) {
+    item = ITEMAT(node, i);     /* traverse the item sets of the node */
+    app  = ib_getapp(ist->base, item);
+    if ((app == APP_NONE) || ((app == APP_HEAD) && HDONLY(node)))
+      continue;                 /* skip sets with two head only items */
+    hdonly = (app == APP_HEAD) || HDONLY(node);
+    s_set  = COUNT(GETCNT(node, i));
+    if ((s_set < ist->supp) || (s_set > ist->smax))
+      continue;                 /* skip sets with insufficient supp. */
+    for (j = k; --j >= 0; ) {   /* traverse the possible heads */
+      head = (j < k-1) ? set[j] : item;     /* (last item first) */
+      app  = ib_getapp(ist->base, head);
+      if (!(app &  APP_HEAD)    /* get head item appearance indicator */
+      ||  ((app != APP_HEAD) && hdonly))
+        continue;               /* if rule is not allowed, skip it */
+      s_body = (j >= k-1) ? s_last : (!bnds[j]) ? 0
+             : COUNT(getcntitem(bnds[j], item));
+      if ((s_body < ist->rule)  /* if the body support is too low or */
+      ||  ((double)s_set < (double)s_body *ist->conf))   /* the conf., */
+        continue;               /* go to the next head item */
+      s_head = COUNT(ist->lvls[0]->cnts[head]);
+      if (!refn) val = 0;       /* if no add. eval. measure given */
+      else {                    /* compute add. evaluation measure */
+        val = ruleval(ist, refn, s_set, s_body, s_head, s_base);
+        if (ist->dir *val < ist->thresh)
+          continue;             /* if the evaluation is too low, */
+      }                         /* go to the next head item */
+      rule[0] = head;           /* set the head of the rule and */
+      for (n = 1, m = 0; m < k-1; m++)
+        if (m != j) rule[n++] = set[m];
+      if (j < k-1) rule[n++] = item;   /* collect the body items */
+      if (isr_rule(rep, rule, k, s_set, s_body, s_head, val) < 0)
+        return -1;              /* report the association rule */
+    }
+  }
+  return 0;                     /* return 'ok' */
+}  /* rules() */
+
+/* rules() generates the same rules in the same order as repeated  */
+/* calls of ist_rule(), but processes all item sets of a node at    */
+/* once: the bodies that result from removing one of the items on   */
+/* the path to the node differ only in their last item, so the      */
+/* nodes holding their supports are looked up once per node (bnds)  */
+/* and each body support is a single counter access (getcntitem()). */
+
+/*--------------------------------------------------------------------*/
+
+#ifdef TA_THREADS
+
+static void repjobs (ISTTHD *thd)
+{                               /* --- process subtree report jobs */
+  ISTWORK  *work = thd->work;   /* parallel reporting data */
+  ISTJOB   *job;                /* current subtree reporting job */
+  ISTREE   *ist  = &thd->ist;   /* item set tree to work on */
+  ISREPORT *rep  = thd->rep;    /* item set reporter to use */
+
+  while (1) {                   /* while there are jobs left */
+    pthread_mutex_lock(&work->lock);
+    job = (work->next < work->cnt) ? work->jobs +work->next++ : NULL;
+    pthread_mutex_unlock(&work->lock);
+    if (!job) return;           /* get the next job (if any) */
+    job->rep   = rep;           /* note the reporter and the start */
+    job->beg   = isr_outpos(rep);  /* of the output section */
+    ist->node  = ist->lvls[0];  /* store the node and the index */
+    ist->index = job->index;    /* in the node for evaluation */
+    isr_add(rep, ITEMAT(ist->node, job->index), COUNT(job->supp));
+    if (job->node) {            /* if the child node exists, */
+      if (report(ist, rep, job->node, job->supp) < 0)
+        thd->err = -1; }        /* recursively report the subtree */
+    else if (!IS2SKIP(job->supp)/* if the item set is not marked, */
+    &&       (job->supp <= ist->smax)) {  /* report current item set */
+      if (isr_report(rep) < 0) thd->err = -1; }
+    isr_remove(rep, 1);         /* remove the item again and */
+    job->end   = isr_outpos(rep);  /* note the end of the section */
+  }
+}  /* repjobs() */
+
+/*--------------------------------------------------------------------*/
+
+static void* reporter (void *data)
+{                               /* --- report subtrees (thread) */
+  repjobs((ISTTHD*)data);       /* process subtree report jobs */
+  return NULL;                  /* return a dummy result */
+}  /* reporter() */
+
+/*--------------------------------------------------------------------*/
+
+static int mkthds (ISTWORK *work, ISTREE *ist, ISREPORT *rep)
+{                               /* --- create the thread data */
+  int    c;                     /* loop variable */
+  ISTTHD *thd;                  /* to traverse the thread data */
+
+  assert(work && ist && rep);   /* check the function arguments */
+  for (c = 0; c < TA_THREADS; c++) {
+    thd = work->thds +c;        /* traverse the thread data */
+    thd->work = work; thd->err = 0;
+    thd->ist  = *ist;           /* copy the tree for the path buffer */
+    thd->bnds = (ISTNODE**)malloc((size_t)ist->maxht
+                                 *(sizeof(ISTNODE*) +2*sizeof(ITEM)));
+    if (!thd->bnds) break;      /* allocate body nodes and buffers */
+    thd->ist.buf = (ITEM*)(thd->bnds +ist->maxht);
+    thd->rep  = isr_clone(rep, (isr_evaldat(rep) == ist)
+                               ? &thd->ist : NULL);
+    if (!thd->rep) { free(thd->bnds); break; }
+  }                             /* clone the reporter for each thread */
+  if (c >= TA_THREADS) return 0;/* if all clones could be created */
+  while (--c >= 0) {            /* (e.g. not with a reporting func.) */
+    isr_delete(work->thds[c].rep, 0); free(work->thds[c].bnds); }
+  return -1;                    /* delete the clones and buffers */
+}  /* mkthds() */
+
+/*--------------------------------------------------------------------*/
+
+static int rmthds (ISTWORK *work, ISREPORT *rep)
+{                               /* --- delete the thread data */
+  int    c;                     /* loop variable */
+  ISTTHD *thd;                  /* to traverse the thread data */
+  int    r = 0;                 /* error status */
+
+  assert(work && rep);          /* check the function arguments */
+  for (c = 0; c < TA_THREADS; c++) {
+    thd = work->thds +c;        /* traverse the thread data */
+    if (thd->err || (isr_merge(rep, thd->rep) < 0)) r = -1;
+    isr_delete(thd->rep, 0);    /* merge the counters of the clones */
+    free(thd->bnds);            /* and delete the clones */
+  }                             /* and the buffers */
+  return r;                     /* return the error status */
+}  /* rmthds() */
+
+/*--------------------------------------------------------------------*/
+
+static int preport (ISTREE *ist, ISREPORT *rep)
+{                               /* --- report item sets with threads */
+  ITEM      i, k, c, n;         /* loop variables, buffers */
+  ITEM      off;                /* item offset of child nodes */
+  SUPP      supp, pex;          /* item support, perf. ext. support */
+  ISTNODE   *root;              /* root node of the tree */
+  ISTNODE   **chn;              /* child node array */
+  ISTWORK   work;               /* parallel reporting data */
+  ISTJOB    *job;               /* to traverse the jobs */
+  int       r = 0;              /* error status */
+
+  assert(ist && rep);           /* check the function arguments */
+  root = ist->lvls[0];          /* get the root node of the tree */
+  if (root->offset < 0) return 1;
+  pex = (ist->mode & IST_PERFECT) ? ist->wgt : SUPP_MAX;
+  for (n = i = 0; i < root->size; i++) {
+    supp = COUNT(GETCNT(root, i));
+    if ((supp >= ist->supp) && (supp < pex)) n++;
+  }                             /* count the subtrees to report */
+  if (n < 2) return 1;          /* check for at least two subtrees */
+  work.jobs = (ISTJOB*)malloc((size_t)n *sizeof(ISTJOB));
+  if (!work.jobs) return -1;    /* create the job array */
+  if (mkthds(&work, ist, rep) < 0) {
+    free(work.jobs); return 1;} /* if the reporter cannot be cloned, */
+                                /* report the item sets plainly */
+  if (ist->mode & IST_PERFECT){ /* if perfect extension pruning */
+    for (k = 0; k < root->size; k++) {
+      if (COUNT(GETCNT(root, k)) < pex) continue;
+      isr_addpex(rep, ITEMAT(root, k));
+      for (c = 0; c < TA_THREADS; c++)
+        isr_addpex(work.thds[c].rep, ITEMAT(root, k));
+    }                           /* collect the perfect extensions */
+  }                             /* in the reporter and all clones */
+  if (!IS2SKIP(ist->wgt)        /* if the empty set is not marked */
+  &&  (ist->wgt <= ist->smax)   /* and does not exceed max. support, */
+  &&  (isr_report(rep) < 0))    /* report the empty item set */
+    r = -1;                     /* (with the original reporter) */
+  chn = (ISTNODE**)CNTEND(root);
+  ALIGN(chn);                   /* get the child node array */
+  c   = CHILDCNT(root);         /* and the number of children */
+  off = (c > 0) ? ITEMOF(chn[0]) : 0;
+  for (work.cnt = 0, i = 0; i < root->size; i++) {
+    supp = COUNT(GETCNT(root, i));
+    if ((supp < ist->supp) || (supp >= pex))
+      continue;                 /* traverse the frequent items */
+    job = work.jobs +work.cnt++;/* that are not perfect extensions */
+    job->index = i;             /* and set up a reporting job */
+    job->supp  = GETCNT(root, i);
+    k = ITEMAT(root, i) -off;   /* compute the child node index */
+    job->node  = ((k >= 0) && (k < c)) ? chn[k] : NULL;
+  }                             /* (jobs are in sequential order) */
+  runthds(&work, reporter);     /* report the subtrees */
+  for (job = work.jobs; job < work.jobs +work.cnt; job++)
+    if (isr_append(rep, job->rep, job->beg, job->end) < 0)
+      r = -1;                   /* write the output sections */
+  if (rmthds(&work, rep) < 0)   /* merge the counters of the clones */
+    r = -1;                     /* and delete the clones */
+  free(work.jobs);              /* delete the job array */
+  return r;                     /* return the error status */
+}  /* preport() */
+
+/*--------------------------------------------------------------------*/
+
+static void* ruler (void *data)
+{                               /* --- report rules of nodes (thread) */
+  ISTTHD   *thd  = (ISTTHD*)data;  /* data of this thread */
+  ISTWORK  *work = thd->work;   /* parallel reporting data */
+  ISTJOB   *job;                /* current node reporting job */
+
+  while (1) {                   /* while there are jobs left */
+    pthread_mutex_lock(&work->lock);
+    job = (work->next < work->cnt) ? work->jobs +work->next++ : NULL;
+    pthread_mutex_unlock(&work->lock);
+    if (!job) return NULL;      /* get the next job (if any) */
+    job->rep = thd->rep;        /* note the reporter and the start */
+    job->beg = isr_outpos(thd->rep);   /* of the output section */
+    if (rules(&thd->ist, thd->rep, job->node, thd->bnds) < 0)
+      thd->err = -1;            /* report the rules of the node */
+    job->end = isr_outpos(thd->rep);   /* note the end of the section */
+  }
+}  /* ruler() */
+
+/*--------------------------------------------------------------------*/
+
+static int prules (ISTREE *ist, ISREPORT *rep, ITEM size)
+{                               /* --- report rules with threads */
+  ITEM      k, m, n;            /* loop variables, number of nodes */
+  ISTNODE   *node;              /* to traverse the nodes of a level */
+  ISTWORK   work;               /* parallel reporting data */
+  ISTJOB    *job;               /* to traverse the jobs */
+  int       r = 0;              /* error status */
+
+  assert(ist && rep);           /* check the function arguments */
+  for (n = 0, k = size; (k >= ist->minsz) && (k > 0)
+  &&  (k <= ist->maxsz); k += ist->order) {
+    for (m = 0, node = ist->lvls[k-1]; node; node = node->succ) m++;
+    if (m > n) n = m;           /* determine the maximum number */
+  }                             /* of nodes on a level to process */
+  if (n < 2) return 1;          /* check for at least two nodes */
+  work.jobs = (ISTJOB*)malloc((size_t)n *sizeof(ISTJOB));
+  if (!work.jobs) return -1;    /* create the job array */
+  if (mkthds(&work, ist, rep) < 0) {
+    free(work.jobs); return 1;} /* if the reporter cannot be cloned, */
+                                /* report the rules plainly */
+  for (r = 0; (size >= ist->minsz) && (size > 0)
+  &&          (size <= ist->maxsz); size += ist->order) {
+    work.cnt = 0;               /* traverse the item set sizes */
+    for (node = ist->lvls[size-1]; node; node = node->succ)
+      work.jobs[work.cnt++].node = node;
+    runthds(&work, ruler);      /* report the rules of the nodes */
+    for (job = work.jobs; job < work.jobs +work.cnt; job++)
+      if (isr_append(rep, job->rep, job->beg, job->end) < 0)
+        r = -1;                 /* write the output sections */
+  }                             /* (in the sequential order) */
+  if (rmthds(&work, rep) < 0)   /* merge the counters of the clones */
+    r = -1;                     /* and delete the clones */
+  free(work.jobs);              /* delete the job array */
+  return r;                     /* return the error status */
+}  /* prules() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
 ptrdiff_t ist_report (ISTREE *ist, ISREPORT *rep)
 {                               /* --- recursive item set reporting */
+  int r = 1;                    /* result of parallel reporting */
+
+  assert(ist && rep);           /* check the function arguments */
+  #ifdef TA_THREADS             /* if to use multiple threads, */
+  r = preport(ist, rep);        /* report subtrees of the root */
+  #endif                        /* in parallel (if possible) */
+  if (r > 0)                    /* if not reported in parallel, */
+    r = report(ist, rep, ist->lvls[0], ist->wgt);
+  if (r < 0) return -1;         /* recursively report item sets */
+  return (ptrdiff_t)isr_repcnt(rep);
+}  /* ist_report() */           /* return the number of item sets */
+
+/*--------------------------------------------------------------------*/
+
+ptrdiff_t ist_rules (ISTREE *ist, ISREPORT *rep)
+{                               /* --- report association rules */
+  int     r = 1;                /* result of parallel reporting */
+  ITEM    size;                 /* size of the item sets */
+  ISTNODE *node;                /* to traverse the nodes of a level */
+  ISTNODE **bnds;               /* body nodes and item buffers */
+
   assert(ist && rep);           /* check the function arguments */
-  if (report(ist, rep, ist->lvls[0], ist->wgt) < 0) return -1;
+  ist_init(ist);                /* initialize the size range */
+  size = (ist->size != 0) ? ist->size : ist->order;
+  #ifdef TA_THREADS             /* if to use multiple threads, */
+  r = prules(ist, rep, size);   /* report the rules of the nodes */
+  #endif                        /* of each level in parallel */
+  if (r > 0) {                  /* if not reported in parallel */
+    bnds = (ISTNODE**)malloc((size_t)ist->maxht
+                            *(sizeof(ISTNODE*) +2*sizeof(ITEM)));
+    if (!bnds) return -1;       /* allocate body nodes and buffers */
+    for (r = 0; (size >= ist->minsz) && (size > 0)
+    &&          (size <= ist->maxsz) && (r >= 0); size += ist->order)
+      for (node = ist->lvls[size-1]; node && (r >= 0); node = node->succ)
+        r = rules(ist, rep, node, bnds);
+    free(bnds);                 /* report the rules of all nodes */
+  }                             /* and delete the buffers */
+  if (r < 0) return -1;         /* check for an error */
   return (ptrdiff_t)isr_repcnt(rep);
-}  /* ist_report() */           /* recursively report item sets */
+}  /* ist_rules() */            /* return the number of rules */
 
 /*--------------------------------------------------------------------*/
 
@@ -1911,6 +2994,8 @@ void ist_stats (ISTREE *ist)
   printf("number of child pointers   : %"SIZE_FMT"\n", ist->cpcnt);
   printf("necessary child pointers   : %"SIZE_FMT"\n", ist->cpnec);
   printf("pruned    child pointers   : %"SIZE_FMT"\n", ist->cpprn);
+  printf("bytes used by counters     : %"SIZE_FMT"\n", ist->cbcnt);
+  printf("bytes with full counters   : %"SIZE_FMT"\n", ist->cbfull);
 }  /* ist_stats() */
 
 #endif
@@ -1924,15 +3009,15 @@ static void showtree (ISTNODE *node, ITEMBASE *base, ITEM level)
 
   assert(node && (level >= 0)); /* check the function arguments */
   i   = (node->offset < 0) ? node->size : 0;
-  chn = (ISTNODE**)((ITEM*)(node->cnts +node->size) +i);
+  chn = (ISTNODE**)(ITEMMAP(node) +i);
   ALIGN(chn);                   /* get the child node array */
   cnt = CHILDCNT(node);         /* and the number of children */
   for (i = 0; i < node->size; i++) {
     for (k = level; --k >= 0; ) printf("   ");
     k = ITEMAT(node, i);        /* print item identifier and counter */
     printf("%s", ib_name(base, k));
-    printf("/%"ITEM_FMT": %"SUPP_FMT, k, COUNT(node->cnts[i]));
-    if (IS2SKIP(node->cnts[i])) printf("*");
+    printf("/%"ITEM_FMT": %"SUPP_FMT, k, COUNT(GETCNT(node, i)));
+    if (IS2SKIP(GETCNT(node, i))) printf("*");
     printf("\n");               /* print a skip flag indicator */
     if (cnt <= 0) continue;     /* check whether there are children */
     if (node->offset >= 0) k -= ITEMOF(chn[0]);
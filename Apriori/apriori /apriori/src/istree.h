@@ -40,6 +40,13 @@
             2011.08.16 filter mode ISR_GENERA added for ist_clomax()
             2013.03.30 adapted to type changes in module tract
             2013.10.15 return type of ist_report() changed to ptrdiff_t
+            2026.10.19 ISTNODE.width added (compact support counters)
+            2026.10.19 ISTREE.fetc added (log-factorials for FET)
+            2026.10.19 buffers for batch evaluation of a node added
+            2026.10.19 function ist_rules() added (rules node by node)
+            2026.10.19 pruning with optimistic evaluation bounds added
+            2026.10.19 hash index for support queries added
+            2026.10.19 critical value of chi^2 based p-values added
 ----------------------------------------------------------------------*/
 #ifndef __ISTREE__
 #define __ISTREE__
@@ -56,6 +63,8 @@
 ----------------------------------------------------------------------*/
 /* --- operation modes --- */
 #define IST_PERFECT 0x0100      /* prune with perfect extensions */
+#define IST_SETBND  0x0200      /* prune with eval. bounds (sets) */
+#define IST_RULEBND 0x0400      /* prune with eval. bounds (rules) */
 
 /* --- additional evaluation measures --- */
 /* most definitions in ruleval.h */
@@ -87,9 +96,16 @@ typedef struct istnode {        /* --- item set tree node --- */
   ITEM           size;          /* size   of counter array */
   ITEM           offset;        /* offset of counter array */
   ITEM           chcnt;         /* number of child nodes */
+  int            width;         /* width of a counter (in bytes) */
   SUPP           cnts[1];       /* counter array (weights) */
 } ISTNODE;                      /* (item set tree node) */
 
+typedef struct {                /* --- hash index slot --- */
+  ISTNODE        *node;         /* node containing the counter */
+  ITEM           index;         /* index of the counter in the node */
+  ITEM           fp;            /* fingerprint of the item set */
+} ISTSLOT;                      /* (hash index slot) */
+
 typedef struct {                /* --- item set tree --- */
   ITEMBASE *base;               /* underlying item base */
   int      mode;                /* search mode (e.g. support def.) */
@@ -104,8 +120,10 @@ typedef struct {                /* --- item set tree --- */
   int      eval;                /* additional evaluation measure */
   int      agg;                 /* aggregation mode of measure values */
   int      invbxs;              /* invalidate eval. below expectation */
+  int      bound;               /* heads for evaluation bounds */
   double   dir;                 /* direction of evaluation measure */
   double   thresh;              /* evaluation measure threshold */
+  double   crit;                /* critical value of test statistic */
   double   minimp;              /* minimal improvement of measure */
   ISTNODE  *curr;               /* current node for traversal */
   ITEM     size;                /* current size of an item set */
@@ -121,6 +139,11 @@ typedef struct {                /* --- item set tree --- */
   ITEM     *path;               /* current path / (partial) item set */
   int      hdonly;              /* head only item in current set */
   ITEM     *map;                /* to create identifier maps */
+  double   *vals;               /* buffer for measure values of a node */
+  FETCACHE *fetc;               /* log-factorials for Fisher's test */
+  SUPP     *sups;               /* buffer for supports (set/body/head) */
+  ISTSLOT  *hash;               /* hash index of the item sets */
+  size_t   hmsk;                /* bit mask for the hash index size */
 #ifdef BENCH                    /* if benchmark version */
   size_t   ndcnt;               /* number of item set tree nodes */
   size_t   ndprn;               /* number of pruned tree nodes */
@@ -131,6 +154,8 @@ typedef struct {                /* --- item set tree --- */
   size_t   cpcnt;               /* number of created child pointers */
   size_t   cpnec;               /* number of necessary child pointers */
   size_t   cpprn;               /* number of pruned child pointers */
+  size_t   cbcnt;               /* number of bytes used by counters */
+  size_t   cbfull;              /* bytes needed with full counters */
 #endif
 } ISTREE;                       /* (item set tree) */
 
@@ -164,6 +189,13 @@ extern int       ist_down    (ISTREE *ist, ITEM item);
 extern ITEM      ist_next    (ISTREE *ist, ITEM item);
 extern SUPP      ist_supp    (ISTREE *ist, ITEM item);
 extern SUPP      ist_suppx   (ISTREE *ist, ITEM *items, ITEM cnt);
+/* ist_index() and ist_suppxs() are not called by the programs in */
+/* this directory: they are meant for library users that query the */
+/* supports of many item sets in the tree after the search.        */
+extern int       ist_index   (ISTREE *ist);
+extern int       ist_suppxs  (ISTREE *ist, const ITEM *items,
+                              const size_t *offs, size_t cnt,
+                              SUPP *supps);
 
 extern void      ist_clear   (ISTREE *ist);
 extern void      ist_filter  (ISTREE *ist, ITEM size);
@@ -180,6 +212,7 @@ extern ITEM      ist_rule    (ISTREE *ist, ITEM *rule,  SUPP *supp,
                               SUPP *body, SUPP *head, double *eval);
 
 extern ptrdiff_t ist_report  (ISTREE *ist, ISREPORT *rep);
+extern ptrdiff_t ist_rules   (ISTREE *ist, ISREPORT *rep);
 extern double    ist_eval    (ISTREE *ist);
 extern double    ist_evalx   (ISREPORT *rep, void *data);
 
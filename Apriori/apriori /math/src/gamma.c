@@ -7,6 +7,7 @@
             2008.03.14 more incomplete Gamma functions added
             2008.03.15 table of factorials and logarithms added
             2008.03.17 gamma distribution functions added
+            2026.10.19 table initialization with pthread_once()
 ----------------------------------------------------------------------*/
 #if defined GAMMA_MAIN \
  || defined GAMMAPDF_MAIN \
@@ -25,6 +26,9 @@
 #include "normal.h"
 #endif
 #include "gamma.h"
+#ifdef TA_THREADS
+#include <pthread.h>
+#endif
 
 #ifndef INFINITY
 #define INFINITY     (DBL_MAX+DBL_MAX)
@@ -44,6 +48,12 @@
 #define MAXITER      1024
 #define TINY         (EPSILON *EPSILON *EPSILON)
 
+#ifdef TA_THREADS               /* initialize the tables only once, */
+#define INIT()       pthread_once(&once, init)  /* even with threads */
+#else
+#define INIT()       if (facts[0] <= 0) init()
+#endif
+
 /*----------------------------------------------------------------------
   Table of Factorials/Gamma Values
 ----------------------------------------------------------------------*/
@@ -51,6 +61,9 @@ static double facts[MAXFACT+1] = { 0 };
 static double logfs[MAXFACT+1];
 static double halfs[MAXFACT+1];
 static double loghs[MAXFACT+1];
+#ifdef TA_THREADS
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+#endif
 
 /*----------------------------------------------------------------------
   Functions
@@ -83,7 +96,7 @@ double logGamma (double n)
   double s;                     /*           = ln((n-1)!), n \in IN */
 
   assert(n > 0);                /* check the function argument */
-  if (facts[0] <= 0) init();    /* initialize the tables */
+  INIT();                       /* initialize the tables */
   if (n < MAXFACT +1 +4 *EPSILON) {
     if (fabs(  n -floor(  n)) < 4 *EPSILON)
       return logfs[(int)floor(n)-1];
@@ -107,7 +120,7 @@ double logGamma (double n)
   double s;                     /*           = ln((n-1)!), n \in IN */
 
   assert(n > 0);                /* check the function argument */
-  if (facts[0] <= 0) init();    /* initialize the tables */
+  INIT();                       /* initialize the tables */
   if (n < MAXFACT +1 +4 *EPSILON) {
     if (fabs(  n -floor(  n)) < 4 *EPSILON)
       return logfs[(int)floor(n)-1];
@@ -151,7 +164,7 @@ in the second version, the value is slightly more accurate.
 double Gamma (double n)
 {                               /* --- compute Gamma(n) = (n-1)! */
   assert(n > 0);                /* check the function argument */
-  if (facts[0] <= 0) init();    /* initialize the tables */
+  INIT();                       /* initialize the tables */
   if (n < MAXFACT +1 +4 *EPSILON) {
     if (fabs(  n -floor(  n)) < 4 *EPSILON)
       return facts[(int)floor(n)-1];
@@ -6,10 +6,17 @@
             2011.08.03 bug in re_fetprob fixed (roundoff error corr.)
             2012.02.15 function re_supp() added (rule support)
             2013.03.29 adapted to type changes in module tract (SUPP)
+            2026.10.19 log-factorial table and ratio recurrence for FET
+            2026.10.19 function re_eval_batch() added (batch evaluation)
+            2026.10.19 function re_bound() added (optimistic bounds)
+            2026.10.19 functions re_pcrit() and re_pcut() added
 ----------------------------------------------------------------------*/
 #include <stdio.h>
 #include <stdlib.h>
 #include <float.h>
+#ifdef RULEVAL_MAIN
+#include <time.h>
+#endif
 #include <math.h>
 #include <assert.h>
 #include "gamma.h"
@@ -20,6 +27,33 @@
   Preprocessor Definitions
 ----------------------------------------------------------------------*/
 #define LN_2        0.69314718055994530942  /* ln(2) */
+#define BNDTOL      1e-9        /* relative tolerance of bounds */
+#define CRITEPS     1e-9        /* rel. tolerance of critical values */
+
+#define int         1           /* to check definition */
+#define long        2           /* of support type */
+#define ptrdiff_t   3
+#define double      4
+
+#if SUPP==int || SUPP==long || SUPP==ptrdiff_t
+#define INTSUPP     1           /* set   integer support flag */
+#elif SUPP==double
+#define INTSUPP     0           /* clear integer support flag */
+#else
+#error "SUPP must be either 'int', 'long', 'ptrdiff_t' or 'double'"
+#endif
+
+#undef int                      /* remove preprocessor definitions */
+#undef long                     /* needed for the type checking */
+#undef ptrdiff_t
+#undef double
+
+#if INTSUPP                     /* log-factorials from table or Gamma */
+#define LOGFACT(n)  (((n) < fc->cnt) ? fc->logfs[n] \
+                                     : logGamma((double)(n)+1))
+#else                           /* (table only for integer support) */
+#define LOGFACT(n)  logGamma((double)(n)+1)
+#endif
 
 /*----------------------------------------------------------------------
   Type Definitions
@@ -29,6 +63,11 @@ typedef struct {                /* --- rule evaluation info. --- */
   int       dir;                /* evaluation direction */
 } REINFO;                       /* (rule evaluation information) */
 
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+static const FETCACHE nocache = { 0, { 0 } };  /* empty table */
+
 /*----------------------------------------------------------------------
   Rule Evaluation Measures
 ----------------------------------------------------------------------*/
@@ -205,13 +244,97 @@ double re_infopval (SUPP supp, SUPP body, SUPP head, SUPP base)
 
 /*--------------------------------------------------------------------*/
 
-double re_fetprob (SUPP supp, SUPP body, SUPP head, SUPP base)
+/*----------------------------------------------------------------------
+  Fisher's Exact Test: Auxiliary Functions
+----------------------------------------------------------------------*/
+
+FETCACHE* re_fetcache (SUPP n)
+{                               /* --- create a log-factorial table */
+  FETCACHE *fc;                 /* created table of log-factorials */
+  #if INTSUPP                   /* if integer support type */
+  SUPP     i;                   /* loop variable */
+
+  if (n < 0) n = 0;             /* table for ln(0!) to ln(n!) */
+  if ((size_t)n >= (size_t)-1/sizeof(double) -1) return NULL;
+  fc = (FETCACHE*)malloc(sizeof(FETCACHE) +(size_t)n *sizeof(double));
+  if (!fc) return NULL;         /* allocate the table */
+  for (i = 0; i <= n; i++)      /* fill the table with ln(i!) */
+    fc->logfs[i] = logGamma((double)i+1);
+  fc->cnt = n+1;                /* note the number of entries */
+  #else                         /* if real-valued support type */
+  fc = (FETCACHE*)malloc(sizeof(FETCACHE));
+  if (!fc) return NULL;         /* create an empty table */
+  fc->cnt = 0;                  /* (no table for double support, */
+  #endif                        /* functions use logGamma()) */
+  return fc;                    /* return the created table */
+}  /* re_fetcache() */
+
+/*--------------------------------------------------------------------*/
+
+void re_fetdelete (FETCACHE *fc)
+{                               /* --- delete a log-factorial table */
+  assert(fc);                   /* check the function argument */
+  free(fc);                     /* delete the table */
+}  /* re_fetdelete() */
+
+/* A log-factorial table is owned by its creator (e.g. an item set */
+/* tree, see ist_seteval()) and is never changed after it has been */
+/* filled, so that several threads may read it. The Fisher's exact */
+/* test functions accept a null pointer instead of a table, in which */
+/* case (as for arguments beyond the table) they use logGamma().   */
+
+/*--------------------------------------------------------------------*/
+
+static double logp (SUPP supp, SUPP body, SUPP head, SUPP rest,
+                    double com, const FETCACHE *fc)
+{                               /* --- log. prob. of a conting. table */
+  return com -LOGFACT(body-supp) -LOGFACT(head-supp)
+             -LOGFACT(supp)      -LOGFACT(rest+supp);
+}  /* logp() */
+
+/*--------------------------------------------------------------------*/
+
+static double tail (SUPP supp, SUPP end, SUPP body, SUPP head,
+                    SUPP rest, double com, const FETCACHE *fc)
+{                               /* --- sum probabilities of a tail */
+  double p, sum;                /* table probability and sum */
+
+  /* The tables supp..end are traversed away from the mode, so   */
+  /* that the probabilities decrease and can be computed from the */
+  /* ratio of consecutive hypergeometric probabilities (no under- */
+  /* flow of the start value can hide larger values). The loop    */
+  /* stops when the remaining terms cannot change the sum anymore. */
+  sum = p = exp(logp(supp, body, head, rest, com, fc));
+  if (supp <= end) {            /* if to traverse upward */
+    while (supp < end) {        /* P(s+1)/P(s) = (b-s)(h-s)/(s+1)(r+s+1) */
+      p *= (double)(body-supp) *(double)(head-supp)
+        / ((double)(supp+1)    *(double)(rest+supp+1));
+      supp++; sum += p;         /* compute the next table probability */
+      if (p <= sum *DBL_EPSILON) break;
+    } }                         /* sum the table probabilities */
+  else {                        /* if to traverse downward */
+    while (supp > end) {        /* P(s-1)/P(s) = s(r+s)/(b-s+1)(h-s+1) */
+      p *= (double)supp         *(double)(rest+supp)
+        / ((double)(body-supp+1)*(double)(head-supp+1));
+      supp--; sum += p;         /* compute the next table probability */
+      if (p <= sum *DBL_EPSILON) break;
+    }                           /* sum the table probabilities */
+  }                             /* (terms are negligible or zero) */
+  return sum;                   /* return the probability sum */
+}  /* tail() */
+
+/*--------------------------------------------------------------------*/
+
+double re_fetprob (SUPP supp, SUPP body, SUPP head, SUPP base,
+                   const FETCACHE *fc)
 {                               /* --- Fisher's exact test (prob.) */
   SUPP   rest, n;               /* counter for rest cases, buffer */
+  SUPP   mode, lo, hi;          /* mode and range of binary search */
   double com;                   /* common probability term */
-  double cut, p;                /* (cutoff value for) probability */
+  double cut;                   /* cutoff value for probability */
   double sum;                   /* probability sum of conting. tables */
 
+  if (!fc) fc = &nocache;       /* get the log-factorial table */
   if ((head <= 0) || (head >= base)
   ||  (body <= 0) || (body >= base))
     return 1;                   /* check for non-vanishing marginals */
@@ -222,39 +345,44 @@ double re_fetprob (SUPP supp, SUPP body, SUPP head, SUPP base)
   }                             /* complement/exchange the marginals */
   if (head < body) {            /* ensure that body <= head */
     n = head; head = body; body = n; }
-  com = logGamma((double)(     head+1))
-      + logGamma((double)(     body+1))
-      + logGamma((double)(base-head+1))
-      + logGamma((double)(base-body+1))
-      - logGamma((double)(base+1));/* compute common probability term */
-  cut = com                     /* and log of the cutoff probability */
-      - logGamma((double)(body-supp+1))
-      - logGamma((double)(head-supp+1))
-      - logGamma((double)(     supp+1))
-      - logGamma((double)(rest+supp+1));
-  cut *= 1.0-DBL_EPSILON;       /* adapt for roundoff errors */
-  /* cut must be multiplied with a value < 1 in order to increase it, */
-  /* because it is the logarithm of a probability and hence negative. */
-  for (sum = 0, supp = 0; supp <= body; supp++) {
-    p = com                     /* traverse the contingency tables */
-      - logGamma((double)(body-supp+1))
-      - logGamma((double)(head-supp+1))
-      - logGamma((double)(     supp+1))
-      - logGamma((double)(rest+supp+1));
-    if (p <= cut) sum += exp(p);/* sum probabilities greater */
-  }                             /* than the cutoff probability */
+  com = LOGFACT(head) +LOGFACT(base-head)
+      + LOGFACT(body) +LOGFACT(base-body)
+      - LOGFACT(base);          /* compute common probability term */
+  cut = logp(supp, body, head, rest, com, fc);
+  cut += 16*DBL_EPSILON *(LOGFACT(base) -cut);
+  /* The cutoff is increased to adapt for roundoff errors, which are */
+  /* bounded by the size of the log-factorials that are combined.   */
+  mode = (SUPP)floor(((double)body+1) *((double)head+1)
+                    /((double)base+2));
+  if (mode > body) mode = body; /* compute the mode of the distrib. */
+  /* The probabilities do not decrease up to the mode and do not   */
+  /* increase after it, so the tables with a probability not greater */
+  /* than the cutoff form two tails, which are found by bisection.  */
+  /* The observed table always belongs to one of the two tails.     */
+  lo = (supp <= mode) ? supp : -1;
+  for (hi = mode+1; hi-lo > 1; ) {
+    n = (SUPP)floor(0.5*(double)(lo+hi)); /* last of lower tail */
+    if (logp(n, body, head, rest, com, fc) <= cut) lo = n; else hi = n; }
+  sum = (lo >= 0) ? tail(lo, 0, body, head, rest, com, fc) : 0;
+  hi = (supp >  mode) ? supp : body+1;
+  for (lo = mode; hi-lo > 1; ) {
+    n = (SUPP)floor(0.5*(double)(lo+hi)); /* first of upper tail */
+    if (logp(n, body, head, rest, com, fc) <= cut) hi = n; else lo = n; }
+  if (hi <= body) sum += tail(hi, body, body, head, rest, com, fc);
   return sum;                   /* return computed probability */
 }  /* re_fetprob() */
 
 /*--------------------------------------------------------------------*/
 
-double re_fetchi2 (SUPP supp, SUPP body, SUPP head, SUPP base)
+double re_fetchi2 (SUPP supp, SUPP body, SUPP head, SUPP base,
+                   const FETCACHE *fc)
 {                               /* --- Fisher's exact test (chi^2) */
   SUPP   rest, n;               /* counter for rest cases, buffer */
   double com;                   /* common probability term */
   double exs;                   /* expected support value */
   double sum;                   /* probability sum of conting. tables */
 
+  if (!fc) fc = &nocache;       /* get the log-factorial table */
   if ((head <= 0) || (head >= base)
   ||  (body <= 0) || (body >= base))
     return 1;                   /* check for non-vanishing marginals */
@@ -265,50 +393,33 @@ double re_fetchi2 (SUPP supp, SUPP body, SUPP head, SUPP base)
   }                             /* complement/exchange the marginals */
   if (head < body) {            /* ensure that body <= head */
     n = head; head = body; body = n; }
-  com = logGamma((double)(     head+1))
-      + logGamma((double)(     body+1))
-      + logGamma((double)(base-head+1))
-      + logGamma((double)(base-body+1))
-      - logGamma((double)(base+1));/* compute common probability term */
+  com = LOGFACT(head) +LOGFACT(base-head)
+      + LOGFACT(body) +LOGFACT(base-body)
+      - LOGFACT(base);          /* compute common probability term */
   exs = (double)head *(double)body /(double)base;
   if ((double)supp < exs)
        { n =              (SUPP)ceil (exs+(exs-(double)supp)); }
   else { n = supp; supp = (SUPP)floor(exs-((double)supp-exs)); }
   if (n > body) n = body+1;     /* compute the range of values and */
   if (supp < 0) supp = -1;      /* clamp it to the possible maximum */
-  if (n-supp-4 < supp+body-n) { /* if fewer less extreme tables */
-    for (sum = 1; ++supp < n;){ /* traverse the less extreme tables */
-      sum -= exp(com -logGamma((double)(body-supp+1))
-                     -logGamma((double)(head-supp+1))
-                     -logGamma((double)(     supp+1))
-                     -logGamma((double)(rest+supp+1)));
-    } }                         /* sum the probability of the tables */
-  else {                        /* if fewer more extreme tables */
-    for (sum = 0; supp >= 0; supp--) {
-      sum += exp(com -logGamma((double)(body-supp+1))
-                     -logGamma((double)(head-supp+1))
-                     -logGamma((double)(     supp+1))
-                     -logGamma((double)(rest+supp+1)));
-    }                           /* traverse the more extreme tables */
-    for (supp = n; supp <= body; supp++) {
-      sum += exp(com -logGamma((double)(body-supp+1))
-                     -logGamma((double)(head-supp+1))
-                     -logGamma((double)(     supp+1))
-                     -logGamma((double)(rest+supp+1)));
-    }                           /* sum the probability of the tables */
-  }                             /* (upper and lower table ranges) */
-  return sum;                   /* return computed probability */
-}  /* re_fetchi2() */
+  if (supp >= n) return 1;      /* check for all tables being counted */
+  sum = (supp >= 0) ? tail(supp, 0, body, head, rest, com, fc) : 0;
+  if (n <= body) sum += tail(n, body, body, head, rest, com, fc);
+  return sum;                   /* sum the probabilities of the more */
+}  /* re_fetchi2() */           /* extreme tables (both tails) */
 
 /*--------------------------------------------------------------------*/
 
-double re_fetinfo (SUPP supp, SUPP body, SUPP head, SUPP base)
+double re_fetinfo (SUPP supp, SUPP body, SUPP head, SUPP base,
+                   const FETCACHE *fc)
 {                               /* --- Fisher's exact test (info.) */
   SUPP   rest, n;               /* counter for rest cases, buffer */
+  SUPP   lo, hi, x;             /* range of binary search, center */
   double com;                   /* common probability term */
   double cut;                   /* cutoff value for information gain */
   double sum;                   /* probability sum of conting. tables */
 
+  if (!fc) fc = &nocache;       /* get the log-factorial table */
   if ((head <= 0) || (head >= base)
   ||  (body <= 0) || (body >= base))
     return 1;                   /* check for non-vanishing marginals */
@@ -319,30 +430,38 @@ double re_fetinfo (SUPP supp, SUPP body, SUPP head, SUPP base)
   }                             /* complement/exchange the marginals */
   if (head < body) {            /* ensure that body <= head */
     n = head; head = body; body = n; }
-  com = logGamma((double)(     head+1))
-      + logGamma((double)(     body+1))
-      + logGamma((double)(base-head+1))
-      + logGamma((double)(base-body+1))
-      - logGamma((double)(base+1));/* compute common probability term */
-  cut = re_info(supp, body, head, base) *(1.0-DBL_EPSILON);
-  for (sum = 0, supp = 0; supp <= body; supp++) {
-    if (re_info(supp, body, head, base) >= cut)
-      sum += exp(com -logGamma((double)(body-supp+1))
-                     -logGamma((double)(head-supp+1))
-                     -logGamma((double)     (supp+1))
-                     -logGamma((double)(rest+supp+1)));
-  }                             /* sum probs. of less extreme tables */
+  com = LOGFACT(head) +LOGFACT(base-head)
+      + LOGFACT(body) +LOGFACT(base-body)
+      - LOGFACT(base);          /* compute common probability term */
+  cut = re_info(supp, body, head, base)
+      - 16*DBL_EPSILON *log((double)base);  /* adapt for roundoff */
+  x   = (SUPP)floor((double)head *(double)body /(double)base);
+  if (x > body) x = body;       /* get the (floored) expected support */
+  /* The information gain does not increase up to the expected    */
+  /* support and does not decrease after it, so the tables with an  */
+  /* information gain not less than the cutoff form two tails.      */
+  lo = (supp <= x) ? supp : -1;
+  for (hi = x+1; hi-lo > 1; ) {
+    n = (SUPP)floor(0.5*(double)(lo+hi)); /* last of lower tail */
+    if (re_info(n, body, head, base) >= cut) lo = n; else hi = n; }
+  sum = (lo >= 0) ? tail(lo, 0, body, head, rest, com, fc) : 0;
+  hi = (supp >  x) ? supp : body+1;
+  for (lo = x; hi-lo > 1; ) {
+    n = (SUPP)floor(0.5*(double)(lo+hi)); /* first of upper tail */
+    if (re_info(n, body, head, base) >= cut) hi = n; else lo = n; }
+  if (hi <= body) sum += tail(hi, body, body, head, rest, com, fc);
   return sum;                   /* return computed probability */
 }  /* re_fetinfo() */
 
 /*--------------------------------------------------------------------*/
 
-double re_fetsupp (SUPP supp, SUPP body, SUPP head, SUPP base)
+double re_fetsupp (SUPP supp, SUPP body, SUPP head, SUPP base,
+                   const FETCACHE *fc)
 {                               /* --- Fisher's exact test (support) */
   SUPP   rest, n;               /* counter for rest cases, buffer */
   double com;                   /* common probability term */
-  double sum;                   /* probability sum of conting. tables */
 
+  if (!fc) fc = &nocache;       /* get the log-factorial table */
   if ((head <= 0) || (head >= base)
   ||  (body <= 0) || (body >= base))
     return 1;                   /* check for non-vanishing marginals */
@@ -353,26 +472,34 @@ double re_fetsupp (SUPP supp, SUPP body, SUPP head, SUPP base)
   }                             /* complement/exchange the marginals */
   if (head < body) {            /* ensure that body <= head */
     n = head; head = body; body = n; }
-  com = logGamma((double)(     head+1))
-      + logGamma((double)(     body+1))
-      + logGamma((double)(base-head+1))
-      + logGamma((double)(base-body+1))
-      - logGamma((double)(base+1));/* compute common probability term */
-  if (supp <= body -supp) {     /* if fewer lesser support values */
-    for (sum = 1.0; --supp >= 0; )
-      sum -= exp(com -logGamma((double)(body-supp+1))
-                     -logGamma((double)(head-supp+1))
-                     -logGamma((double)(     supp+1))
-                     -logGamma((double)(rest+supp+1))); }
-  else {                        /* if fewer greater support values */
-    for (sum = 0.0; supp <= body; supp++)
-      sum += exp(com -logGamma((double)(body-supp+1))
-                     -logGamma((double)(head-supp+1))
-                     -logGamma((double)(     supp+1))
-                     -logGamma((double)(rest+supp+1)));
-  }                             /* sum the table probabilities */
-  return sum;                   /* return computed probability */
-}  /* re_fetsupp() */
+  if (supp <= 0) return 1;      /* all tables have at least supp */
+  com = LOGFACT(head) +LOGFACT(base-head)
+      + LOGFACT(body) +LOGFACT(base-body)
+      - LOGFACT(base);          /* compute common probability term */
+  n = (SUPP)floor(((double)body+1) *((double)head+1)
+                 /((double)base+2));  /* compute the mode */
+  if (supp > n)                 /* if above the mode, sum upper tail */
+    return tail(supp, body, body, head, rest, com, fc);
+  return 1.0 -tail(supp-1, 0, body, head, rest, com, fc);
+}  /* re_fetsupp() */           /* otherwise subtract lower tail */
+
+/*--------------------------------------------------------------------*/
+
+static double fetprob (SUPP supp, SUPP body, SUPP head, SUPP base)
+{ return re_fetprob(supp, body, head, base, NULL); }
+
+static double fetchi2 (SUPP supp, SUPP body, SUPP head, SUPP base)
+{ return re_fetchi2(supp, body, head, base, NULL); }
+
+static double fetinfo (SUPP supp, SUPP body, SUPP head, SUPP base)
+{ return re_fetinfo(supp, body, head, base, NULL); }
+
+static double fetsupp (SUPP supp, SUPP body, SUPP head, SUPP base)
+{ return re_fetsupp(supp, body, head, base, NULL); }
+
+/* The functions in the table of evaluation functions (see below)  */
+/* do not use a log-factorial table; re_eval() evaluates a measure */
+/* with a given table of log-factorials.                           */
 
 /*--------------------------------------------------------------------*/
 
@@ -394,10 +521,10 @@ static const REINFO reinfo[] ={ /* --- rule evaluation functions */
   /* RE_YATESPVAL 14 */  { re_yatespval, -1 },
   /* RE_INFO      15 */  { re_info,      +1 },
   /* RE_INFOPVAL  16 */  { re_infopval,  -1 },
-  /* RE_FETPROB   17 */  { re_fetprob,   -1 },
-  /* RE_FETCHI2   18 */  { re_fetchi2,   -1 },
-  /* RE_FETINFO   19 */  { re_fetinfo,   -1 },
-  /* RE_FETSUPP   20 */  { re_fetsupp,   -1 },
+  /* RE_FETPROB   17 */  { fetprob,      -1 },
+  /* RE_FETCHI2   18 */  { fetchi2,      -1 },
+  /* RE_FETINFO   19 */  { fetinfo,      -1 },
+  /* RE_FETSUPP   20 */  { fetsupp,      -1 },
 };                              /* table of evaluation functions */
 
 /*--------------------------------------------------------------------*/
@@ -415,3 +542,278 @@ int re_dir (int id)
   assert((id >= 0) && (id <= RE_FNCNT));
   return reinfo[id].dir;        /* retrieve direction from table */
 }  /* re_dir() */
+
+/*--------------------------------------------------------------------*/
+
+double re_eval (int id, SUPP supp, SUPP body, SUPP head, SUPP base,
+                const FETCACHE *fc)
+{                               /* --- evaluate a single rule */
+  assert((id >= 0) && (id <= RE_FNCNT));
+  switch (id) {                 /* evaluate the measure */
+    case RE_FETPROB: return re_fetprob(supp, body, head, base, fc);
+    case RE_FETCHI2: return re_fetchi2(supp, body, head, base, fc);
+    case RE_FETINFO: return re_fetinfo(supp, body, head, base, fc);
+    case RE_FETSUPP: return re_fetsupp(supp, body, head, base, fc);
+    default:         return reinfo[id].fn(supp, body, head, base);
+  }                             /* (only Fisher's exact tests use */
+}  /* re_eval() */              /* the table of log-factorials) */
+
+/*--------------------------------------------------------------------*/
+
+double re_bound (int id, SUPP supp, SUPP head, SUPP base, int pos,
+                 const FETCACHE *fc)
+{                               /* --- optimistic bound of a measure */
+  SUPP   s, h;                  /* support and head support */
+  double n, t;                  /* base support, bound value */
+
+  assert((id >= 0) && (id <= RE_FNCNT));
+  if (!fc) fc = &nocache;       /* get the log-factorial table */
+  if (head > base) head = base; /* clamp the head support */
+  h = head;                     /* get the head support with the */
+  if (h < supp) {               /* best value if the body support */
+    h = base/2;                 /* equals the rule support: the */
+    if (h < head) h = head;     /* smallest possible one, or, if */
+    if (h > supp) h = supp;     /* the rule support is larger, the */
+  }                             /* one closest to base/2 */
+  s = (supp < h) ? supp : h;    /* get the matching rule support */
+  n = (double)base;             /* and the base support as a double */
+  switch (id) {                 /* evaluate the measure */
+    case RE_SUPP:     t = (double)supp;                         break;
+    case RE_CONF:     t = 1;                                    break;
+    case RE_CONFDIFF: t = (pos) ? 1 -(double)head/n : 1;        break;
+    case RE_LIFT:     t = (head > 0) ? n/(double)head : INFINITY; break;
+    case RE_LIFTDIFF: t = (head > 0) ? n/(double)head -1 : INFINITY;
+                      if (!pos && (t < 1)) t = 1;
+                      break;
+    case RE_LIFTQUOT: t = (pos) ? 1 -(double)head/n : 1;        break;
+    case RE_CVCT:     case RE_CVCTDIFF: case RE_CVCTQUOT:
+      #if INTSUPP               /* (body support at least supp+1) */
+      t = ((double)supp+1) *(n-(double)head) /n;
+      #else                     /* (body support may be arbitrarily */
+      t = INFINITY;             /* close to the rule support) */
+      #endif
+      if      (id == RE_CVCTDIFF) t -= 1;
+      else if (id == RE_CVCTQUOT) t  = (pos) ? 1 -1/t : 1;
+      if (!pos && (t < 1)) t = 1;
+      break;
+    case RE_CERT:     t = 1;                                    break;
+    case RE_CHI2:     t = (pos) ? re_chi2(s, s, h, base) : 1;   break;
+    case RE_CHI2PVAL: t = (pos) ? re_chi2(s, s, h, base) : 1;
+                      t = chi2cdfQ(n *t, 1);                    break;
+    case RE_INFO:     case RE_INFOPVAL:
+      if (!pos) {               /* at most the head entropy */
+        h = (head > base/2) ? head : base/2; s = h; }
+      t = re_info(s, s, h, base);
+      if (id == RE_INFOPVAL) t = chi2cdfQ(2*LN_2 *n *((t > 0) ? t:0), 1);
+      break;
+    case RE_FETPROB:  case RE_FETCHI2:
+    case RE_FETINFO:  case RE_FETSUPP:
+      t = (pos) ? exp(LOGFACT(h) -LOGFACT(h-s)
+                     +LOGFACT(base-s) -LOGFACT(base)) : 0; break;
+    default:          t = (reinfo[id].dir < 0) ? 0 : INFINITY; break;
+  }                             /* (no bound for Yates' correction) */
+  if (reinfo[id].dir < 0)       /* widen the bound for roundoff */
+    return t *(1-BNDTOL);       /* (not below the values 0 and 1 */
+  return (t > 0) ? t *(1+BNDTOL) : 0;  /* of invalidated rules) */
+}  /* re_bound() */
+
+/* re_bound() returns a value that no rule with a support of at most */
+/* supp and a head support of at least head can exceed (in the      */
+/* direction of the measure). If pos is set, only rules with a      */
+/* support above the expected value are considered (the others are  */
+/* assumed to be invalidated by the caller). For a fixed support    */
+/* and head support the measures are best if the body support       */
+/* equals the rule support, and they do not get worse if both are   */
+/* increased. For the tests, the p-value is at least the probability */
+/* of the table with this body support (which is C(h,s)/C(n,s)).    */
+
+/*--------------------------------------------------------------------*/
+
+double re_pcrit (int id, double thresh)
+{                               /* --- critical value of a statistic */
+  double lo, hi, x;             /* range of bisection, center */
+
+  if (((id != RE_CHI2PVAL) && (id != RE_YATESPVAL)
+  &&   (id != RE_INFOPVAL))     /* check for a chi^2 based p-value */
+  ||  (thresh <= 0) || (thresh >= 1))
+    return 0;                   /* and a proper significance level */
+  for (lo = 0, hi = 1; chi2cdfQ(hi, 1) > thresh; hi += hi)
+    lo = hi;                    /* find an upper bound for the value */
+  while (hi -lo > CRITEPS *hi){ /* bisect the range of values */
+    x = 0.5 *(lo+hi);           /* (p-value is decreasing) */
+    if (chi2cdfQ(x, 1) > thresh) lo = x; else hi = x;
+  }                             /* statistic values below lo are */
+  return lo *(1-CRITEPS);       /* certainly not significant */
+}  /* re_pcrit() */
+
+/*--------------------------------------------------------------------*/
+
+double re_pcut (int id, SUPP supp, SUPP body, SUPP head, SUPP base,
+                double crit, const FETCACHE *fc)
+{                               /* --- p-value with critical value */
+  double x;                     /* value of the test statistic */
+
+  switch (id) {                 /* compute the test statistic */
+    case RE_CHI2PVAL:  x = (double)base *re_chi2 (supp,body,head,base);
+                       break;
+    case RE_YATESPVAL: x = (double)base *re_yates(supp,body,head,base);
+                       break;
+    case RE_INFOPVAL:  x = 2*LN_2 *(double)base
+                             *re_info(supp, body, head, base);
+                       break;
+    default:           return re_eval(id, supp, body, head, base, fc);
+  }                             /* (other measures: evaluate plainly) */
+  return (x < crit) ? 1 : chi2cdfQ(x, 1);
+}  /* re_pcut() */              /* compute p-value only if needed */
+
+/* The p-values of the chi^2 and the G statistic (information gain) */
+/* are computed with chi2cdfQ() and thus with an incomplete Gamma    */
+/* function (series or continued fraction), which is costly. Since   */
+/* the p-value decreases with the statistic, a rule is significant   */
+/* only if the statistic reaches the critical value re_pcrit(), which */
+/* needs to be computed only once for a significance level. Below it, */
+/* re_pcut() returns 1 instead of the actual p-value (the critical    */
+/* value is slightly lowered, so that no significant rule is missed), */
+/* above it exactly the same value as the p-value functions.          */
+
+/*--------------------------------------------------------------------*/
+
+void re_eval_batch (int id, const SUPP *supp, const SUPP *body,
+                    const SUPP *head, SUPP base, double *out, size_t n,
+                    const FETCACHE *fc)
+{                               /* --- evaluate a batch of rules */
+  size_t    i;                  /* loop variable */
+  double    b, p, t;            /* temporary buffers */
+  RULEVALFN *fn;                /* rule evaluation function */
+
+  assert(supp && body && head && out);
+  /* The loops for the closed-form measures contain no calls, so   */
+  /* that the compiler can vectorize them (with gcc this requires   */
+  /* -fno-trapping-math, see makefile, because the selections would */
+  /* otherwise have to preserve floating-point exceptions). They    */
+  /* compute the same expressions as the evaluation functions.      */
+  b = (double)base;             /* get the base support as a double */
+  switch (id) {                 /* evaluate the measure */
+    case RE_SUPP:               /* rule support */
+      for (i = 0; i < n; i++)
+        out[i] = (double)supp[i];
+      break;
+    case RE_CONF:               /* rule confidence */
+      for (i = 0; i < n; i++) {
+        t = (double)supp[i]/(double)body[i];
+        out[i] = (body[i] > 0) ? t : 0;
+      } break;
+    case RE_LIFT:               /* lift value */
+      for (i = 0; i < n; i++) {
+        t = ((double)supp[i]*b) /((double)body[i]*(double)head[i]);
+        out[i] = ((body[i] <= 0) || (head[i] <= 0)) ? 0 : t;
+      } break;
+    case RE_CVCT:               /* conviction */
+      for (i = 0; i < n; i++) {
+        t = ((double)body[i]*(double)(base-head[i]))
+          / ((double)(body[i]-supp[i])*b);
+        out[i] = ((base <= 0) || (body[i] <= supp[i])) ? 0 : t;
+      } break;
+    case RE_CERT:               /* certainty factor */
+      for (i = 0; i < n; i++) {
+        p = (double)head[i]/b; t = (double)supp[i]/(double)body[i] -p;
+        t = t / ((t >= 0) ? 1-p : p);
+        out[i] = ((body[i] <= 0) || (base <= 0)) ? 0 : t;
+      } break;
+    case RE_CHI2:               /* normalized chi^2 measure */
+      for (i = 0; i < n; i++) {
+        t = (double)head[i] *(double)body[i] -(double)supp[i] *b;
+        t = (t*t) /(((double)head[i])*(double)(base-head[i])
+                   *((double)body[i])*(double)(base-body[i]));
+        out[i] = ((head[i] <= 0) || (head[i] >= base)
+               || (body[i] <= 0) || (body[i] >= base)) ? 0 : t;
+      } break;
+    case RE_FETPROB: case RE_FETCHI2:  /* Fisher's exact tests */
+    case RE_FETINFO: case RE_FETSUPP:  /* (with log-factorials) */
+      for (i = 0; i < n; i++)
+        out[i] = re_eval(id, supp[i], body[i], head[i], base, fc);
+      break;
+    default:                    /* other measures: evaluate each rule */
+      fn = re_function(id);     /* with the evaluation function */
+      for (i = 0; i < n; i++)
+        out[i] = fn(supp[i], body[i], head[i], base);
+      break;
+  }
+}  /* re_eval_batch() */
+/*----------------------------------------------------------------------
+  Main Function (Benchmark)
+----------------------------------------------------------------------*/
+#ifdef RULEVAL_MAIN
+
+static double seconds (clock_t t)
+{ return (double)(clock()-t) /CLOCKS_PER_SEC; }
+
+/*--------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{                               /* --- main function */
+  static const int ids[] = { RE_CHI2PVAL, RE_YATESPVAL, RE_INFOPVAL };
+  static const char *names[] = { "chi2pval", "yatespval", "infopval" };
+  long      i, n = 1000000;     /* loop variable, number of tables */
+  int       k;                  /* index of the measure */
+  SUPP      base = 10000;       /* base support (number of trans.) */
+  SUPP      *s, *b, *h;         /* supports of the tables */
+  double    p = 0.01, crit;     /* significance level, crit. value */
+  double    x, y, sx, sy;       /* p-values, sums of p-values */
+  long      sig, bad;           /* number of significant rules */
+  clock_t   t;                  /* timer for measurements */
+  RULEVALFN *fn;                /* rule evaluation function */
+
+  if (argc > 1) n    = atol(argv[1]);
+  if (argc > 2) p    = atof(argv[2]);
+  if (argc > 3) base = (SUPP)atol(argv[3]);
+  if ((n <= 0) || (p <= 0) || (p >= 1) || (base < 4)) {
+    printf("usage: %s [n [pval [base]]]\n", argv[0]);
+    printf("compare the cost of chi^2 based p-values "
+           "with and without critical value\n");
+    return 0;                   /* check the arguments and */
+  }                             /* print a usage message */
+  s = (SUPP*)malloc(3*(size_t)n *sizeof(SUPP));
+  if (!s) { printf("%s: not enough memory\n", argv[0]); return -1; }
+  b = s+n; h = b+n; srand(1);   /* create the table buffers */
+  for (i = 0; i < n; i++) {     /* generate random tables */
+    b[i] = 1 +(SUPP)(rand() % (int)(base-2));
+    h[i] = 1 +(SUPP)(rand() % (int)(base-2));
+    x    = (double)b[i] *(double)h[i] /(double)base;
+    y    = x +(0.1*(double)(rand() % 41) -2) *sqrt(x+1);
+    if (y < 0) y = 0;           /* rule support around the expected */
+    s[i] = (SUPP)y;             /* value (+/- a few std. deviations) */
+    if (s[i] > b[i]) s[i] = b[i];
+    if (s[i] > h[i]) s[i] = h[i];
+    if (s[i] < b[i]+h[i]-base) s[i] = b[i]+h[i]-base;
+  }                             /* clamp it to a possible value */
+  for (k = 0; k < 3; k++) {     /* traverse the measures */
+    fn = re_function(ids[k]);   /* get the p-value function */
+    t  = clock();               /* and the critical value */
+    crit = re_pcrit(ids[k], p);
+    printf("%-9s: critical value %.10g (%.2gs)\n",
+           names[k], crit, seconds(t));
+    t = clock();                /* evaluate all tables exactly */
+    for (sx = 0, i = 0; i < n; i++) sx += fn(s[i], b[i], h[i], base);
+    x = seconds(t); t = clock();/* evaluate with the critical value */
+    for (sy = 0, i = 0; i < n; i++)
+      sy += re_pcut(ids[k], s[i], b[i], h[i], base, crit, NULL);
+    y = seconds(t);             /* check the significance decisions */
+    for (sig = bad = 0, i = 0; i < n; i++) {
+      sx = fn(s[i], b[i], h[i], base);
+      sy = re_pcut(ids[k], s[i], b[i], h[i], base, crit, NULL);
+      if (sx <= p) sig++;       /* count the significant rules */
+      if (((sx <= p) != (sy <= p)) || ((sx <= p) && (sx != sy)))
+        bad++;                  /* count different decisions */
+    }                           /* or different p-values */
+    printf("%-9s: %ld of %ld significant, %ld differences\n",
+           names[k], sig, n, bad);
+    printf("%-9s: exact %.1fns/call, with critical value "
+           "%.1fns/call\n", names[k],
+           1e9*x/(double)n, 1e9*y/(double)n);
+  }
+  free(s);                      /* delete the table buffers */
+  return 0;                     /* return 'ok' */
+}  /* main() */
+
+#endif
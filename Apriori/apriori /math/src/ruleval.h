@@ -5,6 +5,10 @@
   History : 2011.07.22 file created
             2012.02.15 function re_supp() added (rule support)
             2013.03.29 adapted to type changes in module tract (SUPP)
+            2026.10.19 log-factorial table for Fisher's exact test added
+            2026.10.19 function re_eval_batch() added (batch evaluation)
+            2026.10.19 function re_bound() added (optimistic bounds)
+            2026.10.19 functions re_pcrit() and re_pcut() added
 ----------------------------------------------------------------------*/
 #ifndef __RULEVAL__
 #define __RULEVAL__
@@ -42,6 +46,11 @@
 ----------------------------------------------------------------------*/
 typedef double RULEVALFN (SUPP supp, SUPP body, SUPP head, SUPP base);
 
+typedef struct {                /* --- Fisher's exact test cache --- */
+  SUPP     cnt;                 /* number of log-factorials */
+  double   logfs[1];            /* table of log-factorials ln(n!) */
+} FETCACHE;                     /* (Fisher's exact test cache) */
+
 /*----------------------------------------------------------------------
   Rule Evaluation Functions
 ----------------------------------------------------------------------*/
@@ -62,12 +71,31 @@ extern double re_yates     (SUPP supp, SUPP body, SUPP head, SUPP base);
 extern double re_yatespval (SUPP supp, SUPP body, SUPP head, SUPP base);
 extern double re_info      (SUPP supp, SUPP body, SUPP head, SUPP base);
 extern double re_infopval  (SUPP supp, SUPP body, SUPP head, SUPP base);
-extern double re_fetprob   (SUPP supp, SUPP body, SUPP head, SUPP base);
-extern double re_fetchi2   (SUPP supp, SUPP body, SUPP head, SUPP base);
-extern double re_fetinfo   (SUPP supp, SUPP body, SUPP head, SUPP base);
-extern double re_fetsupp   (SUPP supp, SUPP body, SUPP head, SUPP base);
+extern double re_fetprob   (SUPP supp, SUPP body, SUPP head, SUPP base,
+                            const FETCACHE *fc);
+extern double re_fetchi2   (SUPP supp, SUPP body, SUPP head, SUPP base,
+                            const FETCACHE *fc);
+extern double re_fetinfo   (SUPP supp, SUPP body, SUPP head, SUPP base,
+                            const FETCACHE *fc);
+extern double re_fetsupp   (SUPP supp, SUPP body, SUPP head, SUPP base,
+                            const FETCACHE *fc);
 
+extern FETCACHE*  re_fetcache (SUPP n);
+extern void       re_fetdelete(FETCACHE *fc);
 extern RULEVALFN* re_function (int id);
 extern int        re_dir      (int id);
+extern double     re_eval     (int id, SUPP supp, SUPP body,
+                               SUPP head, SUPP base,
+                               const FETCACHE *fc);
+extern double     re_bound    (int id, SUPP supp, SUPP head, SUPP base,
+                               int pos, const FETCACHE *fc);
+extern double     re_pcrit    (int id, double thresh);
+extern double     re_pcut     (int id, SUPP supp, SUPP body,
+                               SUPP head, SUPP base, double crit,
+                               const FETCACHE *fc);
+extern void       re_eval_batch (int id, const SUPP *supp,
+                                 const SUPP *body, const SUPP *head,
+                                 SUPP base, double *out, size_t n,
+                                 const FETCACHE *fc);
 
 #endif
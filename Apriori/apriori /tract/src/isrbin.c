@@ -0,0 +1,272 @@
+/*----------------------------------------------------------------------
+  File    : isrbin.c
+  Contents: reader for item set/rule files in binary form (ISR_BINARY)
+  Author  : agent
+  History : 2026.10.19 file created
+----------------------------------------------------------------------*/
+#if defined _WIN32 && !defined IBR_NOMMAP
+#define IBR_NOMMAP                  /* no mmap() on Windows systems */
+#endif
+#ifndef IBR_NOMMAP
+#define _POSIX_C_SOURCE 200112L     /* needed for mmap() and fstat() */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#ifndef IBR_NOMMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+#include "isrbin.h"
+#ifdef IBR_MAIN
+#include "error.h"
+#endif
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define ALIGN8(n)   (((n) +7) & ~(size_t)7)  /* round to 8 bytes */
+#define HDRSIZE     (8 +2*sizeof(int) +sizeof(double))
+
+#ifdef IBR_MAIN
+#define PRGNAME     "isrbin"
+#define DESCRIPTION "print an item set/rule file in binary form"
+#define VERSION     "version 1.0 (2026.10.19)         " \
+                    "(c) 2026   agent"
+
+/* --- error codes --- */
+/* error codes   0 to  -4 defined in tract.h */
+#define E_FORMAT    (-5)        /* invalid file format */
+#endif
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+#ifdef IBR_MAIN
+static CCHAR *errmsgs[] = {     /* error messages */
+  /* E_NONE      0 */  "no error",
+  /* E_NOMEM    -1 */  "not enough memory",
+  /* E_FOPEN    -2 */  "cannot open file %s",
+  /* E_FREAD    -3 */  "read error on file %s",
+  /* E_FWRITE   -4 */  "write error on file %s",
+  /* E_FORMAT   -5 */  "invalid binary item set file %s",
+  /*            -6 */  "unknown error"
+};
+#endif
+
+/*----------------------------------------------------------------------
+  Global Variables
+----------------------------------------------------------------------*/
+#ifdef IBR_MAIN
+static CCHAR  *prgname;         /* program name for error messages */
+static ISRBIN *ibr = NULL;      /* binary item set file reader */
+#endif
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+
+static int load (ISRBIN *ibr, const char *name)
+{                               /* --- load/map the file contents */
+  #ifdef IBR_NOMMAP             /* if to read the file into memory */
+  FILE   *file;                 /* file to read */
+  char   *buf;                  /* buffer for the file contents */
+  long   n;                     /* size of the file */
+  #else                         /* if to map the file into memory */
+  int    fd;                    /* file descriptor */
+  struct stat st;               /* file status (for its size) */
+  void   *p;                    /* mapped file contents */
+  #endif
+
+  assert(ibr && name);          /* check the function arguments */
+  #ifdef IBR_NOMMAP             /* if to read the file into memory */
+  file = fopen(name, "rb");     /* open the file for reading */
+  if (!file) return -2;         /* and determine its size */
+  if ((fseek(file, 0, SEEK_END) != 0) || ((n = ftell(file)) < 0)) {
+    fclose(file); return -3; }
+  rewind(file);                 /* get the file size and allocate */
+  buf = (char*)malloc((size_t)n +1);     /* a buffer for the contents */
+  if (!buf) { fclose(file); return -1; }
+  if (fread(buf, 1, (size_t)n, file) != (size_t)n) {
+    free(buf); fclose(file); return -3; }
+  fclose(file);                 /* read the file contents */
+  ibr->map  = buf; ibr->size = (size_t)n;
+  ibr->mapped = 0;              /* note buffer and its size */
+  #else                         /* if to map the file into memory */
+  fd = open(name, O_RDONLY);    /* open the file for reading */
+  if (fd < 0) return -2;        /* and determine its size */
+  if (fstat(fd, &st) != 0) { close(fd); return -3; }
+  ibr->size = (size_t)st.st_size;
+  if (ibr->size <= 0) { close(fd); return -3; }
+  p = mmap(NULL, ibr->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);                    /* map the file into memory */
+  if (p == MAP_FAILED) return -3;
+  ibr->map = (const char*)p;    /* note the mapped contents */
+  ibr->mapped = 1;              /* (mapping persists after close()) */
+  #endif
+  return 0;                     /* return 'ok' */
+}  /* load() */
+
+/*--------------------------------------------------------------------*/
+
+static void unload (ISRBIN *ibr)
+{                               /* --- unload/unmap file contents */
+  assert(ibr);                  /* check the function argument */
+  if (!ibr->map) return;        /* check for loaded contents */
+  #ifndef IBR_NOMMAP            /* if the file is memory-mapped */
+  if (ibr->mapped) { munmap((void*)ibr->map, ibr->size); return; }
+  #endif                        /* unmap the file */
+  free((void*)ibr->map);        /* delete the file buffer */
+}  /* unload() */
+
+/*--------------------------------------------------------------------*/
+
+ISRBIN* ibr_open (const char *name)
+{                               /* --- open a binary item set file */
+  ITEM       i;                 /* loop variable */
+  int        n;                 /* number of items, name length */
+  ISRBIN     *ibr;              /* created binary file reader */
+  const char *s, *e;            /* to traverse the file contents */
+  char       *d;                /* to copy the item names */
+
+  assert(name);                 /* check the function arguments */
+  ibr = (ISRBIN*)calloc(1, sizeof(ISRBIN));
+  if (!ibr) return NULL;        /* create the base structure */
+  ibr->name = name;             /* note the file name and */
+  if ((load(ibr, name) != 0)    /* load or map the file contents */
+  ||  (ibr->size < HDRSIZE)     /* check the magic string, version */
+  ||  (memcmp(ibr->map, ISR_BINMAGIC, 4) != 0)
+  ||  (ibr->map[4] != ISR_BINVERS)
+  ||  (ibr->map[5] != (char)sizeof(ITEM))
+  ||  (ibr->map[6] != (char)sizeof(RSUPP))
+  ||  (ibr->map[7] != (((RSUPP)0.5 > 0) ? 'f' : 'i'))) {
+    ibr_close(ibr); return NULL; }  /* and the type sizes */
+  s = ibr->map +8;              /* skip the fixed size fields */
+  memcpy(&ibr->flags, s, sizeof(int));    s += sizeof(int);
+  memcpy(&n,          s, sizeof(int));    s += sizeof(int);
+  memcpy(&ibr->wgt,   s, sizeof(double)); s += sizeof(double);
+  ibr->cnt   = (ITEM)n;         /* get flags, items, and weight */
+  if (n < 0) { ibr_close(ibr); return NULL; }
+  ibr->names = (char**)malloc((size_t)(n+1) *sizeof(char*)
+                             +(ibr->size -HDRSIZE));
+  if (!ibr->names) { ibr_close(ibr); return NULL; }
+  d = (char*)(ibr->names +n+1); /* allocate name pointers and buffer */
+  e = ibr->map +ibr->size;      /* get the end of the file contents */
+  for (i = 0; i < ibr->cnt; i++) {
+    if (e -s < (ptrdiff_t)sizeof(int)) break;
+    memcpy(&n, s, sizeof(int)); /* traverse the item names */
+    s += sizeof(int);           /* and get their lengths */
+    if ((n < 0) || (e -s < n)) break;
+    ibr->names[i] = (char*)memcpy(d, s, (size_t)n);
+    d += n; *d++ = 0; s += n;   /* copy the item name and */
+  }                             /* terminate it with a '\0' */
+  ibr->names[i] = NULL;         /* store a sentinel after the names */
+  if (i < ibr->cnt) { ibr_close(ibr); return NULL; }
+  ibr->recs  = ibr->map +ALIGN8((size_t)(s -ibr->map));
+  ibr->next  = ibr->recs;       /* note the start of the records */
+  ibr->items = NULL; ibr->eval = NULL; ibr->supps = NULL;
+  return ibr;                   /* return created file reader */
+}  /* ibr_open() */
+
+/*--------------------------------------------------------------------*/
+
+void ibr_close (ISRBIN *ibr)
+{                               /* --- close a binary item set file */
+  assert(ibr);                  /* check the function argument */
+  if (ibr->names) free(ibr->names);
+  unload(ibr);                  /* delete the item names and */
+  free(ibr);                    /* unload the file contents */
+}  /* ibr_close() */
+
+/*--------------------------------------------------------------------*/
+
+int ibr_next (ISRBIN *ibr)
+{                               /* --- get the next record */
+  const char *s, *e;            /* to traverse the file contents */
+  ITEM       n;                 /* number of items in record */
+
+  assert(ibr);                  /* check the function argument */
+  s = ibr->next;                /* get the start of the next record */
+  e = ibr->map +ibr->size;      /* and the end of the file contents */
+  if (s >= e) return 0;         /* check for more records */
+  n = *(const ITEM*)s;          /* get the number of items */
+  if ((n < 0) || (n > ibr->cnt)) return -1;
+  ibr->items = (const ITEM*)s;  /* note the item array (with size) */
+  s += ALIGN8((size_t)(n+1) *sizeof(ITEM));
+  if (ibr->flags & ISR_BINEVAL){/* if there is an evaluation, */
+    ibr->eval = (const double*)s;    /* note its position */
+    s += sizeof(double); }      /* and skip it */
+  ibr->supps = (const RSUPP*)s; /* note the support value(s) */
+  s += ALIGN8(((ibr->flags & ISR_BINRULE) ? 3 : 1) *sizeof(RSUPP));
+  if (s > e) return -1;         /* check for a truncated record */
+  ibr->next = s;                /* note the start of the next record */
+  return 1;                     /* return 'record read' */
+}  /* ibr_next() */
+
+/* The records are not parsed or copied: ibr_next() only computes the */
+/* positions of the fields in the (memory-mapped) file contents,      */
+/* since all fields are properly aligned (see function isr_binout()   */
+/* in the item set reporter module report.c for a description of the  */
+/* format).                                                           */
+
+/*----------------------------------------------------------------------
+  Main Function
+----------------------------------------------------------------------*/
+#ifdef IBR_MAIN
+
+#ifndef NDEBUG                  /* if debug version */
+  #undef  CLEANUP               /* clean up memory and close files */
+  #define CLEANUP \
+  if (ibr) ibr_close(ibr);
+#endif
+
+GENERROR(error, exit)           /* generic error reporting function */
+
+/*--------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{                               /* --- main function for testing */
+  ITEM       i, n;              /* loop variable, number of items */
+  const ITEM *items;            /* items of the current record */
+  int        r;                 /* result of ibr_next() */
+
+  prgname = argv[0];            /* get program name for error msgs. */
+  if (argc != 2) {              /* if wrong number of arguments */
+    printf("usage: %s file\n", argv[0]);
+    printf("%s\n", DESCRIPTION);
+    printf("%s\n", VERSION);    /* print a usage message */
+    return 0;                   /* and abort the program */
+  }
+  ibr = ibr_open(argv[1]);      /* open the binary item set file */
+  if (!ibr) error(E_FORMAT, argv[1]);
+  while ((r = ibr_next(ibr)) > 0) {
+    items = ibr_items(ibr);     /* traverse the records */
+    n     = ibr_size(ibr);      /* and get their items */
+    if (ibr_flags(ibr) & ISR_BINRULE) {
+      printf("%s <-", ibr_name(ibr, ibr_head(ibr)));
+      if (ibr_flags(ibr) & ISR_BINSEQ) n--; else items++, n--;
+      for (i = 0; i < n; i++)   /* print head and body of a rule */
+        printf(" %s", ibr_name(ibr, items[i]));
+      printf(" (%"RSUPP_FMT", %"RSUPP_FMT", %"RSUPP_FMT", %g)\n",
+             ibr_supp(ibr), ibr_body(ibr), ibr_hsupp(ibr),
+             ibr_eval(ibr)); }  /* print the support values */
+    else {                      /* if the file contains item sets */
+      for (i = 0; i < n; i++)   /* print the items of the set */
+        printf((i > 0) ? " %s" : "%s", ibr_name(ibr, items[i]));
+      printf(" (%"RSUPP_FMT, ibr_supp(ibr));
+      if (ibr_flags(ibr) & ISR_BINEVAL) printf(", %g", ibr_eval(ibr));
+      printf(")\n");            /* print support and evaluation */
+    }
+  }
+  if (r < 0) error(E_FORMAT, argv[1]);
+  ibr_close(ibr); ibr = NULL;   /* close the binary item set file */
+  return 0;                     /* return 'ok' */
+}  /* main() */
+
+#endif
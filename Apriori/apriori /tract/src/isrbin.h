@@ -0,0 +1,71 @@
+/*----------------------------------------------------------------------
+  File    : isrbin.h
+  Contents: reader for item set/rule files in binary form (ISR_BINARY)
+  Author  : agent
+  History : 2026.10.19 file created
+----------------------------------------------------------------------*/
+#ifndef __ISRBIN__
+#define __ISRBIN__
+#include "tract.h"
+#include "report.h"
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- binary item set file reader --- */
+  const char   *name;           /* name of the file that is read */
+  const char   *map;            /* (memory-mapped) file contents */
+  size_t       size;            /* size of the file in bytes */
+  int          mapped;          /* whether the file is memory-mapped */
+  int          flags;           /* record flags (e.g. ISR_BINRULE) */
+  ITEM         cnt;             /* number of items */
+  double       wgt;             /* total transaction weight */
+  char         **names;         /* item names (terminated copies) */
+  const char   *recs;           /* start of the records */
+  const char   *next;           /* start of the next record */
+  const ITEM   *items;          /* items of current record (with n) */
+  const double *eval;           /* evaluation of current record */
+  const RSUPP  *supps;          /* support(s) of current record */
+} ISRBIN;                       /* (binary item set file reader) */
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+extern ISRBIN*      ibr_open   (const char *name);
+extern void         ibr_close  (ISRBIN *ibr);
+extern CCHAR*       ibr_fname  (ISRBIN *ibr);
+extern int          ibr_flags  (ISRBIN *ibr);
+extern ITEM         ibr_cnt    (ISRBIN *ibr);
+extern double       ibr_wgt    (ISRBIN *ibr);
+extern CCHAR*       ibr_name   (ISRBIN *ibr, ITEM item);
+
+extern void         ibr_rewind (ISRBIN *ibr);
+extern int          ibr_next   (ISRBIN *ibr);
+extern ITEM         ibr_size   (ISRBIN *ibr);
+extern const ITEM*  ibr_items  (ISRBIN *ibr);
+extern ITEM         ibr_head   (ISRBIN *ibr);
+extern RSUPP        ibr_supp   (ISRBIN *ibr);
+extern RSUPP        ibr_body   (ISRBIN *ibr);
+extern RSUPP        ibr_hsupp  (ISRBIN *ibr);
+extern double       ibr_eval   (ISRBIN *ibr);
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define ibr_fname(r)      ((r)->name)
+#define ibr_flags(r)      ((r)->flags)
+#define ibr_cnt(r)        ((r)->cnt)
+#define ibr_wgt(r)        ((r)->wgt)
+#define ibr_name(r,i)     ((CCHAR*)(r)->names[i])
+
+#define ibr_rewind(r)     ((r)->next = (r)->recs)
+#define ibr_size(r)       ((r)->items[0])
+#define ibr_items(r)      ((r)->items+1)
+#define ibr_head(r)       ((r)->items[((r)->flags & ISR_BINSEQ) \
+                                      ? (r)->items[0] : 1])
+#define ibr_supp(r)       ((r)->supps[0])
+#define ibr_body(r)       ((r)->supps[1])
+#define ibr_hsupp(r)      ((r)->supps[2])
+#define ibr_eval(r)       (((r)->eval) ? *(r)->eval : 0.0)
+
+#endif
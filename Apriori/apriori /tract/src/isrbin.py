@@ -0,0 +1,92 @@
+#-----------------------------------------------------------------------
+# File    : isrbin.py
+# Contents: reader for item set/rule files in binary form (ISR_BINARY)
+#           (see isrbin.h and function isr_binout() in report.c)
+# Author  : agent
+# History : 2026.10.19 file created
+#-----------------------------------------------------------------------
+# Usage:    import isrbin
+#           with isrbin.open('output') as f:
+#               for items, supp, ev in f:      # item sets
+#                   print([f.names[i] for i in items], supp)
+#           (for rules 'supp' is a triple (rule, body, head support))
+#-----------------------------------------------------------------------
+import io
+import mmap
+import struct
+
+__all__ = ['ISRBin', 'open']
+
+_ITEM  = { 4: 'i', 8: 'q' }     # struct codes for item types
+_SUPP  = { ('i',4): 'i', ('i',8): 'q', ('f',8): 'd' }
+EVAL   = 0x0001                 # records contain an evaluation
+RULE   = 0x0002                 # records contain body/head support
+SEQ    = 0x0004                 # rule head is last item (not first)
+
+#-----------------------------------------------------------------------
+
+def _align (n):
+    return (n +7) & ~7          # round up to a multiple of 8 bytes
+
+#-----------------------------------------------------------------------
+
+class ISRBin (object):
+    '''Memory-mapped binary item set/rule file.
+
+    The records are not parsed: each one is unpacked directly from the
+    mapped file with precompiled structures (one per item set size).'''
+
+    def __init__ (self, fname):
+        with io.open(fname, 'rb') as f:
+            self.map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, vers, isz, ssz, styp, self.flags, cnt, self.wgt = \
+            struct.unpack_from('=4sBBBciid', self.map, 0)
+        if magic != b'ISRB' or vers != 1:
+            raise ValueError('invalid binary item set file ' +fname)
+        self.item  = _ITEM[isz]; self.isize = isz
+        supp       = _SUPP[(styp.decode(), ssz)]
+        nsupp      = 3 if self.flags & RULE else 1
+        self.supp  = struct.Struct('=' +('d' if self.flags & EVAL else '')
+                                  +supp *nsupp)
+        self.skip  = _align(nsupp *ssz) +(8 if self.flags & EVAL else 0)
+        self.names = []; off = 24  # read the item names
+        for i in range(cnt):
+            n, = struct.unpack_from('=i', self.map, off)
+            self.names.append(self.map[off+4:off+4+n].decode('utf-8'))
+            off += 4 +n
+        self.recs  = _align(off)  # note the start of the records
+        self.sets  = {}           # cache of item set structures
+
+    def __iter__ (self):
+        '''Iterate over (items, support, evaluation) triples.'''
+        m, off, end = self.map, self.recs, len(self.map)
+        cnt  = struct.Struct('=' +self.item)
+        supp, skip, sets = self.supp, self.skip, self.sets
+        ev   = self.flags & EVAL
+        rule = self.flags & RULE
+        while off < end:
+            n, = cnt.unpack_from(m, off)
+            s  = sets.get(n)    # get the structure for n items
+            if s is None: s = sets[n] = struct.Struct('=%d%s'
+                                                      % (n, self.item))
+            items = s.unpack_from(m, off +self.isize)
+            off  += _align((n+1) *self.isize)
+            v = supp.unpack_from(m, off); off += skip
+            e = v[0] if ev else None
+            if ev: v = v[1:]
+            yield items, (v if rule else v[0]), e
+
+    def close (self):
+        self.map.close()
+
+    def __enter__ (self):
+        return self
+
+    def __exit__ (self, *args):
+        self.close()
+
+#-----------------------------------------------------------------------
+
+def open (fname):
+    '''Open a binary item set/rule file written by apriori -B.'''
+    return ISRBin(fname)
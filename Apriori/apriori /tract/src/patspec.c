@@ -8,6 +8,8 @@
             2013.10.15 functions psp_error() and psp_clear() added
             2013.10.16 made compatible with double support type
             2014.01.08 bug in function resize() fixed (size > n)
+            2026.10.19 full support range allocated for short rows,
+                       fast path in psp_incfrq(), faster psp_report()
 ----------------------------------------------------------------------*/
 #include <stdio.h>
 #include <stdlib.h>
@@ -54,6 +56,8 @@
 
 /*--------------------------------------------------------------------*/
 #define BLKSIZE      32         /* block size for enlarging arrays */
+#define FULLROW   16384         /* max. counters for allocating */
+                                /* the full support range of a row */
 
 /*----------------------------------------------------------------------
   Global Variables
@@ -117,7 +121,7 @@ void psp_delete (PATSPEC *psp)
   assert(psp);                  /* check the function argument */
   if (psp->rows) {              /* if there are pattern spectrum rows */
     #if INTSUPP                 /* if integer support type */
-    for (size = psp->minsize; size < psp->max; size++)
+    for (size = psp->minsize; size <= psp->max; size++)
       if (psp->rows[size].frqs) free(psp->rows[size].frqs);
     #endif                      /* delete the counter arrays */
     free(psp->rows);            /* delete the row array */
@@ -133,7 +137,7 @@ void psp_clear (PATSPEC *psp)
 
   assert(psp);                  /* check the function argument */
   if (psp->rows) {              /* if there are pattern spectrum rows */
-    for (size = psp->minsize; size < psp->max; size++) {
+    for (size = psp->minsize; size <= psp->max; size++) {
       #if INTSUPP               /* if integer support type */
       if (psp->rows[size].frqs) free(psp->rows[size].frqs);
       #endif                    /* delete the counter arrays */
@@ -192,6 +196,11 @@ static int resize (PATSPEC *psp, ITEM size, SUPP supp)
   #if INTSUPP                   /* if integer support type */
   if ((supp >= row->min) && (supp <= row->max))
     return 0;                   /* if support is in range, abort */
+  if (!row->frqs && (size > 0)  /* if the support range is small, */
+  &&  ((size_t)(psp->maxsupp -psp->minsupp) < FULLROW)) {
+    min = psp->minsupp;         /* allocate counters for all support */
+    max = psp->maxsupp; }       /* values, so that the row is never */
+  else {                        /* resized again after its creation */
   if      (!row->frqs)               min = supp     -BLKSIZE;
   else if (supp > row->min)          min = row->min;
   else if (supp > row->min -BLKSIZE) min = row->min -BLKSIZE;
@@ -202,6 +211,7 @@ static int resize (PATSPEC *psp, ITEM size, SUPP supp)
   else if (supp < row->max +BLKSIZE) max = row->max +BLKSIZE;
   else                               max = supp;
   if (max > psp->maxsupp)            max = psp->maxsupp;
+  }                             /* (otherwise enlarge in blocks) */
   if (size <= 0) min = max = supp; /* only one counter for size = 0 */
   n = (size_t)max -(size_t)min +1; /* compute the new array size */
   p = (size_t*)realloc(row->frqs, n *sizeof(size_t));
@@ -258,11 +268,14 @@ int psp_incfrq (PATSPEC *psp, ITEM size, SUPP supp, size_t frq)
   PSPROW *row;                  /* to access the table row */
 
   assert(psp);                  /* check the function arguments */
-  if ((size < psp->minsize) || (size > psp->maxsize)
-  ||  (supp < psp->minsupp) || (supp > psp->maxsupp))
-    return 0;                   /* ignore values outside range */
-  if (resize(psp, size, supp) < 0)
-    return psp->err = -1;       /* enlarge table if necessary */
+  if ((size < psp->minsize) || (size > psp->max)
+  ||  (supp < psp->rows[size].min) || (supp > psp->rows[size].max)) {
+    if ((size < psp->minsize) || (size > psp->maxsize)
+    ||  (supp < psp->minsupp) || (supp > psp->maxsupp))
+      return 0;                 /* ignore values outside range */
+    if (resize(psp, size, supp) < 0)
+      return psp->err = -1;     /* enlarge table if necessary */
+  }                             /* (only if counter does not exist) */
   row   = psp->rows +size;      /* get the indexed row and */
   #if INTSUPP                   /* if integer support type */
   supp -= row->min;             /* remove the support offset */
@@ -308,27 +321,48 @@ int psp_addpsp (PATSPEC *dst, PATSPEC *src)
 
 /*--------------------------------------------------------------------*/
 #ifdef PSP_REPORT
+#if INTSUPP
+
+static char* digits (char *s, size_t num)
+{                               /* --- format a non-negative integer */
+  *--s = 0;                     /* terminate the output string */
+  do {                          /* digit output loop */
+    *--s = (char)((num % 10) +'0');  /* store the next digit */
+    num /= 10;                  /* and remove it from the number */
+  } while (num > 0);            /* while there are more digits */
+  return s;                     /* return the start of the digits */
+}  /* digits() */
+
+#endif
+/*--------------------------------------------------------------------*/
 
 int psp_report (PATSPEC *psp, TABWRITE *twr)
 {                               /* --- report pattern spectrum */
   PSPROW *row;                  /* to traverse the rows (sizes) */
   ITEM   size;                  /* loop variable for sizes */
+  #if INTSUPP                   /* if integer support type */
   SUPP   supp;                  /* loop variable for supports */
   size_t frq;                   /* (size,supp) signature frequency */
-  char   buf[64];               /* output buffer for pattern size */
+  char   *p, *s, *e;            /* to traverse the output buffers */
+  char   buf[64], num[32];      /* output buffers for line and number */
+  #endif
 
   assert(psp && twr);           /* check the function arguments */
   for (size = psp->minsize; size <= psp->max; size++) {
     row = psp->rows +size;      /* traverse the rows (sizes) */
     #if INTSUPP                 /* if integer support type */
     if (!row->frqs) continue;   /* if no counters exist, skip row */
-    snprintf(buf, sizeof(buf), "%"ITEM_FMT, size);
+    for (p = buf, e = digits(num+sizeof(num), (size_t)size); *e; )
+      *p++ = *e++;              /* format the size prefix once */
+    *p++ = (char)twr->fldsep; s = p;
     for (supp = row->min; supp <= row->max; supp++) {
       if ((frq = row->frqs[supp-row->min]) <= 0)
         continue;               /* traverse the columns (support) */
-      twr_puts(twr, buf);                 twr_fldsep(twr);
-      twr_printf(twr, "%"SUPP_FMT, supp); twr_fldsep(twr);
-      twr_printf(twr, "%"SIZE_FMT, frq);  twr_recsep(twr);
+      for (p = s, e = digits(num+sizeof(num), (size_t)supp); *e; )
+        *p++ = *e++;            /* append the support */
+      *p++ = (char)twr->fldsep; /* and the signature frequency */
+      for (e = digits(num+sizeof(num), frq); *e; ) *p++ = *e++;
+      *p = 0; twr_puts(twr, buf); twr_recsep(twr);
     }                           /* print (size,support,counter) */
     #else                       /* if double support type */
     if (row->max < row->min) continue;
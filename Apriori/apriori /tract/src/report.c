@@ -56,7 +56,19 @@
             2013.10.08 function isr_seqrule() added (head at end)
             2013.10.15 check of ferror() added to isr_[tid]close()
             2013.11.07 item name handling made optional (pyfim/pycoco)
+            2026.10.19 binary output mode ISR_BINARY added
+            2026.10.19 no formatted names for object names (IB_OBJNAMES)
+            2026.10.19 functions isr_clone(), isr_merge(), isr_append()
+            2026.10.19 buffered transaction id output, isr_tidlists()
+            2026.10.19 compressed output with zlib (file names *.gz)
+            2026.10.19 collection of the best item sets (isr_settop())
+            2026.10.19 bug in isr_report() fixed (pex. support in psp)
+            2026.10.19 binary record format of clones set by first record
+            2026.10.19 support border per item set size (isr_setbdr())
 ----------------------------------------------------------------------*/
+#ifdef ZLIB                     /* fileno() and dup() are needed */
+#define _POSIX_C_SOURCE 200112L /* to attach zlib to an open file */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -67,6 +79,13 @@
 #ifndef ISR_NONAMES
 #include "scanner.h"
 #endif
+#ifdef ZLIB
+#include <unistd.h>
+#include <zlib.h>
+#ifdef TA_THREADS
+#include <pthread.h>
+#endif
+#endif
 #ifdef STORAGE
 #include "storage.h"
 #endif
@@ -87,7 +106,25 @@
 #define BS_INT         48       /* buffer size for integer output */
 #define BS_FLOAT       96       /* buffer size for float   output */
 #define LN_2        0.69314718055994530942  /* ln(2) */
-#define MODEMASK    (ISR_TARGET|ISR_NOEXPAND|ISR_SORT)
+#define MODEMASK    (ISR_TARGET|ISR_NOEXPAND|ISR_SORT|ISR_BINARY)
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+#ifdef ZLIB
+typedef struct {                /* --- compressed output stream --- */
+  gzFile          gz;           /* zlib stream (on a duplicate fd) */
+  int             err;          /* error indicator */
+  #ifdef TA_THREADS             /* if to compress in a helper thread */
+  pthread_t       thread;       /* compression thread */
+  pthread_mutex_t mutex;        /* mutex for the buffer exchange */
+  pthread_cond_t  cond;         /* signals a full or an empty buffer */
+  char            *buf;         /* buffer owned by the thread */
+  size_t          cnt;          /* number of bytes to compress */
+  int             quit;         /* flag for terminating the thread */
+  #endif
+} ZWRITER;                      /* (compressed output stream) */
+#endif
 
 /*----------------------------------------------------------------------
   Constants
@@ -100,6 +137,148 @@ static const double pows[] = {  /* several powers of ten */
   1e+24, 1e+25, 1e+26, 1e+27, 1e+28, 1e+29, 1e+30, 1e+31,
   1e+32, 1e+33 };
 
+/*----------------------------------------------------------------------
+  Compressed Output Functions
+----------------------------------------------------------------------*/
+#ifdef ZLIB
+
+static int isgz (const char *name)
+{                               /* --- check for a gzip file name */
+  size_t n = strlen(name);      /* get the length of the name */
+  return (n > 3) && (strcmp(name+n-3, ".gz") == 0);
+}  /* isgz() */
+
+/*--------------------------------------------------------------------*/
+
+static int zput (gzFile gz, const char *buf, size_t n)
+{                               /* --- compress a block of chars. */
+  unsigned k;                   /* size of the next chunk */
+
+  for ( ; n > 0; buf += k, n -= k) {
+    k = (n > 0x40000000) ? 0x40000000 : (unsigned)n;
+    if (gzwrite(gz, buf, k) != (int)k) return -1;
+  }                             /* gzwrite() takes an unsigned int */
+  return 0;                     /* return 'ok' */
+}  /* zput() */
+
+/*--------------------------------------------------------------------*/
+#ifdef TA_THREADS
+
+static void* zworker (void *p)
+{                               /* --- compression thread function */
+  ZWRITER *zw = (ZWRITER*)p;    /* compressed output stream */
+  int     r;                    /* result of compression */
+
+  pthread_mutex_lock(&zw->mutex);
+  while (1) {                   /* buffer processing loop */
+    while (!zw->cnt && !zw->quit)   /* wait for a full buffer */
+      pthread_cond_wait(&zw->cond, &zw->mutex);
+    if (!zw->cnt) break;        /* if to terminate, abort the loop */
+    pthread_mutex_unlock(&zw->mutex);
+    r = zput(zw->gz, zw->buf, zw->cnt);
+    pthread_mutex_lock(&zw->mutex);
+    if (r) zw->err = -1;        /* compress the buffer contents */
+    zw->cnt = 0;                /* and mark the buffer as empty */
+    pthread_cond_signal(&zw->cond);
+  }                             /* signal the empty buffer */
+  pthread_mutex_unlock(&zw->mutex);
+  return NULL;                  /* return a dummy result */
+}  /* zworker() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+static ZWRITER* zopen (FILE *file, size_t size)
+{                               /* --- attach zlib to an output file */
+  ZWRITER *zw;                  /* created compressed output stream */
+  int     fd;                   /* duplicate file descriptor */
+
+  assert(file && (size > 0));   /* check the function arguments */
+  zw = (ZWRITER*)malloc(sizeof(ZWRITER));
+  if (!zw) return NULL;         /* allocate the stream structure */
+  fd = dup(fileno(file));       /* gzclose() closes the descriptor, */
+  zw->gz = (fd < 0) ? NULL : gzdopen(fd, "wb");  /* so duplicate it */
+  if (!zw->gz) { if (fd >= 0) close(fd); free(zw); return NULL; }
+  zw->err  = 0;                 /* clear the error indicator */
+  #ifdef TA_THREADS             /* if to compress in a helper thread */
+  zw->cnt  = 0; zw->quit = 0;   /* the thread starts out idle */
+  zw->buf  = (char*)malloc(size *sizeof(char));
+  if (!zw->buf) { gzclose(zw->gz); free(zw); return NULL; }
+  pthread_mutex_init(&zw->mutex, NULL);
+  pthread_cond_init (&zw->cond,  NULL);
+  if (pthread_create(&zw->thread, NULL, zworker, zw) != 0) {
+    pthread_cond_destroy (&zw->cond);
+    pthread_mutex_destroy(&zw->mutex);
+    free(zw->buf); gzclose(zw->gz); free(zw); return NULL;
+  }                             /* start the compression thread */
+  #endif
+  return zw;                    /* return the created stream */
+}  /* zopen() */
+
+/*--------------------------------------------------------------------*/
+
+static void zwrite (ZWRITER *zw, char **buf, size_t n)
+{                               /* --- compress a full write buffer */
+  #ifdef TA_THREADS             /* if to compress in a helper thread */
+  char *p;                      /* exchange buffer for swapping */
+  #endif
+
+  assert(zw && buf && *buf);    /* check the function arguments */
+  if (n <= 0) return;           /* check for an empty buffer */
+  #ifdef TA_THREADS             /* if to compress in a helper thread */
+  pthread_mutex_lock(&zw->mutex);
+  while (zw->cnt > 0)           /* wait until the thread has */
+    pthread_cond_wait(&zw->cond, &zw->mutex);  /* finished */
+  p = zw->buf; zw->buf = *buf; *buf = p;
+  zw->cnt = n;                  /* hand the full buffer over and */
+  pthread_cond_signal(&zw->cond);  /* take the empty one back */
+  pthread_mutex_unlock(&zw->mutex);
+  #else                         /* if to compress directly */
+  if (zput(zw->gz, *buf, n) != 0) zw->err = -1;
+  #endif                        /* compress the buffer contents */
+}  /* zwrite() */
+
+/* With threads the buffer filled by the reporter and the buffer     */
+/* compressed by the helper thread are swapped (double buffering),  */
+/* so that formatting and compression of the output overlap.        */
+
+/*--------------------------------------------------------------------*/
+
+static void zdirect (ZWRITER *zw, const char *buf, size_t n)
+{                               /* --- compress an arbitrary block */
+  assert(zw && buf);            /* check the function arguments */
+  #ifdef TA_THREADS             /* if to compress in a helper thread */
+  pthread_mutex_lock(&zw->mutex);
+  while (zw->cnt > 0)           /* wait until the thread is idle */
+    pthread_cond_wait(&zw->cond, &zw->mutex);
+  pthread_mutex_unlock(&zw->mutex);
+  #endif                        /* (keep the order of the output) */
+  if (zput(zw->gz, buf, n) != 0) zw->err = -1;
+}  /* zdirect() */
+
+/*--------------------------------------------------------------------*/
+
+static int zclose (ZWRITER *zw)
+{                               /* --- close compressed output */
+  int r;                        /* result of gzclose() */
+
+  assert(zw);                   /* check the function argument */
+  #ifdef TA_THREADS             /* if to compress in a helper thread */
+  pthread_mutex_lock(&zw->mutex);
+  zw->quit = 1;                 /* tell the thread to terminate */
+  pthread_cond_signal(&zw->cond);   /* (after the last buffer) */
+  pthread_mutex_unlock(&zw->mutex);
+  pthread_join(zw->thread, NULL);
+  pthread_cond_destroy (&zw->cond);
+  pthread_mutex_destroy(&zw->mutex);
+  free(zw->buf);                /* wait for the thread to finish */
+  #endif                        /* and delete the exchange buffer */
+  r = (gzclose(zw->gz) != Z_OK) ? -1 : zw->err;
+  free(zw);                     /* close the zlib stream and */
+  return r;                     /* delete the stream structure */
+}  /* zclose() */
+
+#endif
 /*----------------------------------------------------------------------
   Basic Output Functions
 ----------------------------------------------------------------------*/
@@ -108,12 +287,15 @@ static void fastchk (ISREPORT *rep)
 {                               /* --- check for fast output mode */
   if (rep->repofn               /* if there is a report function */
   ||  rep->evalfn               /* or an evaluation function */
-  ||  rep->tidfile)             /* or trans ids. are to be written, */
+  ||  rep->tidfile              /* or trans ids. are to be written */
+  ||  rep->border               /* or there is a support border */
+  ||  rep->tops)                /* or the best sets are collected, */
     rep->fast =  0;             /* standard output has to be used */
   else if (!rep->file)          /* if no output (and no filtering), */
     rep->fast = -1;             /* only count the item sets */
   else {                        /* if only an output file is written */
-    rep->fast = ((rep->min <= 1) && (rep->max >= ITEM_MAX)
+    rep->fast = (!(rep->mode & ISR_BINARY)
+              && (rep->min <= 1) && (rep->max >= ITEM_MAX)
               && ((strcmp(rep->format, " (%a)") == 0)
               ||  (strcmp(rep->format, " (%d)") == 0))
               &&  (strcmp(rep->hdr,    "")      == 0)
@@ -141,7 +323,26 @@ static int getsd (const char *s, const char **end)
 
 static void isr_flush (ISREPORT *rep)
 {                               /* --- flush the output buffer */
+  size_t n;                     /* current size of the buffer */
+  char   *p;                    /* reallocated write buffer */
+
   assert(rep);                  /* check the function arguments */
+  if (rep->src) {               /* if the reporter is a clone, */
+    if (rep->next < rep->end)   /* the output is only collected */
+      return;                   /* (buffer is enlarged if it is full) */
+    n = (size_t)(rep->end -rep->buf);
+    p = (char*)realloc(rep->buf, (n+n) *sizeof(char));
+    if (!p) { rep->file = NULL; rep->next = rep->buf; return; }
+    rep->buf = p; rep->next = p+n; rep->end = p+n+n;
+    return;                     /* double the size of the buffer */
+  }                             /* (on failure mark the output lost) */
+  #ifdef ZLIB                   /* if compressed output is possible */
+  if (rep->zout) {              /* if to compress the output */
+    zwrite((ZWRITER*)rep->zout, &rep->buf,(size_t)(rep->next-rep->buf));
+    rep->next = rep->buf;       /* compress the output buffer */
+    rep->end  = rep->buf +BS_WRITE; return;
+  }                             /* (buffers may have been swapped) */
+  #endif
   fwrite(rep->buf, sizeof(char),(size_t)(rep->next-rep->buf),rep->file);
   rep->next = rep->buf;         /* write the output buffer */
 }  /* isr_flush() */
@@ -189,6 +390,139 @@ static void isr_putsn (ISREPORT *rep, const char *s, int n)
 
 /*--------------------------------------------------------------------*/
 
+static void isr_tidflush (ISREPORT *rep)
+{                               /* --- flush the tid output buffer */
+  assert(rep);                  /* check the function arguments */
+  #ifdef ZLIB                   /* if compressed output is possible */
+  if (rep->ztid) {              /* if to compress the output */
+    zwrite((ZWRITER*)rep->ztid, &rep->tidbuf,
+           (size_t)(rep->tidnxt-rep->tidbuf));
+    rep->tidnxt = rep->tidbuf;  /* compress the output buffer */
+    rep->tidend = rep->tidbuf +BS_WRITE; return;
+  }                             /* (buffers may have been swapped) */
+  #endif
+  fwrite(rep->tidbuf, sizeof(char), (size_t)(rep->tidnxt-rep->tidbuf),
+         rep->tidfile);         /* write the tid output buffer */
+  rep->tidnxt = rep->tidbuf;    /* and reinit. the next position */
+}  /* isr_tidflush() */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_tidputc (ISREPORT *rep, int c)
+{                               /* --- write a single character */
+  assert(rep);                  /* check the function arguments */
+  if (rep->tidnxt >= rep->tidend)  /* if the output buffer is full, */
+    isr_tidflush(rep);          /* flush it (write it to the file) */
+  *rep->tidnxt++ = (char)c;     /* store the given character */
+}  /* isr_tidputc() */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_tidputs (ISREPORT *rep, const char *s)
+{                               /* --- write a character string */
+  assert(rep);                  /* check the function arguments */
+  while (*s) {                  /* while not at end of string */
+    if (rep->tidnxt >= rep->tidend)  /* if the buffer is full, */
+      isr_tidflush(rep);        /* flush it (write it to the file) */
+    *rep->tidnxt++ = *s++;      /* store the next string character */
+  }
+}  /* isr_tidputs() */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_tidputsn (ISREPORT *rep, const char *s, int n)
+{                               /* --- write a character string */
+  assert(rep);                  /* check the function arguments */
+  if (rep->tidnxt +n > rep->tidend)
+    isr_tidflush(rep);          /* make room in the write buffer */
+  memcpy(rep->tidnxt, s, (size_t)n *sizeof(char));
+  rep->tidnxt += n;             /* copy the string into the buffer */
+}  /* isr_tidputsn() */         /* (only used for short strings) */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_binpad (ISREPORT *rep, size_t n)
+{                               /* --- pad to a multiple of 8 bytes */
+  static const char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  assert(rep);                  /* check the function arguments */
+  if (n & 7) isr_putsn(rep, zeros, (int)(8 -(n & 7)));
+}  /* isr_binpad() */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_binhdr (ISREPORT *rep, int flags)
+{                               /* --- write a binary file header */
+  ITEM   i;                     /* loop variable */
+  int    n;                     /* number of items, name length */
+  size_t z;                     /* number of bytes written */
+  char   b[8];                  /* buffer for fixed size fields */
+  double w;                     /* total transaction weight */
+
+  assert(rep);                  /* check the function arguments */
+  memcpy(b, ISR_BINMAGIC, 4);   /* magic string, format version, */
+  b[4] = ISR_BINVERS;           /* sizes of items and support values */
+  b[5] = (char)sizeof(ITEM);    /* and the type of support values */
+  b[6] = (char)sizeof(RSUPP);   /* ('f': floating point, 'i': int.) */
+  b[7] = ((RSUPP)0.5 > 0) ? 'f' : 'i';
+  isr_putsn(rep, b, 8);         /* write the fixed size fields */
+  rep->binf = flags;            /* note the record format flags */
+  isr_putsn(rep, (const char*)&flags, (int)sizeof(int));
+  n = (int)ib_cnt(rep->base);   /* write flags and number of items */
+  isr_putsn(rep, (const char*)&n, (int)sizeof(int));
+  w = (double)rep->supps[0];    /* write the total weight */
+  isr_putsn(rep, (const char*)&w, (int)sizeof(double));
+  z = 8 +2*sizeof(int) +sizeof(double);
+  for (i = 0; rep->inames[i]; i++) {
+    n = (int)strlen(rep->inames[i]);  /* traverse the item names */
+    isr_putsn(rep, (const char*)&n, (int)sizeof(int));
+    isr_putsn(rep, rep->inames[i], n);
+    z += sizeof(int) +(size_t)n;/* write the length of each name */
+  }                             /* and then the name itself */
+  isr_binpad(rep, z);           /* (without a terminating '\0') */
+}  /* isr_binhdr() */
+
+/*--------------------------------------------------------------------*/
+
+static void isr_binout (ISREPORT *rep, int flags, const ITEM *items,
+                        ITEM n, const RSUPP *supps, double eval)
+{                               /* --- write a binary record */
+  size_t z;                     /* number of bytes written */
+
+  assert(rep && (items || (n <= 0)) && supps);
+  if (rep->binf < 0) {          /* if the format is not yet fixed */
+    if (rep->src) rep->binf = flags;  /* a clone only notes it, */
+    else isr_binhdr(rep, flags);/* the original writes the header */
+  }                             /* (for clones in isr_append()) */
+  isr_putsn(rep, (const char*)&n, (int)sizeof(ITEM));
+  z = (size_t)(n+1) *sizeof(ITEM);
+  isr_putsn(rep, (const char*)items, (int)(z -sizeof(ITEM)));
+  isr_binpad(rep, z);           /* write number of items and items */
+  if (rep->binf & ISR_BINEVAL)  /* write the evaluation (if any) */
+    isr_putsn(rep, (const char*)&eval, (int)sizeof(double));
+  z = ((rep->binf & ISR_BINRULE) ? 3 : 1) *sizeof(RSUPP);
+  isr_putsn(rep, (const char*)supps, (int)z);
+  isr_binpad(rep, z);           /* write the support value(s) */
+}  /* isr_binout() */
+
+/* The binary output format consists of a header and a sequence of    */
+/* records, all in the byte order of the writing machine and padded   */
+/* to multiples of 8 bytes, so that all fields of a memory-mapped     */
+/* file are properly aligned. The header comprises the magic string   */
+/* ISR_BINMAGIC, the format version, sizeof(ITEM), sizeof(RSUPP) and  */
+/* the support type ('i' or 'f'), the record flags, the number of     */
+/* items and the total transaction weight (double), followed by the   */
+/* item names, each as an int length and the characters. A record     */
+/* holds the number n of items and the n (recoded) items, the eval.   */
+/* (double, only if ISR_BINEVAL) and the support, or, for rules       */
+/* (ISR_BINRULE), the rule support, body support and head support.    */
+/* For rules the head is the first item of a record, for sequence     */
+/* rules (ISR_BINSEQ) it is the last. The record flags are fixed with */
+/* the first record, so an output file must receive either only item  */
+/* sets or only rules (of one kind).                                  */
+
+/*--------------------------------------------------------------------*/
+
 int isr_intout (ISREPORT *rep, diff_t num)
 {                               /* --- print an integer number */
   int  i = BS_INT, n;           /* loop variable, character counter */
@@ -331,7 +665,7 @@ int isr_occout (ISREPORT *rep, ITEM occ)
     buf[--i] = (char)((occ % 10) +'0');  /* store the next digit */
     occ /= 10;                  /* and remove it from the number */
   } while (occ > 0);            /* while there are more digits */
-  fwrite(buf +i, sizeof(char), (size_t)(BS_INT-i), rep->tidfile);
+  isr_tidputsn(rep, buf+i, BS_INT-i);
   return BS_INT -i;             /* print the digits and */
 }  /* isr_occout() */
 
@@ -373,7 +707,7 @@ int isr_tidout (ISREPORT *rep, TID tid)
     buf[--i] = (char)((tid % 10) +'0');  /* store the next digit */
     tid /= 10;                  /* and remove it from the number */
   } while (tid > 0);            /* while there are more digits */
-  fwrite(buf +i, sizeof(char), (size_t)(BS_INT-i), rep->tidfile);
+  isr_tidputsn(rep, buf+i, BS_INT-i);
   return BS_INT -i;             /* print the digits and */
 }  /* isr_tidout() */
 
@@ -492,13 +826,18 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
     mode &= ~(ISR_CLOSED|ISR_MAXIMAL|ISR_NOFILTER);
   if (mode & (ISR_CLOSED|ISR_MAXIMAL))
     mode |= ISR_NOEXPAND;       /* make reporting mode consistent */
+  if ((mode & ISR_BINARY)       /* binary output and object names */
+  ||  (ib_mode(base) & IB_OBJNAMES))   /* need no formatted names */
+    mode &= ~ISR_SCAN;          /* (names are stored raw or empty) */
   n   = ib_cnt(base);           /* get the number of items/trans. */
   rep = (ISREPORT*)malloc(sizeof(ISREPORT)
                         +(size_t)(n+n+1) *sizeof(char*));
   if (!rep) return NULL;        /* allocate the base structure */
   rep->base    = base;          /* store the item base */
+  rep->src     = NULL;          /* not a clone of another reporter */
   rep->file    = NULL;          /* clear the output file and its name */
   rep->name    = NULL;          /* and allocate a file write buffer */
+  rep->zout    = rep->ztid = NULL;  /* clear the compressed streams */
   rep->buf     = (char*)malloc(BS_WRITE *sizeof(char));
   if (!rep->buf) { free(rep); return NULL; }
   rep->next    = rep->buf;
@@ -511,6 +850,8 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
                ? n+1 : n;       /* special maximum for isr_xable() */
   rep->smin    = 0;             /* initialize the support range */
   rep->smax    = RSUPP_MAX;     /* (minimum and maximum support) */
+  rep->bdrcnt  = 0;             /* there is no support border */
+  rep->border  = NULL;          /* (minimum support per size) */
   rep->cnt     = rep->pfx = 0;  /* init. the number of items */
   rep->evalfn  = (ISEVALFN*)0;  /* clear add. evaluation function */
   rep->evaldat = NULL;          /* and the corresponding data */
@@ -520,6 +861,12 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
   rep->repodat = NULL;          /* and the corresponding data */
   rep->tidfile = NULL;          /* clear the transaction id file */
   rep->tidname = NULL;          /* and its name */
+  rep->tidbuf  = rep->tidnxt = rep->tidend = NULL;
+  rep->tidls   = NULL;          /* clear the trans. id lists */
+  rep->cpfx    = 0;             /* and the valid cover prefix */
+  rep->tops    = NULL;          /* clear the best item sets */
+  rep->topmax  = rep->topcnt = 0;
+  rep->toperr  = 0;
   rep->occs    = NULL;          /* clear item occurrence array, */
   rep->tids    = NULL;          /* transaction ids array, and */
   rep->tidcnt  = 0;             /* the number of transaction ids */
@@ -571,7 +918,8 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
     rep->inames[i] = "";        /* clear all item names */
   #else                         /* if to use item names */
   for (sum = 0, i = 0; i < n; i++) {
-    name = ib_xname(base, i);   /* traverse the items and their names */
+    name = (ib_mode(base) & IB_OBJNAMES)
+         ? "" : ib_name(base, i);  /* traverse the items and names */
     if (!(mode & ISR_SCAN))     /* if to use the items names directly */
       sum += strlen(name);      /* sum their string lengths */
     else {                      /* if name formatting may be needed */
@@ -603,6 +951,7 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
   rep->iwfmt  = ":%w";          /* note header/separator/implication */
   rep->format = "  (%a)";       /* and formats for weights and info. */
   rep->fast   = -1;             /* default: only count the item sets */
+  rep->binf   = -1;             /* binary file header not written */
   #ifdef ISR_CLOMAX             /* if closed/maximal filtering */
   if (b <= 0) return rep;       /* if to report all item sets, abort */
   rep->iset = rep->items +n+1;  /* set the second item set buffer */
@@ -623,10 +972,9 @@ ISREPORT* isr_create (ITEMBASE *base, int mode, int dir,
 
 int isr_delete (ISREPORT *rep, int mode)
 {                               /* --- delete an item set reporter */
-  #ifndef ISR_NONAMES           /* if to use item names */
-  ITEM i;                       /* loop variable */
-  #endif
-  int  r, s;                    /* results of close operations */
+  ITEM   i, n;                  /* loop variable, number of items */
+  size_t k;                     /* loop variable for best item sets */
+  int    r, s;                  /* results of close operations */
 
   assert(rep);                  /* check the function argument */
   #ifdef ISR_PATSPEC            /* if pattern spectrum functions */
@@ -638,24 +986,165 @@ int isr_delete (ISREPORT *rep, int mode)
   #endif                        /* delete the closed/maximal filter */
   if (rep->out) free(rep->out); /* delete the output buffer */
   #ifndef ISR_NONAMES           /* if to use item names */
-  for (i = 0; rep->inames[i]; i++)
-    if (rep->inames[i] != ib_name(rep->base, i))
-      free((void*)rep->inames[i]);   /* delete all cloned names */
+  if (!rep->src                 /* (names are shared with clones) */
+  &&  !(ib_mode(rep->base) & IB_OBJNAMES))
+    for (i = 0; rep->inames[i]; i++)
+      if (rep->inames[i] != ib_name(rep->base, i))
+        free((void*)rep->inames[i]); /* delete all cloned names */
   #endif
+  if (rep->border && !rep->src) /* delete the support border */
+    free(rep->border);          /* (it is shared with clones) */
   if (rep->logs)  free(rep->logs);   /* delete the arrays */
   if (rep->wgts)  free(rep->wgts);   /* (if they are present) */
   if (rep->supps) free(rep->supps);
-  if (rep->stats) free(rep->stats);  /* delete the item base */
-  if (mode & ISR_DELISET) ib_delete(rep->base);
+  if (rep->stats) free(rep->stats);
   r = (mode & ISR_FCLOSE) ? isr_tidclose(rep) : 0;
   s = (mode & ISR_FCLOSE) ? isr_close(rep)    : 0;
-  free(rep->buf);               /* delete the file write buffer */
+  if (rep->tidls) {             /* if there are trans. id lists, */
+    n = ib_cnt(rep->base);      /* traverse the cover buffers */
+    for (i = n+1; i <= n+n; i++)/* and delete them */
+      if (rep->tidls[i]) free(rep->tidls[i]);
+    free(rep->tidls[n]);        /* delete the id lists of the items */
+    free(rep->tidls);           /* (all stored in one block) */
+  }
+  if (rep->tidbuf) free(rep->tidbuf);
+  if (rep->tops) {              /* if there are best item sets, */
+    for (k = 0; k < rep->topmax; k++)    /* delete their items */
+      if (rep->tops[k].items) free(rep->tops[k].items);
+    free(rep->tops);            /* delete the heap */
+  }
+  if (mode & ISR_DELISET) ib_delete(rep->base);
+  free(rep->buf);               /* delete the file write buffer(s) */
   free(rep);                    /* delete the base structure */
   return (r) ? r : s;           /* return file closing result */
 }  /* isr_delete() */
 
 /*--------------------------------------------------------------------*/
 
+ISREPORT* isr_clone (ISREPORT *rep, void *evaldat)
+{                               /* --- clone an item set reporter */
+  ITEM     i, n;                /* loop variable, number of items */
+  ISREPORT *c;                  /* created clone */
+  size_t   z;                   /* size of output buffer/stats block */
+
+  assert(rep);                  /* check the function arguments */
+  if (rep->repofn || rep->tidfile || rep->tops)
+    return NULL;                /* reporting functions and trans. id */
+  #ifdef ISR_CLOMAX             /* output cannot be split, */
+  if (rep->clomax || rep->gentab)
+    return NULL;                /* neither can the item set filters */
+  #endif                        /* (they need the full report order) */
+  n = ib_cnt(rep->base);        /* get the number of items */
+  c = (ISREPORT*)malloc(sizeof(ISREPORT)
+                      +(size_t)(n+n+1) *sizeof(char*));
+  if (!c) return NULL;          /* allocate the base structure */
+  memcpy(c, rep, sizeof(ISREPORT)); /* and copy the reporter */
+  c->src     = rep;             /* note the original reporter */
+  c->rep     = 0;               /* clear the item set counter */
+  c->inames  = (const char**)(c->pos +n+1);
+  memcpy((void*)c->inames, rep->inames, (size_t)(n+1) *sizeof(char*));
+  c->stats   = NULL; c->supps = NULL; c->psp = NULL;
+  c->wgts    = c->logs = c->sums = NULL; c->out = NULL;
+  c->iset    = NULL;            /* clear all pointers for an easier */
+  c->tidls   = NULL;            /* abort on failure (transaction id */
+  c->tidbuf  = c->tidnxt = c->tidend = NULL; /* lists not cloned) */
+  c->zout    = c->ztid = NULL;  /* the original compresses all */
+                                /* output (see isr_append()) */
+  c->buf     = (char*)malloc(BS_WRITE *sizeof(char));
+  if (!c->buf) { free(c); return NULL; }
+  c->next    = c->buf;          /* create a separate write buffer */
+  c->end     = c->buf +BS_WRITE;
+  if (evaldat) c->evaldat = evaldat;
+  z = (size_t)(n+1) *sizeof(size_t) +(size_t)(n+1+n+n+1) *sizeof(ITEM);
+  c->stats   = (size_t*)malloc(z);
+  c->supps   = (RSUPP*) malloc((size_t)(n+1) *sizeof(RSUPP));
+  if (!c->stats || !c->supps) { isr_delete(c, 0); return NULL; }
+  memcpy(c->stats, rep->stats, z);  /* copy the item set arrays */
+  memset(c->stats, 0, (size_t)(n+1) *sizeof(size_t));
+  c->pxpp    = (ITEM*)(c->stats +n+1);
+  c->pexs    = c->pxpp +(rep->pexs  -rep->pxpp);
+  c->items   = c->pxpp +(rep->items -rep->pxpp);
+  memcpy(c->supps, rep->supps, (size_t)(n+1) *sizeof(RSUPP));
+  if (rep->wgts) {              /* if there are item set weights */
+    c->wgts = (double*)malloc((size_t)(n+1) *sizeof(double));
+    if (!c->wgts) { isr_delete(c, 0); return NULL; }
+    memcpy(c->wgts, rep->wgts, (size_t)(n+1) *sizeof(double));
+  }                             /* copy the item set weights */
+  if (rep->logs) {              /* if there are logarithms of freqs. */
+    c->logs = (double*)malloc((size_t)(n+n+1) *sizeof(double));
+    if (!c->logs) { isr_delete(c, 0); return NULL; }
+    memcpy(c->logs, rep->logs, (size_t)(n+n+1) *sizeof(double));
+    c->sums = c->logs +n;       /* copy the logarithms and */
+  }                             /* the sums of logarithms */
+  z = (size_t)(rep->imp -rep->out) +strlen(rep->imp) +1;
+  c->out = (char*)malloc(z *sizeof(char));
+  if (!c->out) { isr_delete(c, 0); return NULL; }
+  memcpy(c->out, rep->out, z *sizeof(char));
+  for (i = 0; i <= rep->pfx; i++)   /* copy the output buffer and */
+    c->pos[i] = c->out +(rep->pos[i] -rep->out);  /* the positions */
+  c->hdr = c->out +(rep->hdr -rep->out);
+  c->sep = c->out +(rep->sep -rep->out);
+  c->imp = c->out +(rep->imp -rep->out);
+  #ifdef ISR_PATSPEC            /* if pattern spectrum functions */
+  if (rep->psp) {               /* if there is a pattern spectrum */
+    c->psp = psp_create(psp_minsize(rep->psp), psp_maxsize(rep->psp),
+                        psp_minsupp(rep->psp), psp_maxsupp(rep->psp));
+    if (!c->psp) { isr_delete(c, 0); return NULL; }
+  }                             /* create a pattern spectrum */
+  #endif                        /* with the same limits */
+  return c;                     /* return the created clone */
+}  /* isr_clone() */
+
+/* A clone shares the item base, the item names, the support border */
+/* and the output file with the reporter it was created from, but   */
+/* has its own item set arrays, counters and pattern spectrum. Its  */
+/* output is collected in its write buffer (which grows as needed)  */
+/* instead of writing it to the file, so that several clones can be */
+/* used concurrently (for example, one per thread) to report        */
+/* disjoint parts of the output. The collected output is transferred */
+/* with isr_append() and the counters are added to the original with */
+/* isr_merge().                                                      */
+
+/*--------------------------------------------------------------------*/
+
+int isr_merge (ISREPORT *rep, ISREPORT *clone)
+{                               /* --- merge counters of a clone */
+  ITEM i;                       /* loop variable */
+
+  assert(rep && clone && (clone->src == rep));
+  rep->rep += clone->rep;       /* add the number of item sets */
+  for (i = (ITEM)((size_t*)rep->pxpp -rep->stats); --i >= 0; )
+    rep->stats[i] += clone->stats[i];   /* and the set size stats. */
+  #ifdef ISR_PATSPEC            /* if pattern spectrum functions */
+  if (rep->psp && clone->psp) { /* if there are pattern spectra */
+    if (psp_error(clone->psp) || (psp_addpsp(rep->psp, clone->psp) < 0))
+      return -1;                /* add the pattern spectrum */
+  }                             /* of the clone to the original */
+  #endif
+  return (rep->file && !clone->file) ? -1 : 0;
+}  /* isr_merge() */            /* check for lost output */
+
+/*--------------------------------------------------------------------*/
+
+int isr_append (ISREPORT *rep, ISREPORT *clone, size_t beg, size_t end)
+{                               /* --- append output of a clone */
+  assert(rep && clone && (clone->src == rep) && (beg <= end));
+  if (!rep->file || (beg >= end)) return 0;
+  if (!clone->file || (end > isr_outpos(clone)))
+    return -1;                  /* check for lost output */
+  if ((rep->mode & ISR_BINARY) && (rep->binf < 0))
+    isr_binhdr(rep, clone->binf);  /* write the binary file header */
+  isr_flush(rep);               /* flush the write buffer and */
+  #ifdef ZLIB                   /* if compressed output is possible */
+  if (rep->zout) zdirect((ZWRITER*)rep->zout, clone->buf +beg, end-beg);
+  else
+  #endif
+  fwrite(clone->buf +beg, sizeof(char), end-beg, rep->file);
+  return 0;                     /* write the output section */
+}  /* isr_append() */
+
+/*--------------------------------------------------------------------*/
+
 int isr_open (ISREPORT *rep, FILE *file, const char *name)
 {                               /* --- open an output file */
   assert(rep);                  /* check the function arguments */
@@ -666,10 +1155,18 @@ int isr_open (ISREPORT *rep, FILE *file, const char *name)
   else if (!*name) {            /* if an empty name is given */
     file = stdout; rep->name = "<stdout>"; }
   else {                        /* if a proper name is given */
-    file = fopen(rep->name = name, "w");
+    file = fopen(rep->name = name,
+                 (rep->mode & ISR_BINARY) ? "wb" : "w");
     if (!file) return -2;       /* open file with given name */
+    #ifdef ZLIB                 /* if compressed output is possible */
+    if (isgz(name)) {           /* if the name ends in ".gz", */
+      rep->zout = zopen(file, BS_WRITE);  /* compress the output */
+      if (!rep->zout) { fclose(file); return -1; }
+    }                           /* (attach a zlib stream to the file) */
+    #endif
   }                             /* and check for an error */
   rep->file = file;             /* store the new output file */
+  rep->binf = -1;               /* binary file header not written */
   fastchk(rep);                 /* check for fast output */
   return 0;                     /* return 'ok' */
 }  /* isr_open() */
@@ -682,8 +1179,16 @@ int isr_close (ISREPORT *rep)
 
   assert(rep);                  /* check the function arguments */
   if (!rep->file) return 0;     /* check for an output file */
+  if ((rep->mode & ISR_BINARY) && (rep->binf < 0))
+    isr_binhdr(rep, 0);         /* write header of an empty file */
   isr_flush(rep);               /* flush the write buffer */
+  #ifdef ZLIB                   /* if compressed output is possible */
+  r  = (rep->zout) ? zclose((ZWRITER*)rep->zout) : 0;
+  rep->zout = NULL;             /* finish the compressed stream */
+  r |= ferror(rep->file);       /* and check the error indicator */
+  #else
   r  = ferror(rep->file);       /* check the error indicator */
+  #endif
   r |= ((rep->file == stdout) || (rep->file == stderr))
      ? fflush(rep->file) : fclose(rep->file);
   rep->file = NULL;             /* close the current output file */
@@ -728,6 +1233,47 @@ void isr_setsupp (ISREPORT *rep, RSUPP min, RSUPP max)
 
 /*--------------------------------------------------------------------*/
 
+int isr_setbdr (ISREPORT *rep, ITEM size, RSUPP supp)
+{                               /* --- set support border value */
+  ITEM  n;                      /* new size of the border array */
+  RSUPP *p;                     /* reallocated border array */
+
+  assert(rep && !rep->src       /* check the function arguments */
+  &&    (size >= 0) && (supp >= 0));
+  if (size >= rep->bdrcnt) {    /* if the border array is too small */
+    n = ib_cnt(rep->base)+1;    /* get the maximal number of entries */
+    if (size >= n) return 0;    /* (larger sets cannot be reported) */
+    p = (RSUPP*)realloc(rep->border, (size_t)n *sizeof(RSUPP));
+    if (!p) return -1;          /* enlarge the border array */
+    while (rep->bdrcnt < n) p[rep->bdrcnt++] = 0;
+    rep->border = p;            /* clear the new entries */
+  }                             /* and set the new array */
+  rep->border[size] = supp;     /* store the minimum support */
+  fastchk(rep);                 /* check for fast output */
+  return 0;                     /* return 'ok' */
+}  /* isr_setbdr() */
+
+/*--------------------------------------------------------------------*/
+
+void isr_clrbdr (ISREPORT *rep)
+{                               /* --- clear the support border */
+  assert(rep && !rep->src);     /* check the function argument */
+  if (rep->border) free(rep->border);
+  rep->border = NULL;           /* delete the border array */
+  rep->bdrcnt = 0;              /* and clear the number of values */
+  fastchk(rep);                 /* check for fast output */
+}  /* isr_clrbdr() */
+
+/* The support border is a minimum support for each item set size, */
+/* which is applied in addition to the general minimum support; it  */
+/* is usually derived from a pattern spectrum of surrogate data, so */
+/* that only item sets with a signature (size and support) that is  */
+/* unlikely to occur by chance are reported. The border is checked  */
+/* before the item set is evaluated and counted (also in the pattern */
+/* spectrum of the reporter), so it affects all reporting modes.    */
+
+/*--------------------------------------------------------------------*/
+
 void isr_seteval (ISREPORT *rep, ISEVALFN evalfn, void *data,
                   int dir, double thresh)
 {                               /* --- set evaluation function */
@@ -766,7 +1312,25 @@ int isr_tidopen (ISREPORT *rep, FILE *file, const char *name)
   else {                        /* if a proper name is given */
     file = fopen(rep->tidname = name, "w");
     if (!file) return -2;       /* open file with given name */
+    #ifdef ZLIB                 /* if compressed output is possible */
+    if (isgz(name)) {           /* if the name ends in ".gz", */
+      rep->ztid = zopen(file, BS_WRITE);  /* compress the output */
+      if (!rep->ztid) { fclose(file); return -1; }
+    }                           /* (attach a zlib stream to the file) */
+    #endif
   }                             /* and check for an error */
+  if (file && !rep->tidbuf) {   /* if there is no tid write buffer */
+    rep->tidbuf = (char*)malloc(BS_WRITE *sizeof(char));
+    if (!rep->tidbuf) {         /* allocate a tid write buffer */
+      #ifdef ZLIB               /* if compressed output is possible */
+      if (rep->ztid) { zclose((ZWRITER*)rep->ztid); rep->ztid = NULL; }
+      #endif                    /* close the compressed stream */
+      if ((file != stdout) && (file != stderr)) fclose(file);
+      return -1;                /* on failure close the file */
+    }                           /* and abort the function */
+    rep->tidend = rep->tidbuf +BS_WRITE;
+  }                             /* set the end of the buffer */
+  rep->tidnxt  = rep->tidbuf;   /* init. the next write position */
   rep->tidfile = file;          /* store the new output file */
   fastchk(rep);                 /* check for fast output */
   return 0;                     /* return 'ok' */
@@ -780,7 +1344,14 @@ int isr_tidclose (ISREPORT *rep)
 
   assert(rep);                  /* check the function arguments */
   if (!rep->tidfile) return 0;  /* check for an output file */
+  isr_tidflush(rep);            /* flush the tid write buffer */
+  #ifdef ZLIB                   /* if compressed output is possible */
+  r  = (rep->ztid) ? zclose((ZWRITER*)rep->ztid) : 0;
+  rep->ztid = NULL;             /* finish the compressed stream */
+  r |= ferror(rep->tidfile);    /* and check the error indicator */
+  #else
   r  = ferror(rep->tidfile);    /* check the error indicator */
+  #endif
   r |= ((rep->tidfile == stdout) || (rep->tidfile == stderr))
      ? fflush(rep->tidfile) : fclose(rep->tidfile);
   rep->tidfile = NULL;          /* close the current output file */
@@ -798,6 +1369,88 @@ void isr_tidcfg (ISREPORT *rep, TID tracnt, ITEM miscnt)
 
 /*--------------------------------------------------------------------*/
 
+int isr_tidlists (ISREPORT *rep, TABAG *bag)
+{                               /* --- set trans. id lists of items */
+  ITEM       i, n;              /* loop variable, number of items */
+  TID        k, m;              /* loop variable, number of trans. */
+  const TID  *c;                /* number of transactions per item */
+  TID        *p;                /* to organize the id lists */
+  const ITEM *s;                /* to traverse the items */
+  TRACT      *t;                /* to traverse the transactions */
+
+  assert(rep && bag             /* check the function arguments */
+  &&   (tbg_base(bag) == rep->base)
+  &&   !(tbg_mode(bag) & IB_WEIGHTS));
+  if (rep->tidls) return 1;     /* if id lists exist, abort */
+  n = ib_cnt(rep->base);        /* get the number of items */
+  m = tbg_cnt(bag);             /* and the number of transactions */
+  c = tbg_icnts(bag, 1);        /* count the transactions per item */
+  if (!c) return -1;            /* (sizes of the id lists) */
+  rep->tidls = (TID**)calloc((size_t)(n+n+1), sizeof(TID*));
+  if (!rep->tidls) return -1;   /* allocate the list pointers */
+  for (k = m+1, i = 0; i < n; i++)
+    k += c[i]+1;                /* compute the total list size */
+  p = (TID*)malloc((size_t)k *sizeof(TID));
+  if (!p) { free(rep->tidls); rep->tidls = NULL; return -1; }
+  rep->tidls[n] = p;            /* the first list is the cover */
+  for (*p++ = m, k = 0; k < m; k++)  /* of the empty item set, */
+    *p++ = k;                   /* which contains all transactions */
+  for (i = 0; i < n; i++) {     /* traverse the items */
+    rep->tidls[i] = p; *p = 0; p += c[i]+1;
+  }                             /* organize the id lists */
+  for (k = 0; k < m; k++) {     /* traverse the transactions */
+    t = tbg_tract(bag, k);      /* and collect their identifiers */
+    for (s = t->items; *s > TA_END; s++) {
+      p = rep->tidls[*s]; p[++p[0]] = k; }
+  }                             /* (store the size in element 0) */
+  rep->cpfx = 0;                /* no covers have been computed yet */
+  return 0;                     /* return 'ok' */
+}  /* isr_tidlists() */
+
+/* The lists of transaction identifiers must be set from a bag in   */
+/* which the transactions are still in their original order (that  */
+/* is, before sorting or reducing them), so that the position of a  */
+/* transaction is its identifier. Each list stores its size in the  */
+/* first element, followed by the identifiers in ascending order.   */
+/* If transaction id lists are set and a transaction id file is     */
+/* open, isr_report() computes the cover of the current item set by */
+/* intersecting the cover of its prefix with the id list of its     */
+/* last item and writes the identifiers of the cover to this file.  */
+
+/*--------------------------------------------------------------------*/
+
+int isr_settop (ISREPORT *rep, size_t n)
+{                               /* --- set number of best item sets */
+  size_t i;                     /* loop variable */
+
+  assert(rep);                  /* check the function arguments */
+  if (rep->tops) {              /* if there are best item sets, */
+    for (i = 0; i < rep->topmax; i++)    /* delete their items */
+      if (rep->tops[i].items) free(rep->tops[i].items);
+    free(rep->tops);            /* delete the heap */
+  }                             /* and clear the variables */
+  rep->tops   = NULL; rep->topmax = rep->topcnt = 0;
+  rep->toperr = 0;              /* clear the error flag */
+  if (n > 0) {                  /* if to collect the best item sets */
+    rep->tops = (ISTOP*)calloc(n, sizeof(ISTOP));
+    if (!rep->tops) return -1;  /* create a heap for the best sets */
+    rep->topmax = n;            /* (elements are filled on demand) */
+  }                             /* and note its size */
+  fastchk(rep);                 /* check for fast output */
+  return 0;                     /* return 'ok' */
+}  /* isr_settop() */
+
+/* If a maximum number n > 0 of best item sets is set, the reporter */
+/* keeps only the n item sets with the highest score in a heap and   */
+/* writes nothing until isr_topout() is called. The score is the     */
+/* evaluation (see isr_seteval(); a smaller value is better if the   */
+/* evaluation direction is negative) or, without an evaluation       */
+/* function, the weight or support of an item set. Item sets that    */
+/* cannot enter the heap are discarded before any output formatting. */
+/* Transaction id lists are not written for the best item sets.      */
+
+/*--------------------------------------------------------------------*/
+
 int isr_add (ISREPORT *rep, ITEM item, RSUPP supp)
 {                               /* --- add an item (only support) */
   assert(rep && (item >= 0)     /* check the function arguments */
@@ -920,6 +1573,8 @@ void isr_remove (ISREPORT *rep, ITEM n)
   }                             /* and remove their "in use" markers */
   if (rep->cnt < rep->pfx)      /* if too few items are left, */
     rep->pfx = rep->cnt;        /* reduce the valid prefix */
+  if (rep->cnt < rep->cpfx)     /* (for the output and for */
+    rep->cpfx = rep->cnt;       /* the transaction id covers) */
 }  /* isr_remove() */
 
 /*--------------------------------------------------------------------*/
@@ -979,6 +1634,19 @@ double isr_wgtsupp (ISREPORT *rep, void *data)
 
 /*--------------------------------------------------------------------*/
 
+double isr_suppfac (ISREPORT *rep, void *data)
+{                               /* --- support times factor^size */
+  assert(rep && data);          /* check the function arguments */
+  return (double)rep->supps[rep->cnt]
+       * pow(*(double*)data, (double)rep->cnt);
+}  /* isr_suppfac() */
+
+/* Evaluate an item set by its support times a factor (pointed to by */
+/* 'data') raised to the power of the item set size, so that large   */
+/* item sets are favored (factor > 1) or penalized (factor < 1).     */
+
+/*--------------------------------------------------------------------*/
+
 static void fastout (ISREPORT *rep, ITEM n)
 {                               /* --- fast output of an item set */
   char       *s;                /* to traverse the output buffer */
@@ -1011,33 +1679,62 @@ static void fastout (ISREPORT *rep, ITEM n)
 
 /*--------------------------------------------------------------------*/
 
-static void output (ISREPORT *rep)
-{                               /* --- output an item set */
-  ITEM       i;                 /* loop variable, flag */
+static void topadd (ISREPORT *rep)
+{                               /* --- add item set to the best sets */
+  size_t i, k;                  /* heap indices */
+  double s;                     /* score of the current item set */
+  ISTOP  t, *h;                 /* new heap element, heap */
+  ITEM   *p;                    /* reallocated item array */
+
+  assert(rep && rep->tops);     /* check the function argument */
+  s = (rep->evalfn) ? rep->evaldir *rep->eval
+    : (rep->wgts)   ? rep->wgts[rep->cnt] : (double)rep->supps[rep->cnt];
+  h = rep->tops;                /* get the score and the heap */
+  if (rep->topcnt >= rep->topmax) { /* if the heap is full, */
+    if (s <= h[0].score) return;    /* discard worse item sets */
+    t = h[0]; }                 /* and otherwise replace the root */
+  else                          /* if the heap is not full, */
+    t = h[rep->topcnt];         /* use the next free element */
+  if (t.size < rep->cnt) {      /* if the item array is too small */
+    p = (ITEM*)realloc(t.items, (size_t)rep->cnt *sizeof(ITEM));
+    if (!p) { rep->toperr = -1; return; }
+    t.items = p; t.size = rep->cnt;
+  }                             /* enlarge the item array */
+  memcpy(t.items, rep->items, (size_t)rep->cnt *sizeof(ITEM));
+  t.cnt   = rep->cnt;           /* copy the items of the set */
+  t.score = s;                  /* and note its score, evaluation, */
+  t.eval  = rep->eval;          /* support and weight */
+  t.supp  = rep->supps[rep->cnt];
+  t.wgt   = (rep->wgts) ? rep->wgts[rep->cnt] : 0;
+  if (rep->topcnt >= rep->topmax) {
+    for (i = 0; (k = i+i+1) < rep->topcnt; i = k) {
+      if ((k+1 < rep->topcnt) && (h[k+1].score < h[k].score)) k++;
+      if (s <= h[k].score) break;
+      h[i] = h[k];              /* sift the new element down */
+    } }                         /* from the root of the heap */
+  else {                        /* if the heap is not full */
+    for (i = rep->topcnt++; i > 0; i = k) {
+      k = (i-1) >> 1;           /* get the index of the parent */
+      if (h[k].score <= s) break;
+      h[i] = h[k];              /* sift the new element up */
+    }                           /* from the end of the heap */
+  }
+  h[i] = t;                     /* store the new element */
+}  /* topadd() */
+
+/* The heap keeps the worst of the best item sets at its root, so */
+/* that an item set that cannot enter it is recognized at once.   */
+
+/*--------------------------------------------------------------------*/
+
+static void emit (ISREPORT *rep)
+{                               /* --- emit an evaluated item set */
   TID        k;                 /* loop variable */
   ITEM       min;               /* minimum number of items */
   char       *s;                /* to traverse the output buffer */
   const char *name;             /* to traverse the item names */
-  double     sum;               /* to compute the logarithm sums */
 
-  assert(rep                    /* check the function arguments */
-  &&    (rep->cnt >= rep->min)
-  &&    (rep->cnt <= rep->max));
-  if (!rep->evalfn) {           /* if no evaluation function is given */
-    if (rep->wgts)              /* use the weight as evaluation */
-      rep->eval = rep->wgts[rep->cnt]; }
-  else {                        /* if an evaluation function is given */
-    if (rep->logs) {            /* if to compute sums of logarithms */
-      sum = rep->sums[rep->pfx];/* get the valid sum for a prefix */
-      for (i = rep->pfx; i < rep->cnt; ) {
-        sum += rep->logs[rep->items[i]];
-        rep->sums[++i] = sum;   /* traverse the additional items */
-      }                         /* and add the logarithms of */
-    }                           /* their individual frequencies */
-    rep->eval = rep->evalfn(rep, rep->evaldat);
-    if (rep->evaldir *rep->eval < rep->evalthh)
-      return;                   /* if the item set does not qualify, */
-  }                             /* abort the output function */
+  assert(rep);                  /* check the function argument */
   rep->stats[rep->cnt]++;       /* count the reported item set */
   rep->rep++;                   /* (for its size and overall) */
   #ifdef ISR_PATSPEC            /* if pattern spectrum functions */
@@ -1047,44 +1744,81 @@ static void output (ISREPORT *rep)
   if (rep->repofn)              /* call reporting function if given */
     rep->repofn(rep, rep->repodat);
   if (!rep->file) return;       /* check for an output file */
-  s = rep->pos[rep->pfx];       /* get the position for appending */
-  while (rep->pfx < rep->cnt) { /* traverse the additional items */
-    if (rep->pfx > 0)           /* if this is not the first item */
-      for (name = rep->sep; *name; )
-        *s++ = *name++;         /* copy the item separator */
-    for (name = rep->inames[rep->items[rep->pfx]]; *name; )
-      *s++ = *name++;           /* copy the item name to the buffer */
-    rep->pos[++rep->pfx] = s;   /* compute and record new position */
-  }                             /* for appending the next item */
-  isr_putsn(rep, rep->out, (int)(s-rep->out));
-  isr_sinfo(rep, rep->supps[rep->cnt],
-            (rep->wgts) ? rep->wgts[rep->cnt] : 0, rep->eval);
-  isr_putc(rep, '\n');          /* print the item set information */
+  if (rep->mode & ISR_BINARY)   /* if to write in binary form */
+    isr_binout(rep, (rep->evalfn || rep->wgts) ? ISR_BINEVAL : 0,
+               rep->items, rep->cnt, rep->supps+rep->cnt, rep->eval);
+  else {                        /* if to write in text form */
+    s = rep->pos[rep->pfx];     /* get the position for appending */
+    while (rep->pfx < rep->cnt){/* traverse the additional items */
+      if (rep->pfx > 0)         /* if this is not the first item */
+        for (name = rep->sep; *name; )
+          *s++ = *name++;       /* copy the item separator */
+      for (name = rep->inames[rep->items[rep->pfx]]; *name; )
+        *s++ = *name++;         /* copy the item name to the buffer */
+      rep->pos[++rep->pfx] = s; /* compute and record new position */
+    }                           /* for appending the next item */
+    isr_putsn(rep, rep->out, (int)(s-rep->out));
+    isr_sinfo(rep, rep->supps[rep->cnt],
+              (rep->wgts) ? rep->wgts[rep->cnt] : 0, rep->eval);
+    isr_putc(rep, '\n');        /* print the item set information */
+  }
   if (!rep->tidfile || !rep->tids) /* check whether to report */
     return;                        /* a list of transaction ids */
   if      (rep->tidcnt > 0) {   /* if tids are in ascending order */
     for (k = 0; k < rep->tidcnt; k++) {
-      if (k > 0) fputs(rep->sep, rep->tidfile);
+      if (k > 0) isr_tidputs(rep, rep->sep);
       isr_tidout(rep, rep->tids[k]+1);
     } }                         /* report the transaction ids */
   else if (rep->tidcnt < 0) {   /* if tids are in descending order */
     for (k = -rep->tidcnt; k > 0; ) {
       isr_tidout(rep, rep->tids[--k]+1);
-      if (k > 0) fputs(rep->sep, rep->tidfile);
+      if (k > 0) isr_tidputs(rep, rep->sep);
     } }                         /* report the transaction ids */
   else if (rep->tracnt > 0) {   /* if item occurrence counters */
     min = (ITEM)(rep->cnt-rep->miscnt); /* traverse all trans. ids */
     for (k = 0; k < rep->tracnt; k++) {
       if (rep->occs[k] < min)   /* skip all transactions that */
         continue;               /* do not contain enough items */
-      if (k > 0) fputs(rep->sep, rep->tidfile);
+      if (k > 0) isr_tidputs(rep, rep->sep);
       isr_tidout(rep, k+1);     /* print the transaction identifier */
       if (rep->miscnt <= 0) continue;
-      fputc(':', rep->tidfile); /* print an item counter separator */
+      isr_tidputc(rep, ':');    /* print an item counter separator */
       isr_occout(rep, rep->occs[k]);
     }                           /* print number of contained items */
   }
-  fputc('\n', rep->tidfile);    /* terminate the transaction id list */
+  isr_tidputc(rep, '\n');       /* terminate the transaction id list */
+}  /* emit() */
+
+/*--------------------------------------------------------------------*/
+
+static void output (ISREPORT *rep)
+{                               /* --- output an item set */
+  ITEM   i;                     /* loop variable */
+  double sum;                   /* to compute the logarithm sums */
+
+  assert(rep                    /* check the function arguments */
+  &&    (rep->cnt >= rep->min)
+  &&    (rep->cnt <= rep->max));
+  if ((rep->cnt < rep->bdrcnt)  /* if the item set is below */
+  &&  (rep->supps[rep->cnt] < rep->border[rep->cnt]))
+    return;                     /* the support border, abort */
+  if (!rep->evalfn) {           /* if no evaluation function is given */
+    if (rep->wgts)              /* use the weight as evaluation */
+      rep->eval = rep->wgts[rep->cnt]; }
+  else {                        /* if an evaluation function is given */
+    if (rep->logs) {            /* if to compute sums of logarithms */
+      sum = rep->sums[rep->pfx];/* get the valid sum for a prefix */
+      for (i = rep->pfx; i < rep->cnt; ) {
+        sum += rep->logs[rep->items[i]];
+        rep->sums[++i] = sum;   /* traverse the additional items */
+      }                         /* and add the logarithms of */
+    }                           /* their individual frequencies */
+    rep->eval = rep->evalfn(rep, rep->evaldat);
+    if (rep->evaldir *rep->eval < rep->evalthh)
+      return;                   /* if the item set does not qualify, */
+  }                             /* abort the output function */
+  if (rep->tops) topadd(rep);   /* collect the best item sets or */
+  else           emit(rep);     /* emit the item set directly */
 }  /* output() */
 
 /*--------------------------------------------------------------------*/
@@ -1106,6 +1840,39 @@ static void report (ISREPORT *rep, ITEM n)
 
 /*--------------------------------------------------------------------*/
 
+static int cover (ISREPORT *rep)
+{                               /* --- compute cover of current set */
+  ITEM      i, n;               /* loop variable, number of items */
+  TID       **c;                /* covers of the prefixes */
+  TID       *d;                 /* to store the cover */
+  const TID *a, *b, *x, *y;     /* to traverse the id lists */
+
+  assert(rep && rep->tidls);    /* check the function argument */
+  n = ib_cnt(rep->base);        /* get the number of items */
+  c = rep->tidls +n;            /* and the prefix covers */
+  for (i = rep->cpfx; i < rep->cnt; i++) {
+    if (!c[i+1]) {              /* traverse the uncovered items */
+      c[i+1] = (TID*)malloc((size_t)(c[0][0]+1) *sizeof(TID));
+      if (!c[i+1]) return -1;   /* create a cover buffer */
+    }                           /* for the next prefix */
+    a = c[i];    x = a +*a+1;   /* intersect the cover of the prefix */
+    b = rep->tidls[rep->items[i]];  /* with the id list of the item */
+    y = b +*b+1; d = c[i+1]+1;  /* (both lists are sorted) */
+    for (a++, b++; (a < x) && (b < y); ) {
+      if      (*a < *b) a++;    /* skip identifiers that are */
+      else if (*a > *b) b++;    /* only in one of the lists */
+      else { *d++ = *a++; b++; }/* and copy identifiers */
+    }                           /* that are in both lists */
+    c[i+1][0] = (TID)(d -c[i+1] -1);
+  }                             /* store the size of the cover */
+  rep->cpfx   = rep->cnt;       /* all prefix covers are valid now */
+  rep->tids   = c[rep->cnt]+1;  /* set the cover of the item set */
+  rep->tidcnt = c[rep->cnt][0]; /* as the transaction id array */
+  return 0;                     /* return 'ok' */
+}  /* cover() */
+
+/*--------------------------------------------------------------------*/
+
 ptrdiff_t isr_report (ISREPORT *rep)
 {                               /* --- report the current item set */
   ITEM   n, k;                  /* number of perfect extensions */
@@ -1113,6 +1880,7 @@ ptrdiff_t isr_report (ISREPORT *rep)
   size_t m, c;                  /* buffers for item set counting */
   double w;                     /* buffer for an item set weight */
   RSUPP  s;                     /* support buffer */
+  int    x = 0;                 /* flag for a computed cover */
   #ifdef ISR_CLOMAX             /* if closed/maximal filtering */
   RSUPP  r;                     /* support buffer */
   ITEM   *items;                /* item set for prefix tree update */
@@ -1143,6 +1911,10 @@ ptrdiff_t isr_report (ISREPORT *rep)
   if ((rep->cnt   > rep->max)   /* if the item set is too large or */
   ||  (rep->cnt+n < rep->min))  /* the minimum size cannot be reached */
     return 0;                   /* with prefect extensions, abort */
+  if (rep->tidls && rep->tidfile && !rep->tids) {
+    if (cover(rep) < 0) return -1;
+    x = 1;                      /* compute the cover of the item set */
+  }                             /* (perfect extensions have the same) */
   if (rep->fast < 0) {          /* if just to count the item sets */
     /* if no output is produced and no item sets can be filtered out, */
     /* compute the number of item sets in the perfect ext. hypercube. */
@@ -1194,14 +1966,15 @@ ptrdiff_t isr_report (ISREPORT *rep)
       rep->items[rep->cnt++] = rep->pexs[k];
     if (rep->fast) fastout(rep, 0); /* report the expanded set */
     else           output (rep);    /* (fast or normal output) */
+    if (x) rep->tids = NULL;    /* clear a computed cover and */
     rep->cnt -= n; return 1;    /* remove the perfect extensions */
   }                             /* and abort the function */
   m = rep->rep;                 /* note the number of reported sets */
+  s = rep->supps[rep->cnt];     /* set support for pex. hypercube */
+  for (k = 0; ++k <= n; ) rep->supps[rep->cnt+k] = s;
   if (rep->fast)                /* if fast output is possible, */
     fastout(rep, n);            /* report item sets recursively */
   else {                        /* if fast output is not possible */
-    s = rep->supps[rep->cnt];   /* set support for pex. hypercube */
-    for (k = 0; ++k <= n; ) rep->supps[rep->cnt+k] = s;
     if (rep->wgts) {            /* if there are item set weights, */
       w = rep->wgts[rep->cnt];  /* set weights for pex. hypercube */
       for (k = 0; ++k <= n; ) rep->wgts[rep->cnt+k] = w;
@@ -1212,6 +1985,7 @@ ptrdiff_t isr_report (ISREPORT *rep)
   if (rep->psp && psp_error(rep->psp))
     return -1;                  /* check whether updating the */
   #endif                        /* pattern spectrum failed */
+  if (x) rep->tids = NULL;      /* clear a computed cover */
   #ifndef NDEBUG                /* in debug mode */
   isr_flush(rep);               /* flush the output buffer */
   #endif                        /* after every item set */
@@ -1249,6 +2023,45 @@ ptrdiff_t isr_reporto (ISREPORT *rep, ITEM *occs, TID n)
 
 /*--------------------------------------------------------------------*/
 
+ptrdiff_t isr_topout (ISREPORT *rep)
+{                               /* --- report the best item sets */
+  size_t i, k, n;               /* loop variables, heap size */
+  ISTOP  t, *h;                 /* heap element, heap */
+  int    e;                     /* error flag */
+
+  assert(rep && (rep->cnt <= 0));  /* check the function argument */
+  if (!rep->tops) return 0;     /* check for best item sets */
+  h = rep->tops;                /* sort the heap (heap sort), */
+  for (n = rep->topcnt; n > 1;){/* so that the best set is first */
+    t = h[--n]; h[n] = h[0];    /* move the worst set to the end */
+    for (i = 0; (k = i+i+1) < n; i = k) {
+      if ((k+1 < n) && (h[k+1].score < h[k].score)) k++;
+      if (t.score <= h[k].score) break;
+      h[i] = h[k];              /* sift the last element down */
+    }                           /* from the root of the heap */
+    h[i] = t;                   /* and store it in its place */
+  }
+  for (i = 0; i < rep->topcnt; i++) {
+    rep->cnt = h[i].cnt;        /* traverse the best item sets */
+    memcpy(rep->items, h[i].items, (size_t)h[i].cnt *sizeof(ITEM));
+    rep->supps[rep->cnt] = h[i].supp;
+    if (rep->wgts) rep->wgts[rep->cnt] = h[i].wgt;
+    rep->eval = h[i].eval;      /* set the item set as the current */
+    rep->pfx  = 0;              /* one (with its evaluation) and */
+    emit(rep);                  /* emit it (full output, since */
+  }                             /* the prefix is not valid) */
+  n = rep->topcnt;              /* note the number of best item sets, */
+  e = rep->toperr;              /* restore the empty current item set */
+  rep->cnt = rep->pfx = 0;      /* and clear the heap and error flag */
+  rep->topcnt = 0; rep->toperr = 0;
+  return (e) ? -1 : (ptrdiff_t)n;
+}  /* isr_topout() */
+
+/* The current item set must be empty when this function is called. */
+/* The item sets are reported with the best item set first.         */
+
+/*--------------------------------------------------------------------*/
+
 int isr_direct (ISREPORT *rep, const ITEM *items, ITEM n,
                 RSUPP supp, double wgt, double eval)
 {                               /* --- report an item set */
@@ -1258,6 +2071,8 @@ int isr_direct (ISREPORT *rep, const ITEM *items, ITEM n,
   &&    (items || (n <= 0)) && (supp >= 0));
   if ((n < rep->min) || (n > rep->max))
     return 0;                   /* check the item set size */
+  if ((n < rep->bdrcnt) && (supp < rep->border[n]))
+    return 0;                   /* check the support border */
   rep->stats[n]++;              /* count the reported item set */
   rep->rep++;                   /* (for its size and overall) */
   #ifdef ISR_PATSPEC            /* if pattern spectrum functions */
@@ -1265,6 +2080,8 @@ int isr_direct (ISREPORT *rep, const ITEM *items, ITEM n,
     return -1;                  /* if a pattern spectrum exists, */
   #endif                        /* count item set in pattern spectrum */
   if (!rep->file) return 0;     /* check for an output file */
+  if (rep->mode & ISR_BINARY) { /* if to write in binary form */
+    isr_binout(rep, ISR_BINEVAL, items, n, &supp, eval); return 0; }
   c = rep->cnt; rep->cnt = n;   /* note the number of items */
   isr_puts(rep, rep->hdr);      /* print the record header */
   if (n > 0)                    /* print the first item */
@@ -1291,6 +2108,8 @@ int isr_directx (ISREPORT *rep, const ITEM *items, ITEM n,
   &&    (items || (n <= 0)) && (supp >= 0));
   if ((n < rep->min) || (n > rep->max))
     return 0;                   /* check the item set size */
+  if ((n < rep->bdrcnt) && (supp < rep->border[n]))
+    return 0;                   /* check the support border */
   rep->stats[n]++;              /* count the reported item set */
   rep->rep++;                   /* (for its size and overall) */
   #ifdef ISR_PATSPEC            /* if pattern spectrum functions */
@@ -1298,6 +2117,8 @@ int isr_directx (ISREPORT *rep, const ITEM *items, ITEM n,
     return -1;                  /* if a pattern spectrum exists, */
   #endif                        /* count item set in pattern spectrum */
   if (!rep->file) return 0;     /* check for an output file */
+  if (rep->mode & ISR_BINARY) { /* if to write in binary form */
+    isr_binout(rep, ISR_BINEVAL, items, n, &supp, eval); return 0; }
   c = rep->cnt; rep->cnt = n;   /* note the number of items */
   isr_puts(rep, rep->hdr);      /* print the record header */
   if (n > 0) {                  /* if at least one item */
@@ -1320,7 +2141,8 @@ int isr_directx (ISREPORT *rep, const ITEM *items, ITEM n,
 int isr_rule (ISREPORT *rep, const ITEM *items, ITEM n,
               RSUPP supp, RSUPP body, RSUPP head, double eval)
 {                               /* --- report an association rule */
-  ITEM c;                       /* buffer for the item counter */
+  ITEM  c;                      /* buffer for the item counter */
+  RSUPP s[3];                   /* buffer for the support values */
 
   assert(rep                    /* check the function arguments */
   &&     items && (n > 0) && (supp >= 0));
@@ -1329,6 +2151,11 @@ int isr_rule (ISREPORT *rep, const ITEM *items, ITEM n,
   rep->stats[n]++;              /* count the reported rule */
   rep->rep++;                   /* (for its size and overall) */
   if (!rep->file) return 0;     /* check for an output file */
+  if (rep->mode & ISR_BINARY) { /* if to write in binary form */
+    s[0] = supp; s[1] = body; s[2] = head;
+    isr_binout(rep, ISR_BINEVAL|ISR_BINRULE, items, n, s, eval);
+    return 0;                   /* write items (head first), */
+  }                             /* support values and evaluation */
   c = rep->cnt; rep->cnt = n;   /* note the number of items */
   isr_puts(rep, rep->hdr);      /* print the record header */
   isr_puts(rep, rep->inames[*items++]);
@@ -1350,7 +2177,8 @@ int isr_rule (ISREPORT *rep, const ITEM *items, ITEM n,
 int isr_seqrule (ISREPORT *rep, const ITEM *items, ITEM n,
                  RSUPP supp, RSUPP body, RSUPP head, double eval)
 {                               /* --- report a sequence rule */
-  ITEM c;                       /* buffer for the item counter */
+  ITEM  c;                      /* buffer for the item counter */
+  RSUPP s[3];                   /* buffer for the support values */
 
   assert(rep                    /* check the function arguments */
   &&     items && (n > 0) && (supp >= 0));
@@ -1359,6 +2187,12 @@ int isr_seqrule (ISREPORT *rep, const ITEM *items, ITEM n,
   rep->stats[n]++;              /* count the reported rule */
   rep->rep++;                   /* (for its size and overall) */
   if (!rep->file) return 0;     /* check for an output file */
+  if (rep->mode & ISR_BINARY) { /* if to write in binary form */
+    s[0] = supp; s[1] = body; s[2] = head;
+    isr_binout(rep, ISR_BINEVAL|ISR_BINRULE|ISR_BINSEQ,
+               items, n, s, eval);
+    return 0;                   /* write items (head last), */
+  }                             /* support values and evaluation */
   c = rep->cnt; rep->cnt = n;   /* note the number of items */
   isr_puts(rep, rep->hdr);      /* print the record header */
   if (--n > 0)                  /* print the first item in body */
@@ -30,6 +30,12 @@
             2013.03.18 function isr_check() added (check for a superset)
             2013.10.08 function isr_seqrule() added (head at end)
             2013.10.15 result of isr_direct[x]() and isr_[seq]rule()
+            2026.10.19 binary output mode ISR_BINARY added
+            2026.10.19 reporter clones added (for parallel reporting)
+            2026.10.19 function isr_tidlists() added (trans. id covers)
+            2026.10.19 compressed output (file names *.gz, needs ZLIB)
+            2026.10.19 collection of the best item sets (isr_settop())
+            2026.10.19 support border per item set size (isr_setbdr())
 ----------------------------------------------------------------------*/
 #ifndef __REPORT__
 #define __REPORT__
@@ -129,6 +135,14 @@
 #define ISR_LOGS      0x0100    /* compute sums of logarithms */
 #define ISR_WEIGHTS   0x0200    /* allow for item set weights */
 #define ISR_SCAN      0x0400    /* report in scanable form */
+#define ISR_BINARY    0x0800    /* report in binary form */
+
+/* --- binary output format --- */
+#define ISR_BINMAGIC  "ISRB"    /* magic string at start of file */
+#define ISR_BINVERS   1         /* version of the binary format */
+#define ISR_BINEVAL   0x0001    /* records contain an evaluation */
+#define ISR_BINRULE   0x0002    /* records contain body/head support */
+#define ISR_BINSEQ    0x0004    /* rule head is last item (not first) */
 
 /* --- delete modes --- */
 #define ISR_DELISET   0x0001    /* delete the item set */
@@ -141,10 +155,23 @@ struct isreport;                /* --- an item set eval. function --- */
 typedef double ISEVALFN (struct isreport *rep, void *data);
 typedef void   ISREPOFN (struct isreport *rep, void *data);
 
+typedef struct {                /* --- a best item set (top n) --- */
+  double     score;             /* score (eval. times direction) */
+  double     eval;              /* additional evaluation value */
+  double     wgt;               /* weight of the item set */
+  RSUPP      supp;              /* support of the item set */
+  ITEM       cnt;               /* number of items in the set */
+  ITEM       size;              /* size of the item array */
+  ITEM       *items;            /* items in the set */
+} ISTOP;                        /* (best item set) */
+
 typedef struct isreport {       /* --- an item set reporter --- */
   ITEMBASE   *base;             /* underlying item base */
+  struct isreport *src;         /* reporter this one was cloned from */
   FILE       *file;             /* output file to write to */
   const char *name;             /* name of item set output file */
+  void       *zout;             /* compressed output stream */
+  void       *ztid;             /* compressed trans. id stream */
   char       *buf;              /* write buffer for output */
   char       *next;             /* next character position to write */
   char       *end;              /* end of the write buffer */
@@ -154,6 +181,8 @@ typedef struct isreport {       /* --- an item set reporter --- */
   ITEM       maxx;              /* maximum number for isr_xable() */
   RSUPP      smin;              /* minimum support */
   RSUPP      smax;              /* maximum support */
+  ITEM       bdrcnt;            /* number of border values */
+  RSUPP      *border;           /* minimum support per item set size */
   ITEM       cnt;               /* current number of items in set */
   ITEM       pfx;               /* number of items in valid prefix */
   ITEM       *items;            /* current item set (array of items) */
@@ -195,6 +224,7 @@ typedef struct isreport {       /* --- an item set reporter --- */
   const char *format;           /* format for information output */
   const char **inames;          /* (formatted) item names */
   int        fast;              /* whether fast output is possible */
+  int        binf;              /* binary format flags (-1: no hdr.) */
   int        size;              /* size of set info. for fastout() */
   char       info[64];          /* item set info.    for fastout() */
   FILE       *tidfile;          /* output file for transaction ids */
@@ -204,6 +234,15 @@ typedef struct isreport {       /* --- an item set reporter --- */
   TID        tidcnt;            /* number of transaction ids */
   TID        tracnt;            /* total number of transactions */
   ITEM       miscnt;            /* accepted number of missing items */
+  char       *tidbuf;           /* write buffer for trans. ids */
+  char       *tidnxt;           /* next character position to write */
+  char       *tidend;           /* end of the trans. id write buffer */
+  TID        **tidls;           /* trans. id lists of items, covers */
+  ITEM       cpfx;              /* number of items with valid cover */
+  ISTOP      *tops;             /* heap of the best item sets */
+  size_t     topmax;            /* maximum number of best item sets */
+  size_t     topcnt;            /* current number of best item sets */
+  int        toperr;            /* error flag for best item sets */
   char       *out;              /* output buffer for sets/rules */
   char       *pos[1];           /* append positions in output buffer */
 } ISREPORT;                     /* (item set reporter) */
@@ -214,6 +253,12 @@ typedef struct isreport {       /* --- an item set reporter --- */
 extern ISREPORT*  isr_create   (ITEMBASE *base, int mode, int dir,
                                 CCHAR *hdr, CCHAR *sep, CCHAR *imp);
 extern int        isr_delete   (ISREPORT *rep, int mode);
+extern ISREPORT*  isr_clone    (ISREPORT *rep, void *evaldat);
+extern int        isr_merge    (ISREPORT *rep, ISREPORT *clone);
+extern int        isr_append   (ISREPORT *rep, ISREPORT *clone,
+                                size_t beg, size_t end);
+extern size_t     isr_outpos   (ISREPORT *rep);
+extern void*      isr_evaldat  (ISREPORT *rep);
 extern ITEMBASE*  isr_base     (ISREPORT *rep);
 extern int        isr_mode     (ISREPORT *rep);
 extern int        isr_target   (ISREPORT *rep);
@@ -227,6 +272,8 @@ extern void       isr_setfmt   (ISREPORT *rep, const char *format);
 extern void       isr_setiwf   (ISREPORT *rep, const char *format);
 extern void       isr_setsize  (ISREPORT *rep, ITEM  min, ITEM  max);
 extern void       isr_setsupp  (ISREPORT *rep, RSUPP min, RSUPP max);
+extern int        isr_setbdr   (ISREPORT *rep, ITEM size, RSUPP supp);
+extern void       isr_clrbdr   (ISREPORT *rep);
 extern void       isr_seteval  (ISREPORT *rep, ISEVALFN evalfn,
                                 void *data, int dir, double thresh);
 extern void       isr_setrepo  (ISREPORT *rep, ISREPOFN repofn,
@@ -234,6 +281,10 @@ extern void       isr_setrepo  (ISREPORT *rep, ISREPOFN repofn,
 extern int        isr_tidopen  (ISREPORT *rep, FILE *file, CCHAR *name);
 extern int        isr_tidclose (ISREPORT *rep);
 extern void       isr_tidcfg   (ISREPORT *rep, TID tracnt, ITEM miscnt);
+extern int        isr_tidlists (ISREPORT *rep, TABAG *bag);
+extern int        isr_settop   (ISREPORT *rep, size_t n);
+extern size_t     isr_topmax   (ISREPORT *rep);
+extern ptrdiff_t  isr_topout   (ISREPORT *rep);
 extern FILE*      isr_tidfile  (ISREPORT *rep);
 extern CCHAR*     isr_tidname  (ISREPORT *rep);
 extern void       isr_setsmt   (ISREPORT *rep, RSUPP supp);
@@ -282,6 +333,7 @@ extern double     isr_logsize  (ISREPORT *rep, void *data);
 extern double     isr_sizewgt  (ISREPORT *rep, void *data);
 extern double     isr_wgtsize  (ISREPORT *rep, void *data);
 extern double     isr_wgtsupp  (ISREPORT *rep, void *data);
+extern double     isr_suppfac  (ISREPORT *rep, void *data);
 
 extern ptrdiff_t  isr_report   (ISREPORT *rep);
 extern ptrdiff_t  isr_reportx  (ISREPORT *rep, TID  *tids, TID n);
@@ -330,11 +382,14 @@ extern int        isr_tail     (ISREPORT *rep,
 #define isr_target(r)     ((r)->mode & ISR_TARGET)
 #define isr_file(r)       ((r)->file)
 #define isr_name(r)       ((r)->name)
+#define isr_outpos(r)     ((size_t)((r)->next -(r)->buf))
+#define isr_evaldat(r)    ((r)->evaldat)
 
 #define isr_setfmt(r,f)   ((r)->format = (f))
 #define isr_setiwf(r,f)   ((r)->iwfmt  = (f))
 #define isr_tidfile(r)    ((r)->tidfile)
 #define isr_tidname(r)    ((r)->tidname)
+#define isr_topmax(r)     ((r)->topmax)
 #define isr_setsmt(r,s)   ((r)->supps[0] = (s))
 #define isr_setwgt(r,w)   ((r)->wgts [0] = (w))
 #define isr_min(r)        ((r)->min)
@@ -83,6 +83,18 @@
             2013.06.19 bug in function wi_cmp() fixed (weight comp.)
             2013.07.09 static constants emsgs and errmsgs merged
             2013.11.07 transaction reading capability made optional
+            2026.10.19 transaction tree nodes allocated from an arena
+            2026.10.19 optional parallel construction of tree (threads)
+            2026.10.19 optional parallel bucket sort of transactions
+            2026.10.19 insertion sort for short transactions inlined
+            2026.10.19 function tbg_hreduce() added (hash reduction)
+            2026.10.19 packed item fast path added to tbg_occur()
+            2026.10.19 vertical index added (tbg_index(), tbg_cover())
+            2026.10.19 function tbg_surr() added (surrogate data sets)
+            2026.10.19 tbg_ipwgt() uses rarest item, parallel version
+            2026.10.19 function tbg_ifilter() added (incremental filter)
+            2026.10.19 tbg_occur(): items to pack anywhere in a query
+            2026.10.19 option -h in main program (check tbg_hreduce())
 ----------------------------------------------------------------------*/
 #include <stdio.h>
 #include <stdlib.h>
@@ -100,6 +112,9 @@
 #ifdef STORAGE
 #include "storage.h"
 #endif
+#ifdef TA_THREADS
+#include <pthread.h>
+#endif
 
 #ifdef _MSC_VER
 #ifndef snprintf
@@ -132,12 +147,21 @@
 #define E_OPTARG     (-7)       /* missing option argument */
 #define E_ARGCNT     (-8)       /* too few/many arguments */
 #define E_ITEMCNT    (-9)       /* invalid number of items */
+#define E_REDUCE    (-10)       /* hash reduction differs */
 /* error codes -15 to -25 defined in tract.h */
 
 #define BLKSIZE      1024       /* block size for enlarging arrays */
 #define TH_INSERT       8       /* threshold for insertion sort */
+#define TH_THREADS   4096       /* threshold for parallel sorting */
+#define SWAPFAC         4       /* swaps per item instance (surr.) */
+#define TH_IPWGT      256       /* threshold for parallel weights */
+#define IPWCHUNK       64       /* transactions per weight job */
 #define TS_PRIMES    (sizeof(primes)/sizeof(*primes))
 
+#define TAT_ROUND(z) (((z) +7) & ~(size_t)7)
+#define TAT_BOUND(e) (((e)+1) *(sizeof(TANODE)+16) \
+                     +(e) *(sizeof(ITEM)+sizeof(TANODE*)))
+
 #ifndef QUIET                   /* if not quiet version, */
 #define MSG         fprintf     /* print messages */
 #else                           /* if quiet version, */
@@ -156,6 +180,73 @@
 typedef ITEM SUBFN  (const TRACT  *t1, const TRACT  *t2, ITEM off);
 typedef ITEM SUBWFN (const WTRACT *t1, const WTRACT *t2, ITEM off);
 
+typedef struct {                /* --- idempotent weight computation */
+  TABAG    *bag;                /* transaction bag to process */
+  void     ***occs;             /* item occurrence arrays */
+  const TID *cnts;              /* number of occurrences per item */
+  int      mode;                /* subset test and weight mode */
+  SUBFN    *sub;                /* subset/subsequence function */
+  SUBWFN   *subw;               /* ditto, for weighted items */
+  #ifdef TA_THREADS             /* if to use multiple threads */
+  pthread_mutex_t lock;         /* lock for the transaction counter */
+  TID      min;                 /* start of the current size class */
+  TID      next;                /* end of the unprocessed part */
+  #endif
+} TBGIPW;                       /* (idempotent weight computation) */
+
+typedef struct {                /* --- transaction filter job --- */
+  void     **tracts;            /* transactions to filter */
+  TID      cnt;                 /* number of transactions */
+  char     *chg;                /* flags for changed transactions */
+  const int *marks;             /* item markers (items to keep) */
+  ITEM     min;                 /* minimal size of a transaction */
+  double   wgt;                 /* minimal weight of an item */
+  int      mode;                /* mode of the transaction bag */
+  ITEM     max;                 /* maximal size of a transaction */
+  size_t   extent;              /* number of item instances */
+  TID      chgcnt;              /* number of changed transactions */
+} TBGFILT;                      /* (transaction filter job) */
+
+#ifdef TA_THREADS
+typedef struct {                /* --- section sorting job --- */
+  TRACT    **tracts;            /* transactions of the section */
+  TID      cnt;                 /* number of transactions */
+  TRACT    **buf;               /* buffer for the transactions */
+} TBGJOB;                       /* (section sorting job) */
+
+typedef struct {                /* --- parallel sorting data --- */
+  pthread_mutex_t lock;         /* lock for the job counter */
+  TBGJOB   *jobs;               /* section sorting jobs */
+  TID      cnt;                 /* number of jobs */
+  TID      next;                /* index of the next job to process */
+  ITEM     k;                   /* number of items */
+  ITEM     mask;                /* mask for packed item treatment */
+} TBGWORK;                      /* (parallel sorting data) */
+
+typedef struct {                /* --- hash value computation job --- */
+  TRACT    **tracts;            /* transactions to process */
+  TID      cnt;                 /* number of transactions */
+  size_t   *hvs;                /* hash values of the transactions */
+} TBGHASH;                      /* (hash value computation job) */
+#endif
+
+#if defined TATREEFN && !defined TATCOMPACT && defined TA_THREADS
+typedef struct {                /* --- subtree construction job --- */
+  TRACT    **tracts;            /* transactions of the subtree */
+  TID      cnt;                 /* number of transactions */
+  char     *beg;                /* start of the arena for the subtree */
+  char     *end;                /* end   of the used part of arena */
+  TANODE   **node;              /* where to store the subtree root */
+} TATJOB;                       /* (subtree construction job) */
+
+typedef struct {                /* --- parallel construction data --- */
+  pthread_mutex_t lock;         /* lock for the job counter */
+  TATJOB   *jobs;               /* subtree construction jobs */
+  ITEM     cnt;                 /* number of jobs */
+  ITEM     next;                /* index of the next job to process */
+} TATWORK;                      /* (parallel construction data) */
+#endif
+
 /*----------------------------------------------------------------------
   Constants
 ----------------------------------------------------------------------*/
@@ -201,7 +292,8 @@ static CCHAR *errmsgs[] = {     /* error messages */
   /* E_OPTARG   -7 */  "missing option argument",
   /* E_ARGCNT   -8 */  "wrong number of arguments",
   /* E_ITEMCNT  -9 */  "invalid number of items (must be <= 16)",
-  /*    -10 to -14 */  NULL, NULL, NULL, NULL, NULL,
+  /* E_REDUCE  -10 */  "hash reduction differs (transaction %"TID_FMT")",
+  /*    -11 to -14 */  NULL, NULL, NULL, NULL,
   /* E_NOITEMS -15 */  "no (frequent) items found",
   /* E_ITEMEXP -16 */  "#item expected",
   /* E_ITEMWGT -17 */  "#invalid item weight %s",
@@ -228,6 +320,7 @@ static CCHAR    *prgname;       /* program name for error messages */
 static TABREAD  *tread = NULL;  /* table/transaction reader */
 static ITEMBASE *ibase = NULL;  /* item base */
 static TABAG    *tabag = NULL;  /* transaction bag/multiset */
+static TABAG    *hbag  = NULL;  /* bag for checking tbg_hreduce() */
 #endif
 
 #ifdef TA_READ                  /* if transaction reading capability */
@@ -1561,6 +1654,8 @@ TABAG* tbg_create (ITEMBASE *base)
   bag->tracts = NULL;           /* there are no transactions yet */
   bag->icnts  = NULL;
   bag->ifrqs  = NULL;
+  bag->xcnt   = 0;              /* there is no vertical index yet */
+  bag->tidx   = NULL;
   return bag;                   /* return the created t.a. bag */
 }  /* tbg_create() */
 
@@ -1575,6 +1670,7 @@ void tbg_delete (TABAG *bag, int delib)
     free(bag->tracts);          /* delete all transactions */
   }                             /* and the transaction array */
   if (bag->icnts) free (bag->icnts);
+  tbg_noidx(bag);               /* delete the vertical index */
   if (delib) ib_delete(bag->base);
   free(bag);                    /* delete the item base and */
 }  /* tbg_delete() */           /* the transaction bag body */
@@ -1653,6 +1749,7 @@ int tbg_add (TABAG *bag, TRACT *t)
     return E_NOMEM;             /* get trans. from item base if nec. */
   if (bag->icnts) {             /* delete the item-specific counters */
     free(bag->icnts); bag->icnts = NULL; bag->ifrqs = NULL; }
+  tbg_noidx(bag);               /* and the vertical index */
   bag->tracts[bag->cnt++] = t;  /* store the transaction and */
   bag->wgt += t->wgt;           /* sum the transaction weight */
   if (t->size > bag->max)       /* update maximal transaction size */
@@ -1681,6 +1778,7 @@ int tbg_addw (TABAG *bag, WTRACT *t)
     return E_NOMEM;             /* get trans. from item base if nec. */
   if (bag->icnts) {             /* delete the item-specific counters */
     free(bag->icnts); bag->icnts = NULL; bag->ifrqs = NULL; }
+  tbg_noidx(bag);               /* and the vertical index */
   bag->tracts[bag->cnt++] = t;  /* store the transaction and */
   bag->wgt += t->wgt;           /* sum the transaction weight */
   if (t->size > bag->max)       /* update maximal transaction size */
@@ -1757,6 +1855,7 @@ static void recode (TABAG *bag, ITEM *map)
   assert(bag && map);           /* check the function arguments */
   if (bag->icnts) {             /* delete the item-specific counters */
     free(bag->icnts); bag->icnts = NULL; bag->ifrqs = NULL; }
+  tbg_noidx(bag);               /* and the vertical index */
   bag->extent = 0; bag->max = 0;/* clear maximal transaction size */
   if (bag->mode & IB_WEIGHTS) { /* if the items carry weights */
     for (n = 0; n < bag->cnt; n++) {
@@ -1814,6 +1913,7 @@ void tbg_filter (TABAG *bag, ITEM min, const int *marks, double wgt)
 
   assert(bag);                  /* check the function arguments */
   if (!marks && (min <= 1)) return;
+  tbg_noidx(bag);               /* delete the vertical index */
   if (bag->icnts) {             /* delete the item-specific counters */
     free(bag->icnts); bag->icnts = NULL; bag->ifrqs = NULL; }
   bag->extent = 0;              /* clear the item instance counter */
@@ -1864,6 +1964,7 @@ void tbg_trim (TABAG *bag, ITEM min, const int *marks, double wgt)
   WITEM  *a, *b;                /* to traverse the items */
 
   assert(bag);                  /* check the function arguments */
+  tbg_noidx(bag);               /* delete the vertical index */
   bag->extent = 0;              /* clear the item instance counter */
   bag->max    = 0;              /* and the maximal transaction size */
   if (bag->icnts) {             /* delete the item-specific counters */
@@ -1919,6 +2020,34 @@ void tbg_trim (TABAG *bag, ITEM min, const int *marks, double wgt)
 
 /*--------------------------------------------------------------------*/
 
+static void isort (ITEM *items, ITEM n, int dir)
+{                               /* --- sort a short item array */
+  ITEM i, x;                    /* loop variable, item to insert */
+  ITEM *p;                      /* to traverse the items */
+
+  assert(items);                /* check the function arguments */
+  if (dir < 0) {                /* if to sort in descending order */
+    for (i = 1; i < n; i++) {   /* standard insertion sort */
+      for (x = items[i], p = items+i; (p > items) && (p[-1] < x); p--)
+        *p = p[-1];             /* shift right all items that are */
+      *p = x;                   /* smaller than the one to insert */
+    } }                         /* and store the item to insert */
+  else {                        /* if to sort in ascending order */
+    for (i = 1; i < n; i++) {   /* standard insertion sort */
+      for (x = items[i], p = items+i; (p > items) && (p[-1] > x); p--)
+        *p = p[-1];             /* shift right all items that are */
+      *p = x;                   /* greater than the one to insert */
+    }                           /* and store the item to insert */
+  }                             /* (direction is folded into the */
+}  /* isort() */                /* comparison, so no reversal) */
+
+/* Most transactions are short, so calling the general sort functions */
+/* (with their setup and a final reversal for descending order) costs */
+/* more than the actual sorting. Hence short transactions are sorted  */
+/* directly in the transaction loop of tbg_itsort().                  */
+
+/*--------------------------------------------------------------------*/
+
 void tbg_itsort (TABAG *bag, int dir, int heap)
 {                               /* --- sort items in transactions */
   ITEM   k;                     /* number of items */
@@ -1941,7 +2070,8 @@ void tbg_itsort (TABAG *bag, int dir, int heap)
       if (k < 2) continue;      /* do not sort less than two items */
       while ((k > 0) && (t->items[k-1] <= TA_END))
         --k;                    /* skip additional end markers */
-      sortfn(t->items, (size_t)k, dir);
+      if (k <= TH_INSERT) isort(t->items, k, dir);
+      else sortfn(t->items, (size_t)k, dir);
     }                           /* sort the items in the transaction */
   }                             /* if the given direction is negative */
 }  /* tbg_itsort() */
@@ -2065,6 +2195,94 @@ static void sort (TRACT **tracts, TID n, ITEM o,
     sort(tracts, m, o+1, buf, cnts, k, mask);
 }  /* sort() */                 /* finally sort the last section */
 
+/*--------------------------------------------------------------------*/
+#ifdef TA_THREADS
+
+static void sortjobs (TBGWORK *work, TID *cnts)
+{                               /* --- process section sorting jobs */
+  TBGJOB *job;                  /* current section sorting job */
+
+  while (1) {                   /* while there are jobs left */
+    pthread_mutex_lock(&work->lock);
+    job = (work->next < work->cnt) ? work->jobs +work->next++ : NULL;
+    pthread_mutex_unlock(&work->lock);
+    if (!job) return;           /* get the next job (if any) */
+    sort(job->tracts, job->cnt, 1, job->buf, cnts, work->k, work->mask);
+  }                             /* sort the section from offset 1 */
+}  /* sortjobs() */
+
+/*--------------------------------------------------------------------*/
+
+static void* sorter (void *data)
+{                               /* --- sort sections (thread) */
+  TBGWORK *work = (TBGWORK*)data;  /* parallel sorting data */
+  TID     *cnts;                /* counter array for bin sort */
+
+  cnts = (TID*)malloc((size_t)(work->k+1) *sizeof(TID));
+  if (!cnts) return NULL;       /* create a counter array */
+  sortjobs(work, cnts+1);       /* process section sorting jobs */
+  free(cnts);                   /* delete the counter array */
+  return NULL;                  /* return a dummy result */
+}  /* sorter() */
+
+/*--------------------------------------------------------------------*/
+
+static int psort (TRACT **tracts, TID n, TRACT **buf, TID *cnts,
+                  ITEM k, ITEM mask)
+{                               /* --- sort trans. with threads */
+  TID       i, m;               /* loop variables */
+  ITEM      x;                  /* loop variable, item buffer */
+  TRACT     **t;                /* to traverse the transactions */
+  TBGWORK   work;               /* parallel sorting data */
+  TBGJOB    *job;               /* to traverse the jobs */
+  pthread_t thds[TA_THREADS];   /* worker threads */
+  int       c;                  /* number of started threads */
+
+  assert(tracts && buf && cnts);/* check the function arguments */
+  if (n < TH_THREADS) return -1;/* sort few transactions plainly */
+  memset(cnts-1, 0, (size_t)(k+1) *sizeof(TID));
+  for (t = tracts+n; --t >= tracts; ) {
+    x = (*t)->items[0];         /* traverse the transactions */
+    if (x < 0) { if (x > TA_END) return -1; x = -1; }
+    cnts[x]++;                  /* count the transactions per item */
+  }                             /* (packed items are sorted plainly) */
+  for (m = 0, x = 0; x < k; x++)
+    if (cnts[x] > 0) m++;       /* count the non-empty sections */
+  if (m < 2) return -1;         /* check for at least two sections */
+  work.jobs = (TBGJOB*)malloc((size_t)m *sizeof(TBGJOB));
+  if (!work.jobs) return -1;    /* create the job array */
+  memcpy(buf, tracts, (size_t)n *sizeof(TRACT*));
+  for (x = 0; x < k; x++)       /* traverse the items and compute */
+    cnts[x] += cnts[x-1];       /* offsets for storing transactions */
+  for (t = buf+n; --t >= buf; ) {
+    x = (*t)->items[0];         /* traverse the transactions again */
+    if (x < 0) x = -1;          /* and sort them w.r.t. first item */
+    tracts[--cnts[x]] = *t;     /* (exactly as the first level */
+  }                             /* of the function sort() does) */
+  for (work.cnt = 0, x = 0; x < k; x++) {
+    i = cnts[x];                /* traverse the sections */
+    m = ((x < k-1) ? cnts[x+1] : n) -i;
+    if (m < 2) continue;        /* skip sections with one trans. */
+    job = work.jobs +work.cnt++;/* set up a sorting job that uses */
+    job->tracts = tracts+i;     /* the corresponding part of the */
+    job->buf    = buf   +i;     /* transaction buffer */
+    job->cnt    = m;            /* (sections are disjoint, so they */
+  }                             /* can be sorted independently) */
+  work.next = 0; work.k = k;    /* start with the first job */
+  work.mask = mask;             /* and note the packed item mask */
+  pthread_mutex_init(&work.lock, NULL);
+  for (c = 0; c < TA_THREADS-1; c++)
+    if (pthread_create(thds+c, NULL, sorter, &work) != 0) break;
+  sortjobs(&work, cnts);        /* start the worker threads and */
+  while (--c >= 0)              /* also sort in the calling thread */
+    pthread_join(thds[c], NULL);
+  pthread_mutex_destroy(&work.lock);
+  free(work.jobs);              /* delete the job array */
+  return 0;                     /* return 'ok' */
+}  /* psort() */
+
+#endif
+
 /*--------------------------------------------------------------------*/
 
 void tbg_sort (TABAG *bag, int dir, int mode)
@@ -2077,6 +2295,7 @@ void tbg_sort (TABAG *bag, int dir, int mode)
   CMPFN *cmp;                   /* comparison function */
 
   assert(bag);                  /* check the function arguments */
+  tbg_noidx(bag);               /* delete the vertical index */
   if (bag->cnt < 2) return;     /* check for at least two trans. */
   n = bag->cnt;                 /* get the number of transactions */
   k = ib_cnt(bag->base);        /* and the number of items */
@@ -2090,6 +2309,9 @@ void tbg_sort (TABAG *bag, int dir, int mode)
     if ((size_t)k < (size_t)n){ /* if bin sort is possible/favorable, */
       cnts = (TID*)(buf+n)+1;   /* use bin sort to sort transactions */
       mask = (mode & TA_EQPACK) ? ITEM_MIN : -1;
+      #ifdef TA_THREADS         /* if to use multiple threads, */
+      if (psort((TRACT**)bag->tracts, n, buf, cnts, k, mask) != 0)
+      #endif                    /* sort top-level sections in parallel */
       sort((TRACT**)bag->tracts, n, 0, buf, cnts, k, mask);
       if (dir < 0)              /* if necessary, reverse the order */
         ptr_reverse(bag->tracts, (size_t)n); }
@@ -2113,6 +2335,7 @@ void tbg_sortsz (TABAG *bag, int dir, int mode)
   TID n;                        /* number of transactions */
 
   assert(bag);                  /* check the function arguments */
+  tbg_noidx(bag);               /* delete the vertical index */
   n = bag->cnt;                 /* get the number of transactions */
   if (bag->mode & IB_WEIGHTS) { /* if the items carry weights, */
     if (mode & TA_HEAP)         /* sort with weighted item functions */
@@ -2136,6 +2359,7 @@ TID tbg_reduce (TABAG *bag, int keep0)
   TRACT **s, **d;               /* to traverse the transactions */
 
   assert(bag);                  /* check the function argument */
+  tbg_noidx(bag);               /* delete the vertical index */
   if (bag->cnt <= 1) return 1;  /* deal only with two or more trans. */
   if (bag->icnts) {             /* delete the item-specific counters */
     free(bag->icnts); bag->icnts = NULL; bag->ifrqs = NULL; }
@@ -2165,6 +2389,325 @@ TID tbg_reduce (TABAG *bag, int keep0)
 
 /*--------------------------------------------------------------------*/
 
+static size_t tahash (const TRACT *t)
+{                               /* --- compute hash value of trans. */
+  size_t     h;                 /* computed hash value */
+  const ITEM *s;                /* to traverse the items */
+
+  assert(t);                    /* check the function argument */
+  for (h = 0, s = t->items; *s > TA_END; s++)
+    h = h *16777619 +(size_t)*s;/* traverse the items (incl. packed) */
+  return h;                     /* and combine their identifiers */
+}  /* tahash() */
+
+/*--------------------------------------------------------------------*/
+#ifdef TA_THREADS
+
+static void* hasher (void *data)
+{                               /* --- compute hash values (thread) */
+  TBGHASH *job = (TBGHASH*)data;/* hash value computation job */
+  TID     i;                    /* loop variable */
+
+  for (i = 0; i < job->cnt; i++)/* compute the hash values */
+    job->hvs[i] = tahash(job->tracts[i]);
+  return NULL;                  /* return a dummy result */
+}  /* hasher() */
+
+/*--------------------------------------------------------------------*/
+
+static void phash (TRACT **tracts, TID n, size_t *hvs)
+{                               /* --- compute hash values (threads) */
+  TID       i, k;               /* loop variable, chunk size */
+  TBGHASH   jobs[TA_THREADS];   /* hash value computation jobs */
+  pthread_t thds[TA_THREADS];   /* worker threads */
+  int       c;                  /* loop variable for threads */
+
+  assert(tracts && hvs);        /* check the function arguments */
+  k = (n +TA_THREADS-1) /TA_THREADS;   /* compute the chunk size */
+  for (c = 0, i = 0; c < TA_THREADS; c++, i += k) {
+    jobs[c].tracts = tracts +i; /* split the transaction array */
+    jobs[c].hvs    = hvs    +i; /* into contiguous chunks */
+    jobs[c].cnt    = (i >= n) ? 0 : (n-i < k) ? n-i : k;
+  }                             /* (last chunk may be smaller) */
+  for (c = 1; c < TA_THREADS; c++)
+    if (pthread_create(thds+c, NULL, hasher, jobs+c) != 0) break;
+  hasher(jobs);                 /* process the first chunk directly */
+  for (i = c; i < TA_THREADS; i++)
+    hasher(jobs+i);             /* process chunks without a thread */
+  while (--c > 0)               /* wait for the worker threads */
+    pthread_join(thds[c], NULL);
+}  /* phash() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+TID tbg_hreduce (TABAG *bag, int keep0)
+{                               /* --- reduce a trans. bag (hashing) */
+  /* This function presupposes that the items in each transaction    */
+  /* have been sorted (e.g. with tbg_itsort()), but the transactions */
+  /* themselves need not be sorted. Equal transactions are combined  */
+  /* into their first occurrence, so the order of the unique ones is */
+  /* kept. Hence only the (much smaller) reduced transaction bag has */
+  /* to be sorted afterwards, if a sorted bag is needed.             */
+  TID    i, j;                  /* loop variables */
+  size_t h, k, x, z;            /* hash value, bin index, table size */
+  size_t *hvs;                  /* hash values of the transactions */
+  TID    *htab;                 /* hash table (trans. indices +1) */
+  TRACT  **tracts;              /* transaction array */
+  TRACT  *t, *u;                /* to traverse the transactions */
+
+  assert(bag);                  /* check the function argument */
+  tbg_noidx(bag);               /* delete the vertical index */
+  if (bag->cnt <= 1) return bag->cnt;  /* deal only with two or more */
+  z    = (size_t)taa_tabsize(bag->cnt);/* get the hash table size */
+  hvs  = (bag->mode & IB_WEIGHTS) ? NULL
+       : (size_t*)malloc((size_t)bag->cnt *sizeof(size_t)
+                         +z *sizeof(TID));
+  if (!hvs) {                   /* if weighted items or no memory */
+    tbg_sort(bag, 0, 0);        /* sort the transactions and */
+    return tbg_reduce(bag, keep0);  /* reduce them afterwards */
+  }                             /* (failsafe and weighted version) */
+  htab = (TID*)(hvs +bag->cnt); /* organize the memory and */
+  memset(htab, 0, z *sizeof(TID));     /* clear the hash table */
+  if (bag->icnts) {             /* delete the item-specific counters */
+    free(bag->icnts); bag->icnts = NULL; bag->ifrqs = NULL; }
+  tracts = (TRACT**)bag->tracts;/* get the transaction array */
+  #ifdef TA_THREADS             /* if to use multiple threads, */
+  if (bag->cnt >= TH_THREADS)   /* compute hash values in parallel */
+    phash(tracts, bag->cnt, hvs);
+  else                          /* if there are only few trans., */
+  #endif                        /* compute the hash values plainly */
+  for (i = 0; i < bag->cnt; i++) hvs[i] = tahash(tracts[i]);
+  for (i = 0; i < bag->cnt; i++) {
+    t = tracts[i];              /* traverse the transactions */
+    h = hvs[i];                 /* get the hash value */
+    k =  h %  z;                /* compute hash bin index */
+    x = (h % (z-2)) +1;         /* and probing step width */
+    for ( ; (j = htab[k]) > 0; k = (k+x) % z) {
+      u = tracts[j-1];          /* search transaction in hash table */
+      if ((hvs[j-1] == h) && (u->size == t->size)
+      &&  (ta_cmp(t, u, NULL) == 0))
+        break;                  /* if the transactions are equal, */
+    }                           /* abort probing (can combine) */
+    if (j <= 0) { htab[k] = i+1; continue; }
+    u->wgt += t->wgt;           /* if transaction is new, store it, */
+    free(t); tracts[i] = NULL;  /* otherwise combine transactions */
+  }                             /* by summing their weights */
+  free(hvs);                    /* delete the hash table */
+  bag->extent = 0;              /* reinit. number of item occurrences */
+  for (i = j = 0; i < bag->cnt; i++) {
+    if (!(t = tracts[i])) continue;
+    if (!keep0 && (t->wgt == 0)) { free(t); continue; }
+    bag->extent += (size_t)t->size;
+    tracts[j++] = t;            /* collect the unique transactions */
+  }                             /* (remove those with zero weight) */
+  return bag->cnt = j;          /* return new number of transactions */
+}  /* tbg_hreduce() */
+
+/*--------------------------------------------------------------------*/
+
+static void* ifilter (void *data)
+{                               /* --- filter transactions (thread) */
+  TBGFILT *job = (TBGFILT*)data;/* transaction filter job */
+  TID     n;                    /* loop variable for transactions */
+  ITEM    k;                    /* old size of a transaction */
+  TRACT   *t;                   /* to traverse the transactions */
+  WTRACT  *x;                   /* to traverse the transactions */
+  ITEM    *s, *d;               /* to traverse the items */
+  WITEM   *a, *b;               /* to traverse the items */
+
+  job->max = 0; job->extent = 0;/* init. the size statistics */
+  job->chgcnt = 0;              /* and the change counter */
+  if (job->mode & IB_WEIGHTS) { /* if the items carry weights */
+    for (n = 0; n < job->cnt; n++) {
+      x = (WTRACT*)job->tracts[n]; /* traverse the transactions */
+      k = x->size;              /* note the old transaction size */
+      if (job->marks) {         /* if item markers are given */
+        for (a = b = x->items; a->item >= 0; a++)
+          if (job->marks[a->item] && (a->wgt >= job->wgt))
+            *b++ = *a;          /* remove unmarked items */
+        x->size = (ITEM)(b -x->items);
+      }                         /* store the new number of items */
+      if (x->size < job->min)   /* if the transaction is too short, */
+        x->size = 0;            /* delete all items (clear size) */
+      x->items[x->size] = WTA_END; /* store a sentinel at the end */
+      if (x->size > job->max) job->max = x->size;
+      job->extent += (size_t)x->size;
+      job->chgcnt += job->chg[n] = (char)(x->size != k);
+    } }                         /* note whether items were removed */
+  else {                        /* if the items do not carry weights */
+    for (n = 0; n < job->cnt; n++) {
+      t = (TRACT*)job->tracts[n];  /* traverse the transactions */
+      k = t->size;              /* note the old transaction size */
+      if (job->marks) {         /* if item markers are given */
+        for (s = d = t->items; *s > TA_END; s++)
+          if (job->marks[*s]) *d++ = *s; /* remove unmarked items */
+        t->size = (ITEM)(d -t->items);
+      }                         /* store the new number of items */
+      if (t->size < job->min)   /* if the transaction is too short, */
+        t->size = 0;            /* delete all items (clear size) */
+      t->items[t->size] = TA_END;  /* store a sentinel at the end */
+      if (t->size > job->max) job->max = t->size;
+      job->extent += (size_t)t->size;
+      job->chgcnt += job->chg[n] = (char)(t->size != k);
+    }                           /* note whether items were removed */
+  }                             /* (only removal is possible, so an */
+  return NULL;                  /* unchanged size means that the */
+}  /* ifilter() */               /* transaction is unchanged) */
+
+/*--------------------------------------------------------------------*/
+#ifdef TA_THREADS
+
+static void pfilter (TBGFILT *job)
+{                               /* --- filter transactions (threads) */
+  TID       i, k, n;            /* loop variable, chunk size */
+  TBGFILT   jobs[TA_THREADS];   /* transaction filter jobs */
+  pthread_t thds[TA_THREADS];   /* worker threads */
+  int       c;                  /* loop variable for threads */
+
+  assert(job);                  /* check the function argument */
+  n = job->cnt;                 /* get the number of transactions */
+  k = (n +TA_THREADS-1) /TA_THREADS;   /* compute the chunk size */
+  for (c = 0, i = 0; c < TA_THREADS; c++, i += k) {
+    jobs[c] = *job;             /* copy the filter parameters */
+    jobs[c].tracts = job->tracts +i;
+    jobs[c].chg    = job->chg    +i;
+    jobs[c].cnt    = (i >= n) ? 0 : (n-i < k) ? n-i : k;
+  }                             /* split the transaction array */
+  for (c = 1; c < TA_THREADS; c++)
+    if (pthread_create(thds+c, NULL, ifilter, jobs+c) != 0) break;
+  ifilter(jobs);                /* process the first chunk directly */
+  for (i = (TID)c; i < TA_THREADS; i++)
+    ifilter(jobs+i);            /* process chunks without a thread */
+  while (--c > 0)               /* wait for the worker threads */
+    pthread_join(thds[c], NULL);
+  job->max = 0; job->extent = 0;/* combine the size statistics */
+  job->chgcnt = 0;              /* and the change counters */
+  for (c = 0; c < TA_THREADS; c++) {
+    if (jobs[c].max > job->max) job->max = jobs[c].max;
+    job->extent += jobs[c].extent;
+    job->chgcnt += jobs[c].chgcnt;
+  }                             /* (maximal size and item instances) */
+}  /* pfilter() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+TID tbg_ifilter (TABAG *bag, ITEM min, const int *marks, double wgt,
+                 int heap)
+{                               /* --- filter trans. incrementally */
+  /* This function presupposes that the transaction bag has been   */
+  /* sorted and reduced (e.g. with tbg_sort() and tbg_reduce()).   */
+  /* It is equivalent to tbg_filter(), tbg_sort() and tbg_reduce(), */
+  /* but only the transactions that were changed are sorted.       */
+  TID     i, k, m, n, d, e;     /* loop variables, counters */
+  ITEM    x;                    /* number of items */
+  int     c;                    /* comparison result */
+  int     z = 0;                /* flag for zero transaction weight */
+  TRACT   **t, **buf;           /* unchanged and changed trans. */
+  TID     *cnts;                /* counter array for bin sort */
+  CMPFN   *cmp;                 /* comparison function */
+  TBGFILT job;                  /* transaction filter job */
+
+  assert(bag);                  /* check the function arguments */
+  n = bag->cnt;                 /* get the number of transactions */
+  x = ib_cnt(bag->base);        /* and the number of items */
+  if (x < 2) x = 2;             /* need at least 2 counters */
+  buf = (TRACT**)malloc((size_t)(n+n) *sizeof(TRACT*)
+                       +(size_t)(x+1) *sizeof(TID)
+                       +(size_t) n    *sizeof(char));
+  if (!buf) {                   /* allocate buffers, on failure */
+    tbg_filter(bag, min, marks, wgt);   /* filter, sort and reduce */
+    tbg_sort  (bag, 0, heap);   /* the whole transaction bag */
+    return tbg_reduce(bag, 0);  /* (failsafe version) */
+  }
+  tbg_noidx(bag);               /* delete the vertical index */
+  if (bag->icnts) {             /* delete the item-specific counters */
+    free(bag->icnts); bag->icnts = NULL; bag->ifrqs = NULL; }
+  cnts = (TID*)(buf+n+n)+1;     /* organize the buffer memory */
+  job.tracts = bag->tracts;     /* set up a transaction filter job */
+  job.cnt    = n;   job.chg  = (char*)(cnts +x);
+  job.marks  = marks; job.min = min;
+  job.wgt    = wgt; job.mode = bag->mode;
+  #ifdef TA_THREADS             /* if to use multiple threads, */
+  if (n >= TH_THREADS)          /* filter the transactions in parallel */
+    pfilter(&job);
+  else                          /* if there are only few trans., */
+  #endif                        /* filter the transactions plainly */
+  ifilter(&job);                /* remove unmarked items */
+  bag->max    = job.max;        /* note the maximal size and */
+  bag->extent = job.extent;     /* the number of item instances */
+  if (job.chgcnt > (n >> 2)) {  /* if many trans. were changed, */
+    free(buf);                  /* sort the whole transaction bag */
+    tbg_sort(bag, 0, heap);     /* and reduce it (as tat_filter() */
+    return tbg_reduce(bag, 0);  /* and apriori() did before) */
+  }
+  cmp = (bag->mode & IB_WEIGHTS) ? wta_cmp : ta_cmp;
+  t   = (TRACT**)bag->tracts;   /* get the comparison function */
+  for (i = k = m = 0; i < n; i++) {
+    if (job.chg[i]) buf[m++] = t[i];
+    else            t[k++]   = t[i];
+  }                             /* keep unchanged trans. in place */
+                                /* and collect the changed ones */
+  if (m > 1) {                  /* if several trans. were changed, */
+    if (bag->mode & IB_WEIGHTS){/* sort them like tbg_sort() does */
+      if (heap & TA_HEAP) ptr_heapsort(buf, (size_t)m, +1, cmp, NULL);
+      else                ptr_qsort   (buf, (size_t)m, +1, cmp, NULL); }
+    else if ((size_t)x < (size_t)m) {
+      #ifdef TA_THREADS         /* if to use multiple threads, */
+      if (psort(buf, m, buf+n, cnts, x, -1) != 0)
+      #endif                    /* sort top-level sections in parallel */
+      sort(buf, m, 0, buf+n, cnts, x, -1); }
+    else ptr_mrgsort(buf, (size_t)m, +1, cmp, NULL, buf+n);
+    for (d = 0, i = 1; i < m; i++) {
+      if ((buf[d]->size != buf[i]->size)
+      ||  (cmp(buf[d], buf[i], NULL) != 0)) {
+        z |= (buf[d]->wgt == 0); buf[++d] = buf[i]; continue; }
+      buf[d]->wgt += buf[i]->wgt;   /* combine equal transactions */
+      bag->extent -= (size_t)buf[i]->size; free(buf[i]);
+    }                           /* (sum weights, delete duplicate) */
+    z |= (buf[d]->wgt == 0);    /* note whether a zero weight */
+    m = d+1;                    /* resulted from a combination */
+  }
+  e = k+m;                      /* get the total number of trans. */
+  for (i = k-1, d = e-1; m > 0; ) {
+    c = (i < 0) ? -1 : cmp(t[i], buf[m-1], NULL);
+    if      (c > 0) t[d--] = t[i--];
+    else if (c < 0) t[d--] = buf[--m];
+    else { t[i]->wgt += buf[--m]->wgt; z |= (t[i]->wgt == 0);
+           bag->extent -= (size_t)buf[m]->size; free(buf[m]); }
+  }                             /* merge the changed transactions */
+  free(buf);                    /* into the unchanged ones */
+  if (d > i) {                  /* if transactions were combined, */
+    memmove(t+i+1, t+d+1, (size_t)(e-1-d) *sizeof(TRACT*));
+    e -= d-i;                   /* close the gap between the merged */
+  }                             /* and the unprocessed transactions */
+  bag->cnt = e;                 /* set the new number of trans. */
+  if (!z) return e;             /* if there are no zero weights, abort */
+  bag->extent = 0;              /* reinit. number of item occurrences */
+  bag->max    = 0;              /* and the maximal transaction size */
+  for (i = d = 0; i < e; i++) { /* traverse the merged transactions */
+    if (t[i]->wgt == 0) { free(t[i]); continue; }
+    if (t[i]->size > bag->max) bag->max = t[i]->size;
+    bag->extent += (size_t)t[i]->size;
+    t[d++] = t[i];              /* remove transactions with zero */
+  }                             /* weight, update the maximal size */
+  return bag->cnt = d;          /* and the number of item instances */
+}  /* tbg_ifilter() */          /* return new number of transactions */
+
+/* Filtering only removes items, so the transactions that are left */
+/* unchanged keep their (lexicographic) order and are still unique. */
+/* Hence only the changed transactions need to be sorted and reduced*/
+/* and can then be merged into the unchanged ones, combining equal  */
+/* transactions. If few transactions are changed, this is much      */
+/* faster than sorting the whole transaction bag again. However,   */
+/* merging is slower than sorting once more than about a quarter of */
+/* the transactions changed (measured: 41% changed took 16% longer),*/
+/* so in this case all transactions are sorted. With threads        */
+/* (TA_THREADS) the items are removed in parallel chunks.           */
+
+/*--------------------------------------------------------------------*/
+
 void tbg_pack (TABAG *bag, int n)
 {                               /* --- pack all transactions */
   TID i;                        /* loop variable */
@@ -2195,10 +2738,33 @@ void tbg_unpack (TABAG *bag, int dir)
 SUPP tbg_occur (TABAG *bag, const ITEM *items, ITEM n)
 {                               /* --- count transaction occurrences */
   TID  l, r, m, k;              /* index and loop variables */
+  ITEM i, j, d, p, b;           /* loop variables, packed items */
+  ITEM *pki;                    /* buffer for packed items */
+  ITEM buf[32];                 /* (in most cases a fixed buffer) */
   SUPP s;                       /* number of occurrences (support) */
 
   assert(bag && items           /* check the function arguments */
   &&   !(bag->mode & IB_WEIGHTS));
+  p = (ITEM)tbg_packcnt(bag);   /* get the number of packed items */
+  for (i = 0; (p > 0) && (i < n); i++)
+    if ((items[i] >= 0) && (items[i] < p))
+      break;                    /* find first item with code < p */
+  if ((p > 0) && (i < n)) {     /* if there are items to pack */
+    pki = (n <= (ITEM)(sizeof(buf)/sizeof(*buf))) ? buf
+        : (ITEM*)malloc((size_t)n *sizeof(ITEM));
+    if (!pki) return (SUPP)-1;  /* get a buffer for the packed items */
+    memcpy(pki, items, (size_t)i *sizeof(ITEM));  /* copy leading */
+    for (b = 0, d = j = i; i < n; i++) {
+      if      (items[i] < 0) b |= items[i];
+      else if (items[i] < p) b |= (ITEM)1 << items[i];
+      else pki[++j] = items[i]; /* set bits for items with codes < p */
+    }                           /* and copy the other items */
+    pki[d] = b | TA_END;        /* store the packed items and fill */
+    while (++j < n) pki[j] = TA_END;  /* the rest with end markers */
+    s = tbg_occur(bag, pki, n); /* count the packed query */
+    if (pki != buf) free(pki);  /* (exactly as ta_pack(), so that */
+    return s;                   /* the packed items need only one */
+  }                             /* comparison in ta_cmpx()) */
   k = bag->cnt;                 /* get the number of transactions */
   for (r = m = 0; r < k; ) {    /* find right boundary */
     m = (r+k) >> 1;             /* by a binary search */
@@ -2215,6 +2781,397 @@ SUPP tbg_occur (TABAG *bag, const ITEM *items, ITEM n)
   return s;                     /* return the number of occurrences */
 }  /* tbg_occur() */
 
+/* Queries may be given with unpacked items even if the transaction  */
+/* bag has been packed with tbg_pack(). The items with codes below   */
+/* the number of packed items are then combined into one bit mask at */
+/* the position of the first of them (as in ta_pack()), so that they */
+/* are compared with a single comparison in ta_cmpx().               */
+
+/*--------------------------------------------------------------------*/
+
+int tbg_index (TABAG *bag)
+{                               /* --- build a vertical index */
+  ITEM        i, n;             /* loop variable, number of items */
+  TID         k;                /* loop variable for transactions */
+  size_t      z;                /* total size of the id lists */
+  const TID   *c;               /* number of transactions per item */
+  TID         *p;               /* to organize the id lists */
+  const ITEM  *s;               /* to traverse the items */
+  const WITEM *x;               /* to traverse the weighted items */
+
+  assert(bag && !tbg_packcnt(bag)); /* check the function argument */
+  if (bag->tidx) return 1;      /* if the index exists, abort */
+  n = ib_cnt(bag->base);        /* get the number of items */
+  c = tbg_icnts(bag, 1);        /* count the transactions per item */
+  if (!c) return -1;            /* (sizes of the id lists) */
+  bag->tidx = (TID**)malloc((size_t)(n+1) *sizeof(TID*));
+  if (!bag->tidx) return -1;    /* allocate the list pointers */
+  for (z = (size_t)bag->cnt+1, i = 0; i < n; i++)
+    z += (size_t)c[i]+1;        /* compute the total list size */
+  p = (TID*)malloc(z *sizeof(TID));
+  if (!p) { free(bag->tidx); bag->tidx = NULL; return -1; }
+  bag->tidx[n] = p;             /* the last list is the cover */
+  bag->xcnt    = n;             /* of the empty item set, */
+  for (*p++ = bag->cnt, k = 0; k < bag->cnt; k++)
+    *p++ = k;                   /* which contains all transactions */
+  for (i = 0; i < n; i++) {     /* traverse the items */
+    bag->tidx[i] = p; *p = 0; p += c[i]+1;
+  }                             /* organize the id lists */
+  for (k = 0; k < bag->cnt; k++) {
+    if (bag->mode & IB_WEIGHTS){/* traverse the transactions */
+      for (x = ((WTRACT*)bag->tracts[k])->items; x->item >= 0; x++) {
+        p = bag->tidx[x->item]; p[++p[0]] = k; } }
+    else {                      /* collect the transaction ids */
+      for (s = ((TRACT*) bag->tracts[k])->items; *s > TA_END;  s++) {
+        p = bag->tidx[*s];      p[++p[0]] = k; }
+    }                           /* (store the size in element 0) */
+  }
+  return 0;                     /* return 'ok' */
+}  /* tbg_index() */
+
+/* The vertical index stores for each item the (ascending) list of */
+/* the identifiers (that is, the positions in the bag) of the      */
+/* transactions that contain it, with the list size in element 0.  */
+/* It is deleted by all functions that change the positions or the */
+/* items of the transactions and then rebuilt on the next query.   */
+/* After it has been built, queries do not modify the bag and thus */
+/* may be executed concurrently (e.g. in several threads).        */
+
+/*--------------------------------------------------------------------*/
+
+void tbg_noidx (TABAG *bag)
+{                               /* --- delete the vertical index */
+  assert(bag);                  /* check the function argument */
+  if (!bag->tidx) return;       /* check for a vertical index */
+  free(bag->tidx[bag->xcnt]);   /* delete the id lists */
+  free(bag->tidx);              /* and the list pointers */
+  bag->tidx = NULL; bag->xcnt = 0;
+}  /* tbg_noidx() */
+
+/*--------------------------------------------------------------------*/
+
+static TID isect (TID *dst, const TID *a, TID n, const TID *b, TID m)
+{                               /* --- intersect two id lists */
+  TID i, k, l, r;               /* loop variables, search bounds */
+  TID *d = dst;                 /* to traverse the destination */
+
+  assert(dst && a && b && (n <= m));  /* check the arguments */
+  if (m > (n << 4)) {           /* if the second list is much longer */
+    for (i = k = 0; (i < n) && (k < m); i++) {
+      for (l = k, r = 1; (l+r < m) && (b[l+r] < a[i]); r += r)
+        l += r;                 /* gallop to a section that */
+      r = (l+r < m) ? l+r : m;  /* contains the next identifier */
+      while (l < r) {           /* find the first identifier */
+        k = (l+r) >> 1;         /* that is not less than the */
+        if (b[k] < a[i]) l = k+1;  /* next one in the first list */
+        else             r = k; /* by a binary search */
+      }
+      k = l;                    /* note the search position */
+      if ((k < m) && (b[k] == a[i])) { *d++ = a[i]; k++; }
+    } }                         /* copy identifiers in both lists */
+  else {                        /* if the lists have similar sizes */
+    for (i = k = 0; (i < n) && (k < m); ) {
+      if      (a[i] < b[k]) i++;/* if one of the identifiers */
+      else if (a[i] > b[k]) k++;/* is only in one of the lists, */
+      else { *d++ = a[i++]; k++; }  /* skip it, otherwise */
+    }                           /* copy identifiers */
+  }                             /* that are in both lists */
+  return (TID)(d -dst);         /* return the size of the result */
+}  /* isect() */
+
+/* The destination may be the first list, since no identifier is */
+/* written before it has been read. For (very) different sizes   */
+/* galloping (exponential and then binary) search is used.       */
+
+/*--------------------------------------------------------------------*/
+
+static ITEM getls (TABAG *bag, const ITEM *items, ITEM n, TID **lists)
+{                               /* --- get id lists sorted by size */
+  ITEM i, k;                    /* loop variables */
+  TID  *l;                      /* id list of the current item */
+
+  assert(bag && bag->tidx && lists);   /* check the arguments */
+  if (n <= 0) {                 /* if the item set is empty, */
+    lists[0] = bag->tidx[bag->xcnt]; return 1; }  /* use all ids */
+  for (i = 0; i < n; i++) {     /* traverse the items */
+    if ((items[i] < 0) || (items[i] >= bag->xcnt))
+      return 0;                 /* unknown items have no cover */
+    l = bag->tidx[items[i]];    /* get the id list of the item and */
+    for (k = i; (k > 0) && (lists[k-1][0] > l[0]); k--)
+      lists[k] = lists[k-1];    /* insert it into the sorted lists */
+    lists[k] = l;               /* (insertion sort, since there are */
+  }                             /* usually only few items) */
+  return n;                     /* return the number of lists */
+}  /* getls() */
+
+/*--------------------------------------------------------------------*/
+
+static TID cover (TID **lists, ITEM n, TID *tids)
+{                               /* --- intersect sorted id lists */
+  ITEM i;                       /* loop variable */
+  TID  m;                       /* size of the cover */
+
+  assert(lists && (n > 0) && tids);    /* check the arguments */
+  if (n <= 1) {                 /* if there is only one list, */
+    m = lists[0][0];            /* copy its identifiers */
+    memcpy(tids, lists[0]+1, (size_t)m *sizeof(TID)); return m; }
+  m = isect(tids, lists[0]+1, lists[0][0], lists[1]+1, lists[1][0]);
+  for (i = 2; (i < n) && (m > 0); i++)
+    m = isect(tids, tids, m, lists[i]+1, lists[i][0]);
+  return m;                     /* intersect the smallest lists first */
+}  /* cover() */                /* and return the size of the cover */
+
+/*--------------------------------------------------------------------*/
+
+static SUPP wsum (TABAG *bag, const TID *tids, TID n)
+{                               /* --- sum transaction weights */
+  SUPP s = 0;                   /* sum of the transaction weights */
+
+  assert(bag && (tids || (n <= 0)));   /* check the arguments */
+  if (bag->mode & IB_WEIGHTS)   /* if the items carry weights */
+    while (--n >= 0) s += ((WTRACT*)bag->tracts[*tids++])->wgt;
+  else                          /* if the items do not carry weights */
+    while (--n >= 0) s += ((TRACT*) bag->tracts[*tids++])->wgt;
+  return s;                     /* return the sum of the weights */
+}  /* wsum() */
+
+/*--------------------------------------------------------------------*/
+
+TID tbg_cover (TABAG *bag, const ITEM *items, ITEM n, TID *tids)
+{                               /* --- get the cover of an item set */
+  TID  m;                       /* size of the cover */
+  TID  *buf[32], **lists;       /* (sorted) id lists of the items */
+
+  assert(bag && (items || (n <= 0)) && tids);
+  if (!bag->tidx && (tbg_index(bag) < 0))
+    return -1;                  /* build the index if necessary */
+  lists = (n <= (ITEM)(sizeof(buf)/sizeof(*buf))) ? buf
+        : (TID**)malloc((size_t)n *sizeof(TID*));
+  if (!lists) return -1;        /* get a buffer for the id lists */
+  n = getls(bag, items, n, lists);
+  m = (n > 0) ? cover(lists, n, tids) : 0;
+  if (lists != buf) free(lists);/* intersect the id lists and */
+  return m;                     /* return the size of the cover */
+}  /* tbg_cover() */
+
+/* The array tids must provide room for tbg_cnt(bag) identifiers.   */
+/* The cover is stored in it as an ascending list of the positions */
+/* (in the bag) of the transactions that contain all given items.  */
+
+/*--------------------------------------------------------------------*/
+
+SUPP tbg_suppx (TABAG *bag, const ITEM *items, ITEM n)
+{                               /* --- get the support of an item set */
+  TID  m;                       /* size of the cover */
+  TID  *tids;                   /* buffer for the cover */
+  TID  *buf[32], **lists;       /* (sorted) id lists of the items */
+  SUPP s;                       /* support of the item set */
+
+  assert(bag && (items || (n <= 0)));  /* check the arguments */
+  if (!bag->tidx && (tbg_index(bag) < 0))
+    return (SUPP)-1;            /* build the index if necessary */
+  lists = (n <= (ITEM)(sizeof(buf)/sizeof(*buf))) ? buf
+        : (TID**)malloc((size_t)n *sizeof(TID*));
+  if (!lists) return (SUPP)-1;  /* get a buffer for the id lists */
+  n = getls(bag, items, n, lists);
+  if      ((n <= 0) || (lists[0][0] <= 0))
+    s = 0;                      /* check for an empty cover */
+  else if (n <= 1) s = wsum(bag, lists[0]+1, lists[0][0]);
+  else {                        /* if there are several lists */
+    tids = (TID*)malloc((size_t)lists[0][0] *sizeof(TID));
+    if (!tids) s = (SUPP)-1;    /* get a buffer for the cover */
+    else { m = cover(lists, n, tids); s = wsum(bag, tids, m);
+           free(tids); }        /* intersect the id lists */
+  }                             /* and sum the transaction weights */
+  if (lists != buf) free(lists);
+  return s;                     /* return the item set support */
+}  /* tbg_suppx() */
+
+/*--------------------------------------------------------------------*/
+
+int tbg_suppxs (TABAG *bag, const ITEM *items, const size_t *offs,
+                size_t cnt, SUPP *supps)
+{                               /* --- get supports of item sets */
+  size_t i;                     /* loop variable for item sets */
+  ITEM   n, k;                  /* (maximum) number of items */
+  TID    m;                     /* size of a cover */
+  TID    *tids;                 /* buffer for the covers */
+  TID    **lists;               /* (sorted) id lists of the items */
+
+  assert(bag && items && offs && supps);  /* check the arguments */
+  if (!bag->tidx && (tbg_index(bag) < 0))
+    return -1;                  /* build the index if necessary */
+  for (k = 1, i = 0; i < cnt; i++) {
+    n = (ITEM)(offs[i+1] -offs[i]);
+    if (n > k) k = n;           /* find the maximum item set size */
+  }                             /* (number of id lists to sort) */
+  lists = (TID**)malloc((size_t)k *sizeof(TID*)
+                       +(size_t)bag->cnt *sizeof(TID));
+  if (!lists) return -1;        /* allocate the buffers once */
+  tids = (TID*)(lists +k);      /* for all item sets */
+  for (i = 0; i < cnt; i++) {   /* traverse the item sets */
+    n = getls(bag, items +offs[i], (ITEM)(offs[i+1] -offs[i]), lists);
+    if      (n <= 0) supps[i] = 0;
+    else if (n <= 1) supps[i] = wsum(bag, lists[0]+1, lists[0][0]);
+    else { m = cover(lists, n, tids); supps[i] = wsum(bag, tids, m); }
+  }                             /* compute the supports */
+  free(lists);                  /* delete the buffers */
+  return 0;                     /* return 'ok' */
+}  /* tbg_suppxs() */
+
+/* The item sets are stored consecutively in the array items, with */
+/* item set i occupying the elements offs[i] to offs[i+1]-1, so the */
+/* array offs must have cnt+1 elements (as in the library interface */
+/* of the apriori program). The supports are stored in supps.       */
+
+/*--------------------------------------------------------------------*/
+
+static void ipwone (TBGIPW *ipw, TID n, double *wgts)
+{                               /* --- idempotent weight of one trans. */
+  ITEM   i, k;                  /* loop variable, rarest item */
+  ITEM   r;                     /* result of subset test */
+  double w, sum;                /* (sum of) transaction weights */
+  void   **o;                   /* to traverse the occurrences */
+  TRACT  *s, *d;                /* to traverse the transactions */
+  const ITEM *p;                /* to traverse the items */
+  WTRACT *a, *b;                /* to traverse the transactions */
+  WITEM  *z;                    /* to traverse the items */
+  TABAG  *bag = ipw->bag;       /* transaction bag to process */
+  const TID *c = ipw->cnts;     /* number of occurrences per item */
+
+  if (bag->mode & IB_WEIGHTS) { /* if the items carry weights */
+    a = tbg_wtract(bag, n);     /* get the transaction */
+    if ((k = a->items[0].item) < 0) {
+      a->wgt -= bag->wgt -a->wgt;
+      return;                   /* if the transaction is empty, */
+    }                           /* it can be handled directly */
+    for (z = a->items+1; z->item >= 0; z++)
+      if (c[z->item] < c[k])    /* find the rarest item */
+        k = z->item;            /* (fewest occurrences) */
+    sum = 0;                    /* init. the item weight array */
+    if (wgts) memset(wgts, 0, (size_t)a->size *sizeof(double));
+    for (o = ipw->occs[k]; (b = (WTRACT*)*o) != a; o++) {
+      if (b->size <= a->size)   /* traverse larger transactions */
+        continue;               /* containing the rarest item */
+      for (r = -1; (r = ipw->subw(a, b, r+1)) >= 0; ) {
+        a->wgt -= b->wgt;       /* update the transaction weight */
+        if (!wgts) {            /* skip item weights if not needed */
+          if (!(ipw->mode & TA_ALLOCC))
+            break;              /* stop after first occurrence */
+          continue;             /* unless all occurrences requested */
+        }
+        sum += w = (b->wgt != 0) ? (double)b->wgt : 1.0;
+        for (z = b->items +r, i = 0; i < a->size; i++)
+          wgts[i] += w *(double)z[i].wgt;
+      }                         /* sum the item weight contributions */
+    }                           /* from supersets or supersequences */
+    if (!wgts) return;          /* skip item weights if not needed */
+    sum += w = (a->wgt != 0) ? (double)a->wgt : 1.0;
+    for (z = a->items, i = 0; i < a->size; i++)
+      z[i].wgt = (float)((sum *(double)z[i].wgt -wgts[i]) /w); }
+  else {                        /* if the items do not carry weights */
+    s = tbg_tract(bag, n);      /* get the transaction */
+    if ((k = s->items[0]) <= TA_END) {
+      s->wgt -= bag->wgt -s->wgt;
+      return;                   /* if the transaction is empty, */
+    }                           /* it can be handled directly */
+    for (p = s->items+1; *p > TA_END; p++)
+      if (c[*p] < c[k]) k = *p; /* find the rarest item */
+    for (o = ipw->occs[k]; (d = (TRACT*)*o) != s; o++) {
+      if (d->size <= s->size) continue;
+      for (r = -1; (r = ipw->sub(s, d, r+1)) >= 0; ) {
+        s->wgt -= d->wgt;       /* traverse transaction pairs and */
+        if (!(ipw->mode & TA_ALLOCC)) break;
+      }                         /* subtract transaction weights */
+    }                           /* of supersets or supersequences */
+  }                             /* stop after first occurrence */
+}  /* ipwone() */                /* unless all occurrences requested */
+
+/* Every superset or supersequence of a transaction must contain all */
+/* of its items, so it suffices to traverse the occurrence array of  */
+/* the item of the transaction that occurs in the fewest transactions */
+/* (rather than the array of the first item, which is usually one of  */
+/* the most frequent items if the items are coded by frequency).      */
+/* Only the weight of the given transaction is changed, and only the  */
+/* (final) weights of strictly larger transactions are read.          */
+
+/*--------------------------------------------------------------------*/
+#ifdef TA_THREADS
+
+static TID sizecls (TABAG *bag, TID n)
+{                               /* --- find start of a size class */
+  ITEM z;                       /* size of the transactions */
+
+  assert(bag && (n > 0));       /* check the function arguments */
+  if (bag->mode & IB_WEIGHTS) { /* if the items carry weights */
+    z = tbg_wtract(bag, --n)->size;
+    while ((n > 0) && (tbg_wtract(bag, n-1)->size == z)) n--; }
+  else {                        /* if the items do not carry weights */
+    z = tbg_tract (bag, --n)->size;
+    while ((n > 0) && (tbg_tract (bag, n-1)->size == z)) n--;
+  }                             /* skip transactions of same size */
+  return n;                     /* return the start of the class */
+}  /* sizecls() */
+
+/*--------------------------------------------------------------------*/
+
+static void ipwjobs (TBGIPW *ipw, double *wgts)
+{                               /* --- process weight jobs */
+  TID n, m;                     /* range of transactions */
+
+  while (1) {                   /* while there are jobs left */
+    pthread_mutex_lock(&ipw->lock);
+    n = ipw->next;              /* get the next chunk of trans. */
+    m = (n -ipw->min > IPWCHUNK) ? n -IPWCHUNK : ipw->min;
+    ipw->next = m;              /* (from the end of the class) */
+    pthread_mutex_unlock(&ipw->lock);
+    if (n <= m) return;         /* check for an empty chunk */
+    while (--n >= m) ipwone(ipw, n, wgts);
+  }                             /* process the transactions */
+}  /* ipwjobs() */
+
+/*--------------------------------------------------------------------*/
+
+static void* ipwgter (void *data)
+{                               /* --- compute weights (thread) */
+  TBGIPW *ipw = (TBGIPW*)data;  /* idempotent weight computation */
+  double *wgts = NULL;          /* buffer for item weight adaptation */
+
+  if ((ipw->bag->mode & ipw->mode & IB_WEIGHTS)
+  &&  (ipw->mode & TA_NOGAPS) && (ipw->mode & TA_ALLOCC)
+  && !(wgts = (double*)malloc((size_t)ipw->bag->max *sizeof(double))))
+    return NULL;                /* allocate a weight array */
+  ipwjobs(ipw, wgts);           /* process weight jobs */
+  if (wgts) free(wgts);         /* delete the weight array */
+  return NULL;                  /* return a dummy result */
+}  /* ipwgter() */
+
+/*--------------------------------------------------------------------*/
+
+static void pipwgt (TBGIPW *ipw, TID min, TID n, double *wgts)
+{                               /* --- compute weights (threads) */
+  pthread_t thds[TA_THREADS];   /* worker threads */
+  int       c;                  /* number of started threads */
+
+  assert(ipw && (min < n));     /* check the function arguments */
+  ipw->min = min; ipw->next = n;/* note the transaction range */
+  pthread_mutex_init(&ipw->lock, NULL);
+  for (c = 0; c < TA_THREADS-1; c++)
+    if (pthread_create(thds+c, NULL, ipwgter, ipw) != 0) break;
+  ipwjobs(ipw, wgts);           /* start the worker threads and */
+  while (--c >= 0)              /* also work in the calling thread */
+    pthread_join(thds[c], NULL);
+  pthread_mutex_destroy(&ipw->lock);
+}  /* pipwgt() */
+
+/* The transactions are sorted ascendingly by size, so transactions */
+/* of the same size only read the weights of larger transactions,   */
+/* which have all been finalized before. Hence the transactions of  */
+/* one size class can be processed in parallel without any locking  */
+/* of the weights; only the chunk counter is protected by a mutex.  */
+
+#endif
+
 /*--------------------------------------------------------------------*/
 
 int tbg_ipwgt (TABAG *bag, int mode)
@@ -2235,6 +3192,7 @@ int tbg_ipwgt (TABAG *bag, int mode)
   WITEM  *z;                    /* to traverse the items */
   SUBWFN *subw;                 /* subset/subsequence function */
   double *wgts;                 /* buffer for item weight adaptation */
+  TBGIPW ipw;                   /* idempotent weight computation */
 
   assert(bag);                  /* check the function argument */
   wgts = NULL;                  /* if to adapt item weights */
@@ -2260,32 +3218,7 @@ int tbg_ipwgt (TABAG *bag, int mode)
             *--occs[z->item] = a;
         }                       /* collect containing transactions */
       }                         /* per item, but avoid duplicates */
-      subw = (mode & TA_NOGAPS) ? wta_subwog : wta_subset;
-      for (n = bag->cnt; --n >= 0; ) {
-        a = tbg_wtract(bag, n); /* traverse the transactions */
-        if ((k = a->items[0].item) < 0) {
-          a->wgt -= bag->wgt -a->wgt;
-          continue;             /* if the transaction is empty, */
-        }                       /* it can be handled directly */
-        if (wgts) memset(wgts, 0, (size_t)a->size *sizeof(double));
-        sum = 0;                /* init. the item weight array */
-        for (o = occs[k]; (b = (WTRACT*)*o) != a; o++) {
-          if (b->size <= a->size)
-            continue;           /* traverse larger transactions */
-          for (r = -1; (r = subw(a, b, r+1)) >= 0; ) {
-            a->wgt -= b->wgt;   /* update the transaction weight */
-            if (!wgts) {        /* skip item weights if not needed */
-              if (!(mode & TA_ALLOCC)) break; continue; }
-            sum += w = (b->wgt != 0) ? (double)b->wgt : 1.0;
-            for (z = b->items +r, i = 0; i < a->size; i++)
-              wgts[i] += w *(double)z[i].wgt;
-          }                     /* sum the item weight contributions */
-        }                       /* from supersets or supersequences */
-        if (!wgts) continue;    /* skip item weights if not needed */
-        sum += w = (a->wgt != 0) ? (double)a->wgt : 1.0;
-        for (z = a->items, i = 0; i < a->size; i++)
-          z[i].wgt = (float)((sum *(double)z[i].wgt -wgts[i]) /w);
-      } }                       /* rescale the item weights */
+    }
     else {                      /* if the items do not carry weights */
       for (n = 0; n < bag->cnt; n++) {
         s = tbg_tract(bag, n);  /* traverse the transactions */
@@ -2293,22 +3226,22 @@ int tbg_ipwgt (TABAG *bag, int mode)
           if ((TRACT*)*occs[*p] != s)
             *--occs[*p] = s;    /* collect containing transactions */
       }                         /* per item, but avoid duplicates */
-      sub = (mode & TA_NOGAPS) ? ta_subwog : ta_subset;
-      for (n = bag->cnt; --n >= 0; ) {
-        s = tbg_tract(bag, n);  /* traverse the transactions */
-        if ((k = s->items[0]) <= TA_END) {
-          s->wgt -= bag->wgt -s->wgt;
-          continue;             /* if the transaction is empty, */
-        }                       /* it can be handled directly */
-        for (o = occs[k]; (d = (TRACT*)*o) != s; o++) {
-          if (d->size <= s->size) continue;
-          for (r = -1; (r = sub(s, d, r+1)) >= 0; ) {
-            s->wgt -= d->wgt;   /* traverse transaction pairs and */
-            if (!(mode & TA_ALLOCC)) break;
-          }                     /* subtract transaction weights */
-        }                       /* of supersets or supersequences */
-      }                         /* stop after first occurrence */
-    }                           /* unless all occurrences requested */
+    }
+    ipw.bag  = bag;  ipw.occs = occs;  /* note the data for */
+    ipw.cnts = c;    ipw.mode = mode;  /* the weight computation */
+    ipw.sub  = (mode & TA_NOGAPS) ? ta_subwog  : ta_subset;
+    ipw.subw = (mode & TA_NOGAPS) ? wta_subwog : wta_subset;
+    #ifdef TA_THREADS           /* if to use multiple threads */
+    for (n = bag->cnt; n > 0; n = m) {
+      m = sizecls(bag, n);      /* traverse the size classes */
+      if (n -m >= TH_IPWGT) {   /* process large classes in parallel */
+        pipwgt(&ipw, m, n, wgts); continue; }
+      while (--n >= m) ipwone(&ipw, n, wgts);
+    }                           /* process small classes plainly */
+    #else                       /* if to use only one thread */
+    for (n = bag->cnt; --n >= 0; )
+      ipwone(&ipw, n, wgts);    /* traverse the transactions */
+    #endif                      /* from largest to smallest */
     free(occs); }               /* deallocate working memory */
   else {                        /* failsafe, but slower variant */
     if (bag->mode & IB_WEIGHTS){/* if the items carry weights */
@@ -2361,6 +3294,142 @@ int tbg_ipwgt (TABAG *bag, int mode)
   return 0;                     /* return 'ok' */
 }  /* tbg_ipwgt() */
 
+/*--------------------------------------------------------------------*/
+
+static double rnd (unsigned long *seed)
+{                               /* --- random number in (0,1) */
+  unsigned long x = *seed & 0xffffffffUL;
+
+  if (x == 0) x = 0x9e3779b9UL; /* avoid the fixed point 0 */
+  x ^= (x << 13) & 0xffffffffUL;/* xorshift generator (Marsaglia), */
+  x ^=  x >> 17;                /* restricted to 32 bits, so that */
+  x ^= (x <<  5) & 0xffffffffUL;/* the sequence is the same on all */
+  *seed = x;                    /* platforms (unsigned long may be */
+  return (double)x /4294967296.0;  /* 32 or 64 bits wide) */
+}  /* rnd() */
+
+/*--------------------------------------------------------------------*/
+
+static int contains (const ITEM *items, size_t n, ITEM item)
+{                               /* --- check for an item (unsorted) */
+  while (n > 0) if (items[--n] == item) return 1;
+  return 0;                     /* traverse the items and */
+}  /* contains() */             /* compare them to the given one */
+
+/*--------------------------------------------------------------------*/
+
+static TID find (const size_t *offs, TID n, size_t pos)
+{                               /* --- find trans. of item instance */
+  TID l, r, m;                  /* binary search variables */
+
+  for (l = 0, r = n; r-l > 1; ) {
+    m = l +((r-l) >> 1);        /* find the last transaction */
+    if (offs[m] <= pos) l = m;  /* that starts at or before */
+    else                r = m;  /* the given position */
+  }                             /* (empty transactions start at the */
+  return l;                     /* same position as their successor) */
+}  /* find() */
+
+/*--------------------------------------------------------------------*/
+
+TABAG* tbg_surr (TABAG *bag, int method, unsigned long *seed)
+{                               /* --- generate surrogate data */
+  ITEM   i, m;                  /* loop variable, number of items */
+  TID    k, n, x, y;            /* loop variables, number of trans. */
+  size_t e, r, s, a, b;         /* number of item instances, indices */
+  size_t *offs;                 /* offsets of the (unit) transactions */
+  ITEM   *items, z;             /* item instances, exchange buffer */
+  TID    *cnts, *tids, *perm;   /* item counters, trans. ids, perm. */
+  TRACT  *t;                    /* to traverse the transactions */
+  TABAG  *dst;                  /* created surrogate data set */
+
+  assert(bag && seed            /* check the function arguments */
+  &&   !(bag->mode & IB_WEIGHTS) && !tbg_packcnt(bag));
+  for (n = 0, e = 0, k = 0; k < bag->cnt; k++) {
+    t  = (TRACT*)bag->tracts[k];/* traverse the transactions */
+    n += (TID)t->wgt;           /* and count the unit transactions */
+    e += (size_t)t->wgt *(size_t)t->size;
+  }                             /* and the item instances */
+  offs  = (size_t*)malloc((size_t)(n+1) *sizeof(size_t)
+                         +(e+1)         *sizeof(ITEM));
+  if (!offs) return NULL;       /* allocate the transaction arrays */
+  items = (ITEM*)(offs +n+1);   /* and organize the memory */
+  for (s = 0, x = 0, k = 0; k < bag->cnt; k++) {
+    t = (TRACT*)bag->tracts[k]; /* traverse the transactions */
+    for (y = (TID)t->wgt; --y >= 0; ) {
+      offs[x++] = s;            /* expand a weighted transaction */
+      memcpy(items+s, t->items, (size_t)t->size *sizeof(ITEM));
+      s += (size_t)t->size;     /* copy the items of the transaction */
+    }                           /* for each unit of its weight */
+  }
+  offs[n] = e;                  /* store the final offset */
+  if (method == TBG_SWAP) {     /* if swap randomization */
+    for (r = SWAPFAC *e; (r > 0) && (n > 1); r--) {
+      a = (size_t)(rnd(seed) *(double)e);
+      b = (size_t)(rnd(seed) *(double)e);
+      if (items[a] == items[b]) continue;
+      x = find(offs, n, a);     /* draw two item instances */
+      y = find(offs, n, b);     /* and find their transactions */
+      if ((x == y)              /* check whether the items can be */
+      ||  contains(items+offs[x], offs[x+1]-offs[x], items[b])
+      ||  contains(items+offs[y], offs[y+1]-offs[y], items[a]))
+        continue;               /* swapped between the transactions */
+      z = items[a]; items[a] = items[b]; items[b] = z;
+    } }                         /* swap the two item instances */
+  else {                        /* if item permutation */
+    m    = ib_cnt(bag->base);   /* get the number of items */
+    cnts = (TID*)calloc(e+(size_t)n+(size_t)m+1, sizeof(TID));
+    if (!cnts) { free(offs); return NULL; }
+    tids = cnts +m; perm = tids +e;  /* create the buffers */
+    for (s = 0; s < e; s++) cnts[items[s]]++;
+    for (x = 0; x < n; x++) perm[x] = x;
+    memset(offs, 0, (size_t)(n+1) *sizeof(size_t));
+    for (s = 0, i = 0; i < m; i++) {
+      for (x = 0; x < cnts[i]; x++) {
+        k = x +(TID)(rnd(seed) *(double)(n-x));
+        y = perm[k]; perm[k] = perm[x]; perm[x] = y;
+        tids[s++] = y;          /* draw a random subset of the trans. */
+        offs[y+1]++;            /* (partial Fisher-Yates shuffle) */
+      }                         /* and count the items per trans. */
+    }                           /* (keeps the item frequencies) */
+    for (x = 0; x < n; x++)     /* turn the counters into offsets */
+      offs[x+1] += offs[x];     /* (start of each transaction) */
+    for (s = 0, i = 0; i < m; i++)
+      for (x = 0; x < cnts[i]; x++)   /* store the items in the */
+        items[offs[tids[s++]]++] = i; /* drawn transactions */
+    for (x = n; x > 0; x--)     /* restore the transaction offsets */
+      offs[x] = offs[x-1];      /* (they were advanced to the start */
+    offs[0] = 0;                /* of the next transaction) */
+    free(cnts);                 /* delete the buffers */
+  }
+  dst = tbg_create(bag->base);  /* create a surrogate data set */
+  if (!dst) { free(offs); return NULL; }
+  for (x = 0; x < n; x++) {     /* traverse the unit transactions */
+    t = ta_create(items+offs[x], (ITEM)(offs[x+1]-offs[x]), 1);
+    if (!t || (tbg_add(dst, t) != 0)) {
+      if (t) free(t);           /* on failure delete the transaction, */
+      tbg_delete(dst, 0);       /* the surrogate data set and */
+      free(offs); return NULL;  /* the transaction arrays */
+    }                           /* and abort the function */
+  }                             /* add them to the surrogate */
+  free(offs);                   /* delete the transaction arrays */
+  return dst;                   /* return the surrogate data set */
+}  /* tbg_surr() */
+
+/* tbg_surr() creates a surrogate data set, which shares the item base */
+/* with the given transaction bag, in which each transaction of weight */
+/* w appears as w transactions of weight 1. With TBG_SWAP two item     */
+/* instances of different transactions are swapped if neither of the   */
+/* transactions contains the other item (swap randomization), which    */
+/* keeps the item frequencies and the transaction sizes. With TBG_PERM */
+/* each item is assigned to a random subset of the transactions of     */
+/* the same size as its cover (item permutation), which keeps only the */
+/* item frequencies. The items in the transactions of the surrogate    */
+/* are not sorted and the transactions are neither sorted nor reduced. */
+/* The random number generator state in 'seed' is updated, so that a   */
+/* sequence of calls yields different surrogates; since it is the only */
+/* state, the function may be called concurrently (different seeds).  */
+
 /*--------------------------------------------------------------------*/
 #ifndef NDEBUG
 
@@ -2663,15 +3732,34 @@ size_t tat_size (const TATREE *tree)
 
 /*--------------------------------------------------------------------*/
 
+static size_t bytecnt (const TANODE *node)
+{                               /* --- count the bytes of the nodes */
+  size_t z;                     /* number of bytes */
+  TANODE *child;                /* to traverse the child nodes */
+
+  assert(node && (node->max > 0)); /* check the function argument */
+  for (z = sizeof(ITEM), child = (TANODE*)node->data;
+       child->item >= 0; child++) {
+    z += sizeof(TANODE);        /* count the child node array */
+    if (child->max > 0) z += bytecnt(child);
+  }                             /* recursively count the subtrees */
+  return z;                     /* return number of bytes in tree */
+}  /* bytecnt() */
+
+/*--------------------------------------------------------------------*/
+
+size_t tat_bytes (const TATREE *tree)
+{ return (tree->root.max > 0) ? bytecnt(&tree->root) : 0; }
+
+/*--------------------------------------------------------------------*/
+
 int tat_filter (TATREE *tree, ITEM min, const int *marks, int heap)
 {                               /* --- filter a transaction tree */
   TABAG *bag;                   /* underlying transaction bag */
 
   assert(tree);                 /* check the function argument */
   delete(&tree->root);          /* delete the nodes of the tree */
-  tbg_filter(bag = tree->bag, min, marks, 0);
-  tbg_sort  (bag, 0, heap);     /* remove unnec. items and trans. */
-  tbg_reduce(bag, 0);           /* and reduce trans. to unique ones */
+  tbg_ifilter(bag = tree->bag, min, marks, 0, heap);
   if (create(&tree->root, (TRACT**)bag->tracts, bag->cnt, 0) == 0)
     return 0;                   /* recreate the transaction tree */
   delete(&tree->root);          /* on failure delete the nodes */
@@ -2729,22 +3817,7 @@ TANODE* tan_child (const TANODE *node, ITEM index)
 
 /*--------------------------------------------------------------------*/
 
-void delete (TANODE *root)
-{                               /* --- delete a transaction (sub)tree */
-  ITEM   i;                     /* loop variable */
-  TANODE **chn;                 /* array of child nodes */
-
-  assert(root);                 /* check the function argument */
-  chn = (TANODE**)(root->items +root->size);
-  ALIGN(chn);                   /* get the child pointer array */
-  for (i = 0; i < root->size; i++)
-    delete(chn[i]);             /* recursively delete the subtrees */
-  free(root);                   /* and the tree node itself */
-}  /* delete() */
-
-/*--------------------------------------------------------------------*/
-
-TANODE* create (TRACT **tracts, TID cnt, ITEM index)
+static TANODE* create (TRACT **tracts, TID cnt, ITEM index, char **mem)
 {                               /* --- recursive part of tat_create() */
   TID    i;                     /* loop variable */
   ITEM   item, k, n;            /* item identifier and counter */
@@ -2753,14 +3826,14 @@ TANODE* create (TRACT **tracts, TID cnt, ITEM index)
   TANODE *node;                 /* node of created transaction tree */
   TANODE **chn;                 /* array of child nodes */
 
-  assert(tracts                 /* check the function arguments */
+  assert(tracts && mem          /* check the function arguments */
   &&    (cnt > 0) && (index >= 0));
+  node = (TANODE*)*mem;         /* get the next node from the arena */
   if (cnt <= 1) {               /* if only one transaction left */
     n    = (*tracts)->size -index;
-    node = (TANODE*)malloc(sizeof(TANODE) +(size_t)(n-1) *sizeof(ITEM));
-    if (!node) return NULL;     /* create a transaction tree node */
-    node->wgt  = (*tracts)->wgt;/* and initialize the fields */
-    node->size = -(node->max = n);
+    *mem += TAT_ROUND(sizeof(TANODE) +(size_t)(n-1) *sizeof(ITEM));
+    node->wgt  = (*tracts)->wgt;/* create a transaction tree node */
+    node->size = -(node->max = n);    /* and initialize the fields */
     if (n > 0)                  /* copy the transaction suffix */
       memcpy(node->items, (*tracts)->items +index,
                           (size_t)n *sizeof(ITEM));
@@ -2775,10 +3848,9 @@ TANODE* create (TRACT **tracts, TID cnt, ITEM index)
     if (k != item) { item = k; n++; }
   }                             /* count the different items */
   z = sizeof(TANODE) +(size_t)(n-1) *sizeof(ITEM);
-  node = (TANODE*)malloc(z +PAD(z) +(size_t)n *sizeof(TANODE*));
-  if (!node) return NULL;       /* create a transaction tree node */
-  node->wgt  = w;               /* and initialize its fields */
-  node->max  = 0;
+  *mem += TAT_ROUND(z +PAD(z) +(size_t)n *sizeof(TANODE*));
+  node->wgt  = w;               /* create a transaction tree node */
+  node->max  = 0;               /* and initialize its fields */
   node->size = n;               /* if all transactions are captured, */
   if (n <= 0) return node;      /* return the created tree */
   chn = (TANODE**)(node->items +n);
@@ -2787,17 +3859,136 @@ TANODE* create (TRACT **tracts, TID cnt, ITEM index)
     node->items[n] = item = tracts[cnt]->items[index];
     for (i = cnt; --i >= 0; )   /* find trans. with the current item */
       if (tracts[i]->items[index] != item) break;
-    chn[n] = create(tracts+i+1, cnt-i, index+1);
-    if (!chn[n]) break;         /* recursively create a subtree */
+    chn[n] = create(tracts+i+1, cnt-i, index+1, mem);
     if ((k = chn[n]->max +1) > node->max) node->max = k;
-  }                             /* adapt the maximal remaining size */
-  if (n < 0) return node;       /* if successful, return created tree */
-
-  while (++n < node->size) delete(chn[n]);
-  free(node);                   /* on error delete created subtree */
-  return NULL;                  /* return 'failure' */
+  }                             /* recursively create the subtrees */
+  return node;                  /* and adapt the maximal remaining size */
 }  /* create() */
 
+/*--------------------------------------------------------------------*/
+#ifdef TA_THREADS
+
+static void* worker (void *data)
+{                               /* --- build subtrees (thread) */
+  TATWORK *work = (TATWORK*)data;  /* parallel construction data */
+  TATJOB  *job;                 /* current subtree construction job */
+
+  while (1) {                   /* while there are jobs left */
+    pthread_mutex_lock(&work->lock);
+    job = (work->next < work->cnt) ? work->jobs +work->next++ : NULL;
+    pthread_mutex_unlock(&work->lock);
+    if (!job) return NULL;      /* get the next job (if any) */
+    job->end   = job->beg;      /* build the subtree in its own */
+    *job->node = create(job->tracts, job->cnt, 1, &job->end);
+  }                             /* part of the memory arena */
+}  /* worker() */
+
+/*--------------------------------------------------------------------*/
+
+static int parallel (TATREE *tree)
+{                               /* --- build tree with threads */
+  TID       i, cnt;             /* loop variable, number of trans. */
+  ITEM      item, k, n;         /* item identifier and counter */
+  SUPP      w;                  /* item weight */
+  size_t    z, e;               /* node size and subtree extent */
+  TRACT     **tracts;           /* transactions to process */
+  TANODE    *root;              /* root node of the tree */
+  TANODE    **chn;              /* array of child nodes */
+  char      *mem;               /* to traverse the memory arena */
+  TATWORK   work;               /* parallel construction data */
+  TATJOB    *job;               /* to traverse the jobs */
+  pthread_t thds[TA_THREADS];   /* worker threads */
+  int       t;                  /* number of started threads */
+
+  assert(tree);                 /* check the function argument */
+  tracts = (TRACT**)tree->bag->tracts;
+  cnt    = tree->bag->cnt;      /* get the transactions */
+  for (w = 0; (cnt > 0) && ((*tracts)->size <= 0); cnt--)
+    w += (*tracts++)->wgt;      /* skip empty transactions */
+  for (n = 0, item = TA_END, i = cnt; --i >= 0; ) {
+    w += tracts[i]->wgt;        /* traverse the transactions */
+    k  = tracts[i]->items[0];   /* and count the different items */
+    if (k != item) { item = k; n++; }
+  }                             /* (top-level subtrees) */
+  if (n < 2) return 1;          /* check for enough subtrees */
+  work.jobs = (TATJOB*)malloc((size_t)n *sizeof(TATJOB));
+  if (!work.jobs) return 1;     /* create the job array */
+  root = (TANODE*)tree->mem;    /* get the root node from the arena */
+  z    = sizeof(TANODE) +(size_t)(n-1) *sizeof(ITEM);
+  mem  = tree->mem +TAT_ROUND(z +PAD(z) +(size_t)n *sizeof(TANODE*));
+  tree->used = (size_t)(mem -tree->mem);
+  root->wgt  = w;               /* note the size of the root node */
+  root->max  = 0;               /* and initialize its fields */
+  root->size = work.cnt = n;
+  chn = (TANODE**)(root->items +n);
+  ALIGN(chn);                   /* get the child pointer array */
+  for (--cnt; --n >= 0; cnt = i) { /* traverse the different items */
+    root->items[n] = item = tracts[cnt]->items[0];
+    e = (size_t)tracts[cnt]->size -1;
+    for (i = cnt; --i >= 0; ) { /* find trans. with the current item */
+      if (tracts[i]->items[0] != item) break;
+      e += (size_t)tracts[i]->size -1;
+    }                           /* and sum the remaining item counts */
+    job = work.jobs +n;         /* set up a construction job */
+    job->tracts = tracts+i+1; job->cnt = cnt-i;
+    job->beg    = mem;          /* assign a part of the arena that */
+    job->node   = chn+n;        /* is large enough for the subtree */
+    mem += TAT_ROUND(TAT_BOUND(e));  /* (subtrees are built from */
+  }                             /* disjoint ranges of transactions) */
+  if ((size_t)(mem -tree->mem) > tree->size) {
+    free(work.jobs); return 1; }/* check the size of the arena */
+  work.next = 0;                /* start with the first job */
+  pthread_mutex_init(&work.lock, NULL);
+  for (t = 0; t < TA_THREADS-1; t++)
+    if (pthread_create(thds+t, NULL, worker, &work) != 0) break;
+  worker(&work);                /* start the worker threads and */
+  while (--t >= 0)              /* also work in the calling thread */
+    pthread_join(thds[t], NULL);
+  pthread_mutex_destroy(&work.lock);
+  for (n = 0; n < work.cnt; n++) {
+    job = work.jobs +n;         /* traverse the finished jobs */
+    tree->used += (size_t)(job->end -job->beg);
+    if ((k = chn[n]->max +1) > root->max) root->max = k;
+  }                             /* sum the used memory and adapt */
+  free(work.jobs);              /* the maximal remaining size */
+  tree->root = root;            /* store the created tree */
+  return 0;                     /* return 'ok' */
+}  /* parallel() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
+static int build (TATREE *tree)
+{                               /* --- build tree in memory arena */
+  TABAG  *bag;                  /* underlying transaction bag */
+  size_t z;                     /* size of the memory arena */
+  char   *mem;                  /* to traverse the memory arena */
+
+  assert(tree);                 /* check the function argument */
+  bag = tree->bag;              /* get the transaction bag */
+  if (bag->cnt <= 0) {          /* if the transaction bag is empty, */
+    tree->root = &tree->empty;  /* set an empty root node */
+    tree->root->wgt = 0; tree->root->size = tree->root->max = 0;
+    tree->used = 0; return 0;   /* (no memory is needed) */
+  }
+  z = TAT_BOUND(tbg_extent(bag)); /* get an upper bound for memory */
+  if (z > tree->size) {         /* if the arena is too small */
+    if (tree->mem) free(tree->mem);
+    tree->mem  = (char*)malloc(z);
+    tree->size = (tree->mem) ? z : 0;
+    if (!tree->mem) { tree->root = NULL; return -1; }
+  }                             /* (re)allocate the memory arena */
+  #ifdef TA_THREADS             /* if to use multiple threads, */
+  if (parallel(tree) == 0)      /* build the top-level subtrees */
+    return 0;                   /* in parallel (if possible) */
+  #endif
+  mem = tree->mem;              /* build the tree recursively */
+  tree->root = create((TRACT**)bag->tracts, bag->cnt, 0, &mem);
+  tree->used = (size_t)(mem -tree->mem);
+  assert(tree->used <= tree->size);
+  return 0;                     /* note the used memory */
+}  /* build() */
+
 /*--------------------------------------------------------------------*/
 
 TATREE* tat_create (TABAG *bag)
@@ -2808,22 +3999,18 @@ TATREE* tat_create (TABAG *bag)
   tree = (TATREE*)malloc(sizeof(TATREE));
   if (!tree) return NULL;       /* create the transaction tree body */
   tree->bag  = bag;             /* note the underlying trans. bag */
-  if (bag->cnt <= 0) {          /* if the transaction bag is empty, */
-    tree->root = &tree->empty;  /* set an empty root node */
-    tree->root->wgt = 0; tree->root->size = tree->root->max = 0; }
-  else {                        /* if the bag contains transactions */
-    tree->root = create((TRACT**)bag->tracts, bag->cnt, 0);
-    if (!tree->root) { free(tree); return NULL; }
-  }                             /* recursively build the tree */
-  return tree;                  /* return the created trans. tree */
-}  /* tat_create() */
+  tree->mem  = NULL;            /* and clear the memory arena */
+  tree->size = tree->used = 0;
+  if (build(tree) != 0) { free(tree); return NULL; }
+  return tree;                  /* build the tree in the arena and */
+}  /* tat_create() */           /* return the created trans. tree */
 
 /*--------------------------------------------------------------------*/
 
 void tat_delete (TATREE *tree, int del)
 {                               /* --- delete a transaction tree */
   assert(tree);                 /* check the function argument */
-  delete(tree->root);           /* delete the nodes of the tree */
+  if (tree->mem) free(tree->mem);  /* delete the memory arena */
   if (tree->bag && del) tbg_delete(tree->bag, (del > 1));
   free(tree);                   /* delete the item base and */
 }  /* tat_delete() */           /* the transaction tree body */
@@ -2855,19 +4042,10 @@ size_t tat_size (const TATREE *tree)
 
 int tat_filter (TATREE *tree, ITEM min, const int *marks, int heap)
 {                               /* --- filter a transaction tree */
-  TABAG *bag;                   /* underlying transaction bag */
-
   assert(tree);                 /* check the function argument */
-  delete(tree->root);           /* delete the nodes of the tree */
-  tbg_filter(bag = tree->bag, min, marks, 0);
-  tbg_sort  (bag, 0, heap);     /* remove unnec. items and trans. */
-  tbg_reduce(bag, 0);           /* and reduce trans. to unique ones */
-  tree->root = create((TRACT**)bag->tracts, bag->cnt, 0);
-  if (tree->root) return 0;     /* recreate the transaction tree */
-  delete(tree->root);           /* on failure delete the nodes */
-  tree->root = NULL;            /* and clear the root pointer */
-  return -1;                    /* return an error indicator */
-}  /* tat_filter() */
+  tbg_ifilter(tree->bag, min, marks, 0, heap);
+  return build(tree);           /* filter the transactions and */
+}  /* tat_filter() */           /* rebuild the tree in the arena */
 
 /*--------------------------------------------------------------------*/
 #ifndef NDEBUG
@@ -2912,6 +4090,7 @@ void tat_show (TATREE *tree)
 #ifndef NDEBUG                  /* if debug version */
   #undef  CLEANUP               /* clean up memory and close files */
   #define CLEANUP \
+  if (hbag)  tbg_delete(hbag,  0); \
   if (tabag) tbg_delete(tabag, 0); \
   if (tread) trd_delete(tread, 1); \
   if (ibase) ib_delete (ibase);
@@ -2934,12 +4113,14 @@ int main (int argc, char *argv[])
   double  supp     = -1;        /* minimum support */
   int     sort     = -2;        /* flag for item sorting and recoding */
   int     pack     =  0;        /* flag for packing 16 items */
+  int     hash     =  0;        /* flag for checking hash reduction */
   long    repeat   =  1;        /* number of repetitions */
   int     mtar     =  0;        /* mode for transaction reading */
   TRACT   **tracts = NULL;      /* array of transactions */
   ITEM    m;                    /* number of items */
-  TID     n;                    /* number of transactions */
+  TID     n, x;                 /* number of transactions */
   SUPP    w;                    /* total transaction weight */
+  TRACT   *a, *b;               /* to compare the reduced bags */
   clock_t t;                    /* timer for measurements */
 
   #ifndef QUIET                 /* if not quiet version */
@@ -2963,6 +4144,7 @@ int main (int argc, char *argv[])
            "          2: ascending, -2: descending w.r.t. "
                     "transaction size sum)\n");
     printf("-p       pack the 16 items with the lowest codes\n");
+    printf("-h       check reduction with hashing (tbg_hreduce())\n");
     printf("-x#      number of repetitions (for benchmarking) "
                     "(default: 1)\n");
     printf("-w       transaction weight in last field         "
@@ -2991,6 +4173,7 @@ int main (int argc, char *argv[])
           case 's': supp   =      strtod(s, &s);    break;
           case 'q': sort   = (int)strtol(s, &s, 0); break;
           case 'p': pack   = -1;                    break;
+          case 'h': hash   =  1;                    break;
           case 'x': repeat =      strtol(s, &s, 0); break;
           case 'w': mtar  |= TA_WEIGHT;             break;
           case 'r': optarg = &recseps;              break;
@@ -3057,6 +4240,14 @@ int main (int argc, char *argv[])
   tracts = (TRACT**)malloc((size_t)n *sizeof(TRACT*));
   if (!tracts) error(E_NOMEM);  /* copy transactions to a buffer */
   memcpy(tracts, tabag->tracts, (size_t)n *sizeof(TRACT*));
+  if (hash) {                   /* if to check hash reduction */
+    hbag = tbg_create(ibase);   /* create a second transaction bag */
+    if (!hbag) error(E_NOMEM);  /* and copy the transactions */
+    for (x = 0; x < n; x++)     /* (in their original order) */
+      if (!(a = ta_clone(tracts[x])) || (tbg_add(hbag, a) != 0))
+        error(E_NOMEM);         /* pack the copies like */
+    if (pack) tbg_pack(hbag,16);/* the original transactions */
+  }
   if (pack) tbg_pack(tabag,16); /* pack 16 items with lowest codes */
   for (i = 0; i < repeat; i++){ /* repeated sorting loop */
     memcpy(tabag->tracts, tracts, (size_t)n *sizeof(TRACT*));
@@ -3068,6 +4259,24 @@ int main (int argc, char *argv[])
   if (w != (SUPP)n) MSG(stderr, "/%"SUPP_FMT, w);
   MSG(stderr, " transaction(s)] done [%.2fs].\n", SEC_SINCE(t));
 
+  /* --- check hash reduction --- */
+  if (hash) {                   /* if to check hash reduction */
+    t = clock();                /* start timer, print log message */
+    MSG(stderr, "reducing transactions with hashing ... ");
+    tbg_hreduce(hbag, 0);       /* reduce the unsorted transactions */
+    tbg_sort(hbag, +1, 0);      /* and sort the unique ones */
+    MSG(stderr, "[%"TID_FMT" transaction(s)]", tbg_cnt(hbag));
+    MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+    for (x = 0; (x < n) && (x < tbg_cnt(hbag)); x++) {
+      a = tbg_tract(tabag, x);  /* traverse the transactions */
+      b = tbg_tract(hbag,  x);  /* and compare them */
+      if ((ta_cmp(a, b, NULL) != 0) || (a->wgt != b->wgt))
+        error(E_REDUCE, x);     /* (items and weights) */
+    }                           /* both reductions must yield */
+    if (tbg_cnt(hbag) != n)     /* the same transactions */
+      error(E_REDUCE, x);       /* in the same order */
+  }
+
   /* --- clean up --- */
   CLEANUP;                      /* clean up memory and close files */
   SHOWMEM;                      /* show (final) memory usage */
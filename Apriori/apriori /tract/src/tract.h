@@ -49,6 +49,12 @@
             2013.03.25 definitions for data types TID and SUPP added
             2013.03.28 definitions for data type ITEM added
             2013.11.07 transaction reading capability made optional
+            2026.10.19 memory arena and function tat_bytes() added
+            2026.10.19 function tbg_hreduce() added (hash reduction)
+            2026.10.19 vertical index added (tbg_index(), tbg_cover())
+            2026.10.19 function tbg_surr() added (surrogate data sets)
+            2026.10.19 tbg_ipwgt() uses rarest item, parallel version
+            2026.10.19 function tbg_ifilter() added (incremental filter)
 ----------------------------------------------------------------------*/
 #ifndef __TRACT__
 #define __TRACT__
@@ -398,6 +404,10 @@
 #define TA_WGTSEP   TRD_OTHER   /* item weight separator */
 #define TA_PAREN    0x02        /* print parentheses around weight */
 
+/* --- surrogate data generation methods --- */
+#define TBG_SWAP    0           /* swap randomization */
+#define TBG_PERM    1           /* item permutation */
+
 /* --- idempotent weight modes --- */
 #define TA_NOGAPS   0x40        /* do not allow gaps in matching */
 #define TA_ALLOCC   0x80        /* consider all occurrences */
@@ -480,6 +490,8 @@ typedef struct {                /* --- transaction bag/multiset --- */
   void     **tracts;            /* array  of transactions */
   TID      *icnts;              /* number of transactions per item */
   SUPP     *ifrqs;              /* frequency of the items (weight) */
+  ITEM     xcnt;                /* number of items in vertical index */
+  TID      **tidx;              /* vertical index (trans. id lists) */
 } TABAG;                        /* (transaction bag/multiset) */
 
 #ifdef TATREEFN
@@ -511,6 +523,9 @@ typedef struct {                /* --- transaction tree --- */
   TABAG    *bag;                /* underlying transaction bag */
   TANODE   *root;               /* root of the transaction tree */
   TANODE   empty;               /* empty transaction node */
+  char     *mem;                /* memory arena for the tree nodes */
+  size_t   size;                /* size of the memory arena */
+  size_t   used;                /* used part of the memory arena */
 } TATREE;                       /* (transaction tree) */
 
 #endif
@@ -698,11 +713,24 @@ extern void         tbg_sort    (TABAG *bag, int dir, int heap);
 extern void         tbg_sortsz  (TABAG *bag, int dir, int heap);
 extern void         tbg_reverse (TABAG *bag);
 extern TID          tbg_reduce  (TABAG *bag, int keep0);
+extern TID          tbg_hreduce (TABAG *bag, int keep0);
+extern TID          tbg_ifilter (TABAG *bag, ITEM min,
+                                 const int *marks, double wgt, int heap);
 extern void         tbg_pack    (TABAG *bag, int n);
 extern void         tbg_unpack  (TABAG *bag, int dir);
 extern int          tbg_packcnt (TABAG *bag);
 extern SUPP         tbg_occur   (TABAG *bag, const ITEM *items, ITEM n);
+extern int          tbg_index   (TABAG *bag);
+extern void         tbg_noidx   (TABAG *bag);
+extern TID          tbg_cover   (TABAG *bag, const ITEM *items, ITEM n,
+                                 TID *tids);
+extern SUPP         tbg_suppx   (TABAG *bag, const ITEM *items, ITEM n);
+extern int          tbg_suppxs  (TABAG *bag, const ITEM *items,
+                                 const size_t *offs, size_t cnt,
+                                 SUPP *supps);
 extern int          tbg_ipwgt   (TABAG *bag, int mode);
+extern TABAG*       tbg_surr    (TABAG *bag, int method,
+                                 unsigned long *seed);
 
 #ifndef NDEBUG
 extern void         tbg_show    (TABAG *bag);
@@ -752,12 +780,14 @@ extern void         tat_delete  (TATREE *tree, int del);
 extern TABAG*       tat_tabag   (const TATREE *tree);
 extern TANODE*      tat_root    (const TATREE *tree);
 extern size_t       tat_size    (const TATREE *tree);
+extern size_t       tat_bytes   (const TATREE *tree);
 #else
 extern TATREE*      tat_create  (TABAG *bag);
 extern void         tat_delete  (TATREE *tree, int del);
 extern TABAG*       tat_tabag   (const TATREE *tree);
 extern TANODE*      tat_root    (const TATREE *tree);
 extern size_t       tat_size    (const TATREE *tree);
+extern size_t       tat_bytes   (const TATREE *tree);
 #endif
 extern int          tat_filter  (TATREE *tree, ITEM min,
                                  const int *marks, int heap);
@@ -819,7 +849,8 @@ extern void         tat_show    (TATREE *tree);
 #define tbg_tract(b,i)    ((TRACT*) (b)->tracts[i])
 #define tbg_wtract(b,i)   ((WTRACT*)(b)->tracts[i])
 #define tbg_errmsg(b,s,n) ib_errmsg((b)->base, s, n)
-#define tbg_reverse(b)    ptr_reverse((b)->tracts, (b)->cnt)
+#define tbg_reverse(b)    (tbg_noidx(b), \
+                           ptr_reverse((b)->tracts, (b)->cnt))
 #define tbg_packcnt(b)    ((b)->mode & TA_PACKED)
 
 /*--------------------------------------------------------------------*/
@@ -850,6 +881,7 @@ extern void         tat_show    (TATREE *tree);
 
 #define tat_tabag(t)      ((t)->bag)
 #define tat_root(t)       ((t)->root)
+#define tat_bytes(t)      ((t)->used)
 
 #endif
 #endif
@@ -7,6 +7,7 @@
 #           2011.08.29 main program fim16 added (mainly for testing)
 #           2012.07.27 module tract with write functions added (trawr)
 #           2013.04.04 added external modules and tract/train main prgs.
+#           2026.10.19 module isrbin added (binary item set files)
 #-----------------------------------------------------------------------
 THISDIR  = ..\..\tract\src
 UTILDIR  = ..\..\util\src
@@ -30,7 +31,7 @@ OBJS     = $(UTILDIR)\arrays.obj  $(UTILDIR)\memsys.obj   \
            $(UTILDIR)\tabread.obj $(UTILDIR)\tabwrite.obj \
            $(UTILDIR)\scform.obj \
            tract.obj patspec.obj clomax.obj repcm.obj
-PRGS     = fim16 tract train
+PRGS     = fim16 tract train isrbin
 
 #-----------------------------------------------------------------------
 # Build Module
@@ -47,6 +48,9 @@ train:        $(OBJS) trnmain.obj $(UTILDIR)\tabwrite.obj tract.mak
 	$(LD) $(LDFLAGS) $(OBJS) $(UTILDIR)\tabwrite.obj \
               trnmain.obj $(LIBS) /out:$@
 
+isrbin:       ibrmain.obj tract.mak
+	$(LD) $(LDFLAGS) ibrmain.obj $(LIBS) /out:$@
+
 psp:          $(UTILDIR)/tabwrite.o $(UTILDIR)/escape.o $(ADDOBJS)
 psp:          pspmain.o makefile
 	$(LD) $(LDFLAGS) $(UTILDIR)/tabwrite.o $(UTILDIR)/escape.o \
@@ -67,6 +71,10 @@ m16main.obj:  $(HDRS)
 m16main.obj:  fim16.c makefile
 	$(CC) $(CFLAGS) $(INCS) /D M16_MAIN fim16.c /Fo$@
 
+ibrmain.obj:  isrbin.h report.h tract.h
+ibrmain.obj:  isrbin.c tract.mak
+	$(CC) $(CFLAGS) $(INCS) /D IBR_MAIN isrbin.c /Fo$@
+
 pspmain.obj:  $(HDRS) $(UTILDIR)\tabwrite.h
 pspmain.obj:  patspec.c makefile
 	$(CC) $(CFLAGS) $(INCS) /D PSP_MAIN patspec.c /Fo$@
@@ -27,10 +27,17 @@
             2011.03.20 order of arguments of trd_istype() changed
             2013.03.20 record and position type changed to size_t
             2013.10.15 check of ferror() added to trd_close()
+            2026.10.19 transparent decompression with zlib added
 ----------------------------------------------------------------------*/
+#ifdef ZLIB                     /* fileno() and dup() are needed */
+#define _POSIX_C_SOURCE 200112L /* to attach zlib to an open file */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#ifdef ZLIB
+#include <unistd.h>
+#endif
 #include "tabread.h"
 #include "escape.h"
 #ifdef STORAGE
@@ -72,6 +79,9 @@ TABREAD* trd_create (void)
   if (!trd) return NULL;        /* allocate memory for a reader */
   trd->file  = NULL;            /* clear the file */
   trd->name  = NULL;            /* and   its name */
+  #ifdef ZLIB                   /* if decompression is possible */
+  trd->gz    = NULL;            /* clear the zlib stream */
+  #endif
   trd->delim = trd->last = TRD_EOF;
   trd->next  = trd->end  = trd->buf;
   trd->rec   = 1;               /* current record is the first */
@@ -103,7 +113,14 @@ int trd_delete (TABREAD *trd, int close)
 
 int trd_open (TABREAD *trd, FILE *file, const char *name)
 {                               /* --- open a new file */
+  #ifdef ZLIB                   /* if decompression is possible */
+  int fd;                       /* duplicate file descriptor */
+  #endif
+
   assert(trd);                  /* check the function arguments */
+  #ifdef ZLIB                   /* if decompression is possible */
+  trd->gz = NULL;               /* clear the zlib stream */
+  #endif                        /* (only used for named files) */
   if (file) {                   /* if a file is given directly, */
     if      (name)          trd->name = name; /* store the name */
     else if (file == stdin) trd->name = "<stdin>";
@@ -113,6 +130,14 @@ int trd_open (TABREAD *trd, FILE *file, const char *name)
   else {                        /* if a proper file name is given */
     file = fopen(trd->name = name, "rb");
     if (!file) return -2;       /* open file with given name */
+    #ifdef ZLIB                 /* if decompression is possible */
+    fd = dup(fileno(file));     /* gzclose() closes the descriptor */
+    trd->gz = (fd < 0) ? NULL : gzdopen(fd, "rb");
+    if (!trd->gz) {             /* read through a zlib stream */
+      if (fd >= 0) close(fd);   /* (zlib detects gzip compressed */
+      fclose(file); return -2;  /* data and passes other data */
+    }                           /* through unchanged) */
+    #endif
   }                             /* and check for an error */
   trd->file  = file;            /* store the new input file */
   trd->delim = trd->last = TRD_EOF;
@@ -132,6 +157,10 @@ int trd_close (TABREAD *trd)
   assert(trd);                  /* check the function arguments */
   if (!trd->file) return 0;     /* check whether there is a file */
   r = ferror(trd->file);        /* check the error indicator */
+  #ifdef ZLIB                   /* if decompression is possible */
+  if (trd->gz) r |= (gzclose(trd->gz) != Z_OK);
+  trd->gz = NULL;               /* close the zlib stream */
+  #endif
   if (trd->file != stdin) r |= fclose(trd->file);
   trd->file = NULL;             /* close the current input file */
   return r;                     /* return the result of fclose() */
@@ -174,7 +203,15 @@ int trd_getc (TABREAD *trd)
 {                               /* --- get the next character */
   assert(trd && trd->file);     /* check the function arguments */
   if (trd->next >= trd->end) {  /* if no more characters available */
-    size_t n = fread(trd->buf, sizeof(char), TRD_BUFSIZE, trd->file);
+    size_t n;                   /* number of characters read */
+    #ifdef ZLIB                 /* if decompression is possible */
+    if (trd->gz) {              /* if to read through zlib */
+      int k = gzread(trd->gz, trd->buf, TRD_BUFSIZE);
+      if (k < 0) return TRD_ERR;/* read and decompress a block */
+      n = (size_t)k; }          /* and check for a read error */
+    else
+    #endif
+    n = fread(trd->buf, sizeof(char), TRD_BUFSIZE, trd->file);
     if (n <= 0) return ferror(trd->file) ? TRD_ERR : TRD_EOF;
     trd->next = trd->buf;       /* read a new block from the file */
     trd->end  = trd->buf +n;    /* set pointer to next character */
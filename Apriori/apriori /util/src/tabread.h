@@ -21,12 +21,16 @@
             2010.10.13 name of input file added, error info. simplified
             2011.03.20 order of arguments of trd_istype() changed
             2013.03.20 record and position type changed to size_t
+            2026.10.19 transparent decompression with zlib added
 ----------------------------------------------------------------------*/
 #ifndef __TABREAD__
 #define __TABREAD__
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef ZLIB
+#include <zlib.h>
+#endif
 
 /*----------------------------------------------------------------------
   Preprocessor Definitions
@@ -61,6 +65,9 @@
 typedef struct {                /* --- table reader --- */
   FILE   *file;                 /* file to read from */
   CCHAR  *name;                 /* name of the input file */
+  #ifdef ZLIB                   /* if decompression is possible */
+  gzFile gz;                    /* zlib stream to read from */
+  #endif
   int    last;                  /* last character read */
   int    delim;                 /* last delimiter read */
   size_t len;                   /* number of characters read */
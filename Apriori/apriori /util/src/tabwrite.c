@@ -10,10 +10,17 @@
             2012.07.23 functions twr_(x)ochr() and twr_other() added
             2013.03.20 size/length types changed to size_t
             2013.10.15 check of ferror() added to twr_close()
+            2026.10.19 compressed output with zlib (file names *.gz)
 ----------------------------------------------------------------------*/
+#ifdef ZLIB                     /* fileno() and dup() are needed */
+#define _POSIX_C_SOURCE 200112L /* to attach zlib to an open file */
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#ifdef ZLIB
+#include <unistd.h>
+#endif
 #include "tabwrite.h"
 #include "escape.h"
 #ifdef STORAGE
@@ -32,6 +39,10 @@ TABWRITE* twr_create (void)
   if (!twr) return NULL;        /* allocate memory for a writer */
   twr->file      = NULL;        /* clear the file */
   twr->name      = NULL;        /* and   its name */
+  #ifdef ZLIB                   /* if compression is possible */
+  twr->gz        = NULL;        /* clear the zlib stream */
+  twr->zerr      = Z_OK;        /* and its error code */
+  #endif
   twr->recsep    = '\n';        /* and initialize the characters */
   twr->fldsep    =      twr->blank = ' ';
   twr->nvname[0] = '?'; twr->null  = '?';
@@ -55,7 +66,15 @@ int twr_delete (TABWRITE *twr, int close)
 
 int twr_open (TABWRITE *twr, FILE *file, const char *name)
 {                               /* --- open a new file */
+  #ifdef ZLIB                   /* if compression is possible */
+  size_t n;                     /* length of the file name */
+  int    fd;                    /* duplicate file descriptor */
+  #endif
+
   assert(twr);                  /* check the function arguments */
+  #ifdef ZLIB                   /* if compression is possible */
+  twr->gz = NULL;               /* clear the zlib stream */
+  #endif                        /* (only used for named files) */
   if (file) {                   /* if a file is given directly, */
     if      (name)           twr->name = name;/* store the name */
     else if (file == stdout) twr->name = "<stdout>";
@@ -68,6 +87,17 @@ int twr_open (TABWRITE *twr, FILE *file, const char *name)
   else {                        /* if a proper name is given */
     file = fopen(twr->name = name, "wb");
     if (!file) return -2;       /* open file with given name */
+    #ifdef ZLIB                 /* if compression is possible */
+    n = strlen(name);           /* if the name ends in ".gz", */
+    if ((n > 3) && (strcmp(name+n-3, ".gz") == 0)) {
+      fd = dup(fileno(file));   /* gzclose() closes the descriptor */
+      twr->gz = (fd < 0) ? NULL : gzdopen(fd, "wb");
+      if (!twr->gz) {           /* write through a zlib stream */
+        if (fd >= 0) close(fd); /* on failure close the */
+        fclose(file); return -1;/* descriptor and the file */
+      }
+    }
+    #endif
   }                             /* and check for an error */
   twr->file = file;             /* store the new output file */
   return 0;                     /* return 'ok' */
@@ -82,6 +112,10 @@ int twr_close (TABWRITE *twr)
   assert(twr);                  /* check the function argument */
   if (!twr->file) return 0;     /* check for an output file */
   r  = ferror(twr->file);       /* get the error indicator */
+  #ifdef ZLIB                   /* if compression is possible */
+  if (twr->gz) r |= (gzclose(twr->gz) != Z_OK);
+  twr->gz = NULL;               /* close the zlib stream */
+  #endif
   r |= ((twr->file == stdout) || (twr->file == stderr))
      ? fflush(twr->file) : fclose(twr->file);
   twr->file = NULL;             /* close the current output file */
@@ -134,5 +168,5 @@ void twr_pad (TABWRITE *twr, size_t n)
 {                               /* --- pad with blanks */
   assert(twr);                  /* check the function arguments */
   if (!twr->file) return;       /* check for an output file */
-  while (n-- > 0) fputc(twr->fldsep, twr->file);
+  while (n-- > 0) TWR_PUTC(twr, twr->fldsep);
 }  /* twr_pad() */
@@ -7,12 +7,16 @@
             2010.10.13 name of output file added
             2012.07.23 functions twr_(x)ochr() and twr_other() added
             2013.03.20 size and length types changed to size_t
+            2026.10.19 compressed output with zlib (file names *.gz)
 ----------------------------------------------------------------------*/
 #ifndef __TABWRITE__
 #define __TABWRITE__
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef ZLIB
+#include <zlib.h>
+#endif
 
 /*----------------------------------------------------------------------
   Preprocessor Definitions
@@ -25,6 +29,10 @@
 typedef struct {                /* --- table writer --- */
   FILE  *file;                  /* file to write to */
   CCHAR *name;                  /* name of the output file */
+  #ifdef ZLIB                   /* if compression is possible */
+  gzFile gz;                    /* zlib stream to write to */
+  int   zerr;                   /* error code of the zlib stream */
+  #endif
   int   recsep;                 /* record separator */
   int   fldsep;                 /* field  separator */
   int   blank;                  /* blanks character */
@@ -69,22 +77,41 @@ extern int       twr_nvname (TABWRITE *twr);
 ----------------------------------------------------------------------*/
 #define twr_file(t)         ((t)->file)
 #define twr_name(t)         ((t)->name)
-#define twr_flush(t)        (!(t)->file ? 0 : fflush((t)->file))
-#define twr_error(t)        (!(t)->file ? 0 : ferror((t)->file))
+#ifdef ZLIB                     /* if compression is possible */
+#define TWR_PUTC(t,c)       (((t)->gz) ? gzputc((t)->gz, c) \
+                                       : fputc(c, (t)->file))
+#define TWR_PUTS(t,s)       (((t)->gz) ? gzputs((t)->gz, s) \
+                                       : fputs(s, (t)->file))
+#define TWR_PRINTF(t,s,...) (((t)->gz) \
+                            ? gzprintf((t)->gz,   s, ##__VA_ARGS__) \
+                            : fprintf ((t)->file, s, ##__VA_ARGS__))
+#define TWR_FLUSH(t)        (((t)->gz) \
+                            ? gzflush((t)->gz, Z_SYNC_FLUSH) \
+                            : fflush((t)->file))
+#define TWR_ERROR(t)        (((t)->gz) \
+                            ? (gzerror((t)->gz, &(t)->zerr), \
+                               (t)->zerr != Z_OK) \
+                            : ferror((t)->file))
+#else                           /* if to write plain files only */
+#define TWR_PUTC(t,c)       fputc(c, (t)->file)
+#define TWR_PUTS(t,s)       fputs(s, (t)->file)
+#define TWR_PRINTF(t,s,...) fprintf((t)->file, s, ##__VA_ARGS__)
+#define TWR_FLUSH(t)        fflush((t)->file)
+#define TWR_ERROR(t)        ferror((t)->file)
+#endif
+
+#define twr_flush(t)        (!(t)->file ? 0 : TWR_FLUSH(t))
+#define twr_error(t)        (!(t)->file ? 0 : TWR_ERROR(t))
 #define twr_printf(t,s,...) (!(t)->file ? 0 : \
-                             fprintf((t)->file, s, ##__VA_ARGS__))
-#define twr_puts(t,s)       (!(t)->file ? 0 : fputs((s), (t)->file))
-#define twr_putc(t,c)       (!(t)->file ? 0 : fputc((c), (t)->file))
-#define twr_recsep(t)       (!(t)->file ? 0 : \
-                             fputc((t)->recsep,   (t)->file))
-#define twr_fldsep(t)       (!(t)->file ? 0 : \
-                             fputc((t)->fldsep,   (t)->file))
-#define twr_blank(t)        (!(t)->file ? 0 : \
-                             fputc((t)->blank,    (t)->file))
+                             TWR_PRINTF(t, s, ##__VA_ARGS__))
+#define twr_puts(t,s)       (!(t)->file ? 0 : TWR_PUTS(t, s))
+#define twr_putc(t,c)       (!(t)->file ? 0 : TWR_PUTC(t, c))
+#define twr_recsep(t)       (!(t)->file ? 0 : TWR_PUTC(t, (t)->recsep))
+#define twr_fldsep(t)       (!(t)->file ? 0 : TWR_PUTC(t, (t)->fldsep))
+#define twr_blank(t)        (!(t)->file ? 0 : TWR_PUTC(t, (t)->blank))
 #define twr_other(t,i)      (!(t)->file ? 0 : \
-                             fputc((t)->chars[i], (t)->file))
-#define twr_null(t)         (!(t)->file ? 0 : \
-                             fputc((t)->null,     (t)->file))
+                             TWR_PUTC(t, (t)->chars[i]))
+#define twr_null(t)         (!(t)->file ? 0 : TWR_PUTC(t, (t)->null))
 #define twr_nvname(t)       ((t)->nvname)
 
 #endif  /* #ifdef __TABWRITE__ */
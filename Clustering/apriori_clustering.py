@@ -1,4 +1,5 @@
 import sys, os
+import ctypes
 from itertools import chain, combinations
 from collections import defaultdict
 from optparse import OptionParser
@@ -73,12 +74,68 @@ def runApriori_bin(data_frozenset, minSup):
     #print type(items[0][0])
     return items
 
+# in-process apriori (libapriori.so, built with
+# make ADDFLAGS=-fPIC libapriori.so in apriori/src); falls back to
+# running apriori_bin if the library cannot be loaded
+try:
+    _libapr = ctypes.CDLL(os.path.join(os.path.dirname(
+                          os.path.abspath(__file__)), 'libapriori.so'))
+    _libapr.apr_create.restype  = ctypes.c_void_p
+    _libapr.apr_delete.argtypes = [ctypes.c_void_p]
+    _libapr.apr_addta.argtypes  = [ctypes.c_void_p,
+                                   ctypes.POINTER(ctypes.c_int),
+                                   ctypes.c_int, ctypes.c_int]
+    _libapr.apr_mine.argtypes   = [ctypes.c_void_p, ctypes.c_int,
+                                   ctypes.c_double, ctypes.c_int,
+                                   ctypes.c_int, ctypes.c_int,
+                                   ctypes.c_int, ctypes.c_double,
+                                   ctypes.c_void_p, ctypes.c_void_p]
+    _libapr.apr_cnt.argtypes    = [ctypes.c_void_p]
+    _libapr.apr_cnt.restype     = ctypes.c_size_t
+    _libapr.apr_size.argtypes   = [ctypes.c_void_p, ctypes.c_size_t]
+    _libapr.apr_items.argtypes  = [ctypes.c_void_p, ctypes.c_size_t]
+    _libapr.apr_items.restype   = ctypes.POINTER(ctypes.c_int)
+    _libapr.apr_supp.argtypes   = [ctypes.c_void_p, ctypes.c_size_t]
+except (OSError, AttributeError):
+    _libapr = None
+
+def runApriori_lib(data_frozenset, minSup):
+    ids = {}
+    lib = _libapr.apr_create()
+    if not lib:
+        raise MemoryError('apr_create')
+    try:
+        for i in data_frozenset:
+            t = [ids.setdefault(j, len(ids)) for j in i]
+            if _libapr.apr_addta(lib, (ctypes.c_int * len(t))(*t),
+                                 len(t), 1) < 0:
+                raise MemoryError('apr_addta')
+        # all frequent item sets (ISR_ALL), minSup in percent, size >= 1
+        # (rounded to one decimal like the -s%0.1f of runApriori_bin)
+        if _libapr.apr_mine(lib, 0, float('%0.1f' % (minSup * 100)),
+                            1, 2**31-1, 0, 0, 0.0, None, None) < 0:
+            raise MemoryError('apr_mine')
+        names = dict((v, k) for k, v in ids.items())
+        n = float(len(data_frozenset))
+        items = []
+        for i in range(_libapr.apr_cnt(lib)):
+            t = _libapr.apr_items(lib, i)
+            items.append((tuple(names[t[j]]
+                                for j in range(_libapr.apr_size(lib, i))),
+                          _libapr.apr_supp(lib, i) / n))
+    finally:
+        _libapr.apr_delete(lib)
+    return items
+
 def getFreqTransactions(data, minSup, betaVal):
     data_frozenset = []
     for i in data:
         data_frozenset.append(frozenset(i[1:]))
     #print "Starting Apriori"
-    items = runApriori_bin(data_frozenset, minSup)
+    if _libapr:
+        items = runApriori_lib(data_frozenset, minSup)
+    else:
+        items = runApriori_bin(data_frozenset, minSup)
     #print "Apriori finished"
     #print items
     #items=[i for i in items if i[1]*len(data)>=minEle]